@@ -0,0 +1,140 @@
+/**
+ * @file    Power.c
+ * @brief   Functions for the low-power idle of the main loop.
+ *
+ * This file contains the implementation of the power management. Every clock has a
+ * counter of the peripherals that need it; powerIdle() picks the low-power mode from
+ * the counters when it is called, so a peripheral that starts or stops in an interrupt
+ * takes effect at the next sleep.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+#include <msp430.h>
+
+#include "Power.h"
+
+#define ACLK_PERIODS 8 // ACLK periods counted by powerMeasureAclk()
+
+void initPower();
+void powerRequire(uint8_t clocks);
+void powerRelease(uint8_t clocks);
+void powerIdle();
+uint16_t powerMeasureAclk(uint32_t smclkHz);
+
+static volatile uint8_t smclkUsers = 0; /**< Running peripherals clocked by SMCLK */
+static volatile uint8_t aclkUsers = 0;  /**< Running peripherals clocked by ACLK */
+
+/**
+ * @brief Initializes the power management.
+ */
+void initPower()
+{
+    BCSCTL3 = (BCSCTL3 & ~LFXT1S_3) | LFXT1S_2; // ACLK from the VLO
+
+    smclkUsers = 0;
+    aclkUsers = 0;
+}
+
+/**
+ * @brief Announces that a peripheral needs clocks while it runs.
+ *
+ * @param clocks POWER_SMCLK and/or POWER_ACLK.
+ */
+void powerRequire(uint8_t clocks)
+{
+    uint16_t state = __get_interrupt_state();
+    __disable_interrupt();
+
+    if (clocks & POWER_SMCLK)
+    {
+        smclkUsers++;
+    }
+    if (clocks & POWER_ACLK)
+    {
+        aclkUsers++;
+    }
+
+    __set_interrupt_state(state);
+}
+
+/**
+ * @brief Withdraws a claim of powerRequire().
+ *
+ * @param clocks POWER_SMCLK and/or POWER_ACLK.
+ */
+void powerRelease(uint8_t clocks)
+{
+    uint16_t state = __get_interrupt_state();
+    __disable_interrupt();
+
+    if ((clocks & POWER_SMCLK) && smclkUsers > 0)
+    {
+        smclkUsers--;
+    }
+    if ((clocks & POWER_ACLK) && aclkUsers > 0)
+    {
+        aclkUsers--;
+    }
+
+    __set_interrupt_state(state);
+}
+
+/**
+ * @brief Sleeps in the deepest low-power mode the claimed clocks allow.
+ */
+void powerIdle()
+{
+    if (smclkUsers)
+    {
+        __bis_SR_register(LPM0_bits + GIE);
+    }
+    else if (aclkUsers)
+    {
+        __bis_SR_register(LPM3_bits + GIE);
+    }
+    else
+    {
+        __bis_SR_register(LPM4_bits + GIE);
+    }
+}
+
+/**
+ * @brief Measures the frequency of ACLK.
+ *
+ * @param smclkHz The frequency of SMCLK.
+ *
+ * @return The frequency of ACLK in Hz.
+ */
+uint16_t powerMeasureAclk(uint32_t smclkHz)
+{
+    uint16_t first;
+    uint16_t cycles;
+    uint8_t i;
+
+    // Capture SMCLK counts at the rising edges of ACLK (CCI0B)
+    TA0CTL = TASSEL_2 + MC_2 + TACLR;
+    TA0CCTL0 = CM_1 + CCIS_1 + CAP;
+
+    // The first edge starts the measurement at a period boundary
+    while (!(TA0CCTL0 & CCIFG));
+    first = TA0CCR0;
+    TA0CCTL0 &= ~CCIFG;
+
+    for (i = 0; i < ACLK_PERIODS; i++)
+    {
+        while (!(TA0CCTL0 & CCIFG));
+        TA0CCTL0 &= ~CCIFG;
+    }
+
+    // Fits 16 bits down to 2 kHz at 16 MHz, the difference is right across a wrap
+    cycles = TA0CCR0 - first;
+
+    TA0CCTL0 = 0;
+    TA0CTL = TACLR;
+
+    return (uint16_t)((smclkHz * ACLK_PERIODS) / cycles);
+}
@@ -0,0 +1,90 @@
+/**
+ * @file    Power.h
+ * @brief   Header file for the low-power idle of the main loop.
+ *
+ * This file contains declarations for putting the CPU to sleep while the program waits
+ * for an event. The drivers announce which clocks their peripherals need while they run;
+ * powerIdle() then enters the deepest low-power mode that keeps these clocks:
+ * - SMCLK needed (timers or PWM on SMCLK): LPM0, the CPU is off.
+ * - ACLK needed only (timers or the watchdog interval on ACLK): LPM3, the DCO is off.
+ * - Nothing needed: LPM4, only a port interrupt wakes the CPU.
+ * The ADC10 runs from its own oscillator and needs no claim. Neither does the USCI: it
+ * turns SMCLK on by itself while it receives or sends a character (automatic clock
+ * activation, family user's guide), so the UART and I2C on SMCLK work in LPM3 as well.
+ *
+ * An interrupt service routine that delivers an event calls POWER_WAKE_ON_EXIT(), so
+ * powerIdle() returns after it. Other interrupts are served and the CPU sleeps again.
+ *
+ * Typical currents of the MSP430G2553 (data sheet, 2.2 V): active at 1 MHz 230 uA,
+ * LPM0 at 1 MHz 56 uA, LPM3 with the VLO 0.5 uA, LPM4 0.1 uA.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdint.h>
+#include <msp430.h>
+
+#define POWER_SMCLK 0x01 /**< A running peripheral is clocked by SMCLK */
+#define POWER_ACLK 0x02  /**< A running peripheral is clocked by ACLK */
+
+/**
+ * @brief Lets powerIdle() return after the interrupt service routine.
+ *
+ * Only to be used inside an interrupt service routine.
+ */
+#define POWER_WAKE_ON_EXIT() __bic_SR_register_on_exit(LPM4_bits)
+
+/**
+ * @brief Initializes the power management.
+ *
+ * This function selects the VLO (about 12 kHz) as the source of ACLK, so ACLK runs
+ * without a crystal. No clock is claimed afterwards.
+ */
+extern void initPower();
+
+/**
+ * @brief Announces that a peripheral needs clocks while it runs.
+ *
+ * @param clocks POWER_SMCLK and/or POWER_ACLK.
+ *
+ * The claims are counted, every call has to be matched by powerRelease().
+ */
+extern void powerRequire(uint8_t clocks);
+
+/**
+ * @brief Withdraws a claim of powerRequire().
+ *
+ * @param clocks POWER_SMCLK and/or POWER_ACLK.
+ */
+extern void powerRelease(uint8_t clocks);
+
+/**
+ * @brief Sleeps in the deepest low-power mode the claimed clocks allow.
+ *
+ * This function returns after an interrupt service routine has called
+ * POWER_WAKE_ON_EXIT(), with interrupts enabled. To wait for an event without missing
+ * it, disable the interrupts, check for the event and only call powerIdle() if it has
+ * not happened yet; the interrupts are enabled in the same instruction that stops the
+ * CPU.
+ */
+extern void powerIdle();
+
+/**
+ * @brief Measures the frequency of ACLK.
+ *
+ * @param smclkHz The frequency of SMCLK.
+ *
+ * @return The frequency of ACLK in Hz.
+ *
+ * The VLO varies between 4 and 20 kHz from part to part, so timers on ACLK measure it
+ * once at the start. This function counts SMCLK cycles over eight ACLK periods with a
+ * capture of Timer0_A; the timer has to be free and is stopped afterwards.
+ */
+extern uint16_t powerMeasureAclk(uint32_t smclkHz);
+
+#endif /* POWER_H */
@@ -12,48 +12,71 @@
 
 
 #include <msp430.h>
+#include <stdint.h>
 #include <templateEMP.h>
+#include "Power.h"
 
 #define GRN_LED BIT0 // Green LED bitmask
 #define RED_LED BIT7 // Red LED bitmask
 
+#define SMCLK_HZ 1000000UL // SMCLK set by initMSP()
+#define ON_TIME_MS 150 // Time the green LED is on in every step pair
+#define OFF_TIME_MS 50 // Time the green LED is off in every step pair
+#define PATTERN_STEPS 8 // Steps of one period of the red LED
+
+// LEDs of every step, the even steps last ON_TIME_MS and the odd steps OFF_TIME_MS
+static const uint8_t pattern[PATTERN_STEPS] = {
+    GRN_LED, 0, GRN_LED, 0, GRN_LED | RED_LED, RED_LED, GRN_LED | RED_LED, RED_LED
+};
+
+static uint16_t onTicks; // ACLK cycles of ON_TIME_MS
+static uint16_t offTicks; // ACLK cycles of OFF_TIME_MS
+static volatile uint8_t step = 0; // Step of the pattern shown on the LEDs
+
 int main(void) {
+    uint16_t aclkHz;
+
     initMSP(); // Initialize MSP430
+    initPower(); // ACLK from the VLO
+
+    // The VLO differs from part to part, so it is measured against the calibrated DCO
+    aclkHz = powerMeasureAclk(SMCLK_HZ);
+    onTicks = (uint16_t)(((uint32_t)aclkHz * ON_TIME_MS) / 1000);
+    offTicks = (uint16_t)(((uint32_t)aclkHz * OFF_TIME_MS) / 1000);
 
     P3DIR |= (GRN_LED | RED_LED); // Set P3 pins as outputs for green and red LEDs
-    P3OUT |= (GRN_LED | RED_LED); // Set P3 pins as outputs for green and red LEDs
+    P3OUT = (P3OUT & ~(GRN_LED | RED_LED)) | pattern[0]; // Show the first step
+
+    // Timer A0 on ACLK in up mode, its interrupt moves to the next step
+    TA0CCR0 = onTicks - 1;
+    TA0CCTL0 = CCIE;
+    TA0CTL = TASSEL_1 + MC_1 + TACLR;
+    powerRequire(POWER_ACLK); // The USCI wakes SMCLK itself to receive, so the CPU sleeps in LPM3
 
     while (1) {
-        P3OUT |= GRN_LED; // Turn on the green LED
-        __delay_cycles(150000); // Delay for some time
-        P3OUT &= ~GRN_LED; // Turn off the green LED
-        __delay_cycles(50000); // Delay for some time
-        P3OUT |= GRN_LED; // Turn on the green LED again
-        __delay_cycles(150000); // Delay for some time
-        P3OUT &= ~GRN_LED; // Turn off the green LED
-        __delay_cycles(50000); // Delay for some time
-        P3OUT |= (GRN_LED | RED_LED); // Turn on both green and red LEDs
-        __delay_cycles(150000); // Delay for some time
-        P3OUT &= ~GRN_LED; // Turn off the green LED
-        __delay_cycles(50000); // Delay for some time
-        P3OUT |= GRN_LED; // Turn on the green LED again
-        __delay_cycles(150000); // Delay for some time
-        P3OUT &= ~GRN_LED; // Turn off the green LED
-        __delay_cycles(50000); // Delay for some time
-        P3OUT &= ~RED_LED; // Turn off the red LED
+        powerIdle(); // Sleep until the next step of the pattern
 
         if (serialAvailable()) {
-            if (P3OUT & GRN_LED) {
+            if (P3OUT & RED_LED) {
                 serialPrintln(" Aktueller Zustand der roten LED: AN"); // Print the state of the red LED as ON
-                serialFlush(); // Flush the serial buffer
             } else {
                 serialPrintln("Aktueller Zustand der roten LED: AUS"); // Print the state of the red LED as OFF
-                serialFlush(); // Flush the serial buffer
             }
+            serialFlush(); // Flush the serial buffer
         }
     }
 }
 
+#pragma vector = TIMER0_A0_VECTOR
+__interrupt void blinkISR(void) {
+    step = (step + 1) & (PATTERN_STEPS - 1); // Next step, PATTERN_STEPS is a power of two
+
+    P3OUT = (P3OUT & ~(GRN_LED | RED_LED)) | pattern[step];
+    TA0CCR0 = ((step & 1) ? offTicks : onTicks) - 1; // Length of the step that has just started
+
+    POWER_WAKE_ON_EXIT();
+}
+
 
 
 
@@ -94,5 +117,11 @@ int main(void) {
  By implementing a non-blocking approach with interrupts and an FSM, I can efficiently control the LEDs and monitor their status
  in real-time while allowing my microcontroller to perform other tasks concurrently.
  This is a more practical and efficient way to control LEDs in a real-world application.
+
+ **Update:**
+ The blinking now runs from Timer A0 on ACLK (VLO): the interrupt steps through a table of the LED pattern and the
+ main loop sleeps in powerIdle() between the steps. The USCI turns SMCLK on by itself to receive, so the CPU sleeps
+ in LPM3 (about 0.5 uA plus the LEDs instead of about 230 uA while busy-waiting, see tools/power_modes.c). The status
+ check runs after every step, so it reports the red LED as it is shown.
  */
 
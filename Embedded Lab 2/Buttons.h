@@ -0,0 +1,115 @@
+/**
+ * @file    Buttons.h
+ * @brief   Event-driven debouncing of push buttons.
+ *
+ * This file contains the declarations of the button module. The buttons are sampled from the
+ * watchdog timer in interval mode, debounced by an integrator per button and turned into
+ * press, release, long-press and double-click events. The events are buffered in a queue,
+ * so the application never waits for a button to settle.
+ *
+ * The watchdog interval is derived from SMCLK, BUTTON_TICK_MS assumes the 1 MHz set by initMSP().
+ * With BUTTON_TICK_ACLK set to 1 it is derived from ACLK instead, which has to run from the VLO;
+ * the buttons then keep working in LPM3. The VLO varies from part to part, so do the times.
+ * A new event ends a low-power mode of the main loop.
+ *
+ * @author  Bjoern Metzger
+ * @date    2023-11-11
+ * @version 1.0
+ */
+
+#ifndef BUTTONS_H_
+#define BUTTONS_H_
+
+#include <stdint.h>
+
+//* ----------------------------------------- Defines ---------------------------------------------*/
+
+#define BUTTON_MAX_COUNT 4            /**< Maximum number of buttons */
+#define BUTTON_EVENT_QUEUE_LENGTH 8   /**< Events buffered for the application */
+
+#ifndef BUTTON_TICK_ACLK
+#define BUTTON_TICK_ACLK 0            /**< 1 samples on ACLK instead of SMCLK */
+#endif
+
+#if BUTTON_TICK_ACLK
+#define BUTTON_TICK_MS 5              /**< Sampling period, 64 ACLK cycles at the typical 12 kHz of the VLO */
+#else
+#define BUTTON_TICK_MS 8              /**< Sampling period, 8192 SMCLK cycles at 1 MHz */
+#endif
+#define BUTTON_DEBOUNCE_MS 24         /**< Time an input must be stable to change state */
+#define BUTTON_LONG_PRESS_MS 800      /**< Press duration that raises a long-press event */
+#define BUTTON_DOUBLE_CLICK_MS 300    /**< Maximum gap between two clicks of a double-click */
+
+//* --------------------------------------- Typedefines --------------------------------------------*/
+
+/**
+ * @brief Ports the buttons can be connected to.
+ */
+typedef enum
+{
+    BUTTON_PORT_1, /**< Button on P1 */
+    BUTTON_PORT_2, /**< Button on P2 */
+    BUTTON_PORT_3  /**< Button on P3 */
+} BUTTON_PORT;
+
+/**
+ * @brief Kinds of button events.
+ */
+typedef enum
+{
+    BUTTON_EVENT_PRESSED,      /**< The button was pressed */
+    BUTTON_EVENT_RELEASED,     /**< The button was released */
+    BUTTON_EVENT_LONG_PRESS,   /**< The button has been held for BUTTON_LONG_PRESS_MS */
+    BUTTON_EVENT_DOUBLE_CLICK  /**< Second press shortly after a click, follows its pressed event */
+} BUTTON_EVENT_TYPE;
+
+/**
+ * @brief One button event.
+ */
+typedef struct
+{
+    uint8_t type;   /** Kind of event (BUTTON_EVENT_TYPE) */
+    uint8_t button; /** Number of the button returned by buttonAdd() */
+} ButtonEvent;
+
+//* -------------------------------------- Method Declarations ------------------------------------------*/
+
+/**
+ * @brief Starts the sampling of the buttons.
+ *
+ * Configures the watchdog timer as interval timer and enables its interrupt. Must be called
+ * after initMSP(), which stops the watchdog. Interrupts have to be enabled globally.
+ */
+void initButtons(void);
+
+/**
+ * @brief Adds an active-low button with internal pull-up.
+ *
+ * @param port The port of the button.
+ * @param pin The pin mask of the button, e.g. BIT5.
+ * @return The number of the button used in the events, or -1 if all slots are in use.
+ */
+int8_t buttonAdd(BUTTON_PORT port, uint8_t pin);
+
+/**
+ * @brief Takes the next event from the queue.
+ *
+ * @param event Pointer to where the event is stored.
+ * @return 1 if an event was stored, 0 if the queue is empty.
+ */
+uint8_t buttonGetEvent(ButtonEvent *event);
+
+/**
+ * @brief Discards all queued events.
+ */
+void buttonClearEvents(void);
+
+/**
+ * @brief Returns the debounced state of a button.
+ *
+ * @param button The number of the button.
+ * @return 1 if the button is pressed, 0 otherwise.
+ */
+uint8_t buttonIsPressed(uint8_t button);
+
+#endif /* BUTTONS_H_ */
@@ -21,6 +21,8 @@
 #include <msp430.h>
 #include <templateEMP.h>
 
+#include "Buttons.h"
+
 //* ----------------------------------------- Defines ---------------------------------------------*/
 
 /**
@@ -48,11 +50,6 @@
 #define true 1
 #define false 0
 
-/**
- * @brief Debounce delay in cycles.
- */
-#define DEBOUNCE_DELAY_CYCLES 20000
-
 /**
  * @brief Macros for LED and Buzzer control.
  */
@@ -94,8 +91,9 @@ void playSoundAndBlink();
 
 int main(void)
 {
-    volatile unsigned int buttonsPressed = 0;
-    volatile unsigned int buttonTwoPressed = false;
+    ButtonEvent event;
+    int8_t buttonOne;
+    int8_t buttonTwo;
 
     // Initialize MSP430 hardware
     initMSP();
@@ -103,9 +101,9 @@ int main(void)
     // Disable Watchdog Timer
     WDTCTL = WDTPW | WDTHOLD;
 
-    // Initialize input and output pins
-    initInput(BUTTON_1, false);
-    initInput(BUTTON_2, false);
+    // Initialize input and output pins, BUTTON_1 and BUTTON_2 are debounced in the background
+    buttonOne = buttonAdd(BUTTON_PORT_1, BUTTON_1);
+    buttonTwo = buttonAdd(BUTTON_PORT_1, BUTTON_2);
     initInput(BUTTON_3, true);
 
     initOutput(LED_RED);
@@ -113,67 +111,42 @@ int main(void)
     initOutput(LED_BLU);
     initOutput(BUZZER);
 
+    // Start sampling the buttons
+    initButtons();
+    __enable_interrupt();
+
     while (1)
     {
-        // Check if BUTTON_1 is pressed
-        if (!(P1IN & BUTTON_1))
-        {
-            buttonsPressed |= BUTTON_1;  // Set BUTTON_1 flag
-            __delay_cycles(DEBOUNCE_DELAY_CYCLES);
-
-            // Check if BUTTON_1 is still pressed after debounce
-            if (P1IN & BUTTON_1)
-            {
-                buttonsPressed &= ~BUTTON_1;  // Clear BUTTON_1 flag
-            }
-        }
-
-        // Check if BUTTON_2 is pressed
-        if (!(P1IN & BUTTON_2))
-        {
-            buttonsPressed |= BUTTON_2;  // Set BUTTON_2 flag
-            __delay_cycles(DEBOUNCE_DELAY_CYCLES);
-
-            // Check if BUTTON_2 is still pressed after debounce
-            if (P1IN & BUTTON_2)
-            {
-                buttonsPressed &= ~BUTTON_2;  // Clear BUTTON_2 flag
-            }
-        }
-
         // Check if both BUTTON_1 and BUTTON_2 are pressed
-        if (buttonsPressed == (BUTTON_1 | BUTTON_2))
+        if (buttonIsPressed(buttonOne) && buttonIsPressed(buttonTwo))
         {
             playSoundAndBlink(BUZZER, LED_RED);
-            buttonsPressed = 0;  // Clear button flags
+            buttonClearEvents(); // Presses during the melody belong to it
+            continue;
         }
 
-        // Check if only BUTTON_1 is pressed
-        if (buttonsPressed == BUTTON_1)
+        // The red LED follows BUTTON_1
+        if (buttonIsPressed(buttonOne))
         {
             LED_RED_ON
-            buttonsPressed = 0;  // Clear button flags
         }
-        else if (!(buttonsPressed == BUTTON_1))
+        else
         {
             LED_RED_OFF
         }
 
-        // Check if BUTTON_2 is pressed and the associated action is not performed yet
-        if ((buttonsPressed == BUTTON_2) && !buttonTwoPressed)
+        // Each press of BUTTON_2 alone flashes the green LED once
+        while (buttonGetEvent(&event))
         {
-            LED_GRN_ON
-            buttonTwoPressed = true;
+            if (event.type == BUTTON_EVENT_PRESSED && event.button == buttonTwo && !buttonIsPressed(buttonOne))
+            {
+                LED_GRN_ON
 
-            // Delay for 250,000 cycles
-            __delay_cycles(250000);
+                // Delay for 250,000 cycles
+                __delay_cycles(250000);
 
-            LED_GRN_OFF
-            buttonsPressed = 0;  // Clear button flags
-        }
-        else if (!(buttonsPressed == BUTTON_2))
-        {
-            buttonTwoPressed = false;  // Clear the action flag
+                LED_GRN_OFF
+            }
         }
     }
 }
@@ -0,0 +1,272 @@
+/**
+ * @file    Buttons.c
+ * @brief   Event-driven debouncing of push buttons.
+ *
+ * Every tick the watchdog interrupt reads each port once and moves the integrator of every
+ * button one step towards the sampled level. A button only changes state when its
+ * integrator reaches an end, i.e. after BUTTON_DEBOUNCE_MS of a stable level; single
+ * glitches are absorbed without delaying anything.
+ *
+ * @author  Bjoern Metzger
+ * @date    2023-11-11
+ * @version 1.0
+ */
+
+//* ---------------------------------------- Includes ---------------------------------------------*/
+
+#include <msp430.h>
+#include <stdint.h>
+
+#include "Buttons.h"
+
+//* ----------------------------------------- Defines ---------------------------------------------*/
+
+#define MS_TO_TICKS(ms) ((ms) / BUTTON_TICK_MS)
+
+#define INTEGRATOR_MAX MS_TO_TICKS(BUTTON_DEBOUNCE_MS)
+#define LONG_PRESS_TICKS MS_TO_TICKS(BUTTON_LONG_PRESS_MS)
+#define DOUBLE_CLICK_TICKS MS_TO_TICKS(BUTTON_DOUBLE_CLICK_MS)
+#define NO_CLICK 0xFF // No click a double-click could follow
+
+#define NUMBER_OF_PORTS 3
+
+//* --------------------------------------- Typedefines --------------------------------------------*/
+
+typedef struct
+{
+    uint8_t port;       /** Port of the button (BUTTON_PORT) */
+    uint8_t pin;        /** Pin mask of the button */
+    uint8_t integrator; /** 0 = released, INTEGRATOR_MAX = pressed */
+    uint8_t pressed;    /** Debounced state */
+    uint8_t heldTicks;  /** Ticks the button has been pressed, saturating */
+    uint8_t clickTicks; /** Ticks since the last click was released, or NO_CLICK */
+} Button;
+
+//* -------------------------------------- Variable Declarations ------------------------------------------*/
+
+static Button buttons[BUTTON_MAX_COUNT];
+static volatile uint8_t buttonCount = 0;
+
+static ButtonEvent events[BUTTON_EVENT_QUEUE_LENGTH];
+static volatile uint8_t eventHead = 0; // Next event to read
+static volatile uint8_t eventTail = 0; // Next free slot
+
+//* -------------------------------------- Method Declarations ------------------------------------------*/
+
+static void updateButton(uint8_t number, uint8_t level);
+static void pushEvent(uint8_t type, uint8_t button);
+
+//* ---------------------------------------- Definitions ------------------------------------------*/
+
+/**
+ * @brief Starts the sampling of the buttons.
+ */
+void initButtons(void)
+{
+#if BUTTON_TICK_ACLK
+    WDTCTL = WDT_ADLY_1_9; // Interval mode, ACLK / 64
+#else
+    WDTCTL = WDT_MDLY_8; // Interval mode, SMCLK / 8192
+#endif
+    IE1 |= WDTIE;        // Enable the watchdog interval interrupt
+}
+
+/**
+ * @brief Adds an active-low button with internal pull-up.
+ *
+ * @param port The port of the button.
+ * @param pin The pin mask of the button, e.g. BIT5.
+ * @return The number of the button used in the events, or -1 if all slots are in use.
+ */
+int8_t buttonAdd(BUTTON_PORT port, uint8_t pin)
+{
+    Button *button;
+
+    if (buttonCount >= BUTTON_MAX_COUNT)
+    {
+        return -1;
+    }
+
+    switch (port)
+    {
+    case BUTTON_PORT_1:
+        P1DIR &= ~pin; // Set as input
+        P1REN |= pin;  // Enable pull-resistor
+        P1OUT |= pin;  // Set to pull-up
+        break;
+    case BUTTON_PORT_2:
+        P2DIR &= ~pin;
+        P2REN |= pin;
+        P2OUT |= pin;
+        break;
+    case BUTTON_PORT_3:
+        P3DIR &= ~pin;
+        P3REN |= pin;
+        P3OUT |= pin;
+        break;
+    default:
+        return -1;
+    }
+
+    button = &buttons[buttonCount];
+    button->port = port;
+    button->pin = pin;
+    button->integrator = 0;
+    button->pressed = 0;
+    button->heldTicks = 0;
+    button->clickTicks = NO_CLICK;
+
+    // The tick only looks at the first buttonCount entries, so publish the entry last
+    return buttonCount++;
+}
+
+/**
+ * @brief Takes the next event from the queue.
+ *
+ * @param event Pointer to where the event is stored.
+ * @return 1 if an event was stored, 0 if the queue is empty.
+ */
+uint8_t buttonGetEvent(ButtonEvent *event)
+{
+    if (eventHead == eventTail)
+    {
+        return 0;
+    }
+
+    *event = events[eventHead];
+    eventHead = (eventHead + 1) % BUTTON_EVENT_QUEUE_LENGTH;
+
+    return 1;
+}
+
+/**
+ * @brief Discards all queued events.
+ */
+void buttonClearEvents(void)
+{
+    eventHead = eventTail;
+}
+
+/**
+ * @brief Returns the debounced state of a button.
+ *
+ * @param button The number of the button.
+ * @return 1 if the button is pressed, 0 otherwise.
+ */
+uint8_t buttonIsPressed(uint8_t button)
+{
+    return (button < buttonCount) && buttons[button].pressed;
+}
+
+/**
+ * @brief Debounces one button and raises its events.
+ *
+ * @param number The number of the button.
+ * @param level 1 if the pin was low (pressed) in this tick.
+ */
+static void updateButton(uint8_t number, uint8_t level)
+{
+    Button *button = &buttons[number];
+
+    // Integrate the sampled level
+    if (level && button->integrator < INTEGRATOR_MAX)
+    {
+        button->integrator++;
+    }
+    else if (!level && button->integrator > 0)
+    {
+        button->integrator--;
+    }
+
+    if (!button->pressed && button->integrator == INTEGRATOR_MAX)
+    {
+        button->pressed = 1;
+        button->heldTicks = 0;
+        pushEvent(BUTTON_EVENT_PRESSED, number);
+
+        if (button->clickTicks < DOUBLE_CLICK_TICKS)
+        {
+            pushEvent(BUTTON_EVENT_DOUBLE_CLICK, number);
+            button->clickTicks = NO_CLICK; // A third click starts a new pair
+        }
+        else
+        {
+            button->clickTicks = 0;
+        }
+    }
+    else if (button->pressed && button->integrator == 0)
+    {
+        button->pressed = 0;
+        pushEvent(BUTTON_EVENT_RELEASED, number);
+
+        // Only a short press counts as the first click of a double-click
+        if (button->heldTicks >= LONG_PRESS_TICKS)
+        {
+            button->clickTicks = NO_CLICK;
+        }
+        else if (button->clickTicks != NO_CLICK)
+        {
+            button->clickTicks = 0;
+        }
+    }
+    else if (button->pressed)
+    {
+        if (button->heldTicks < LONG_PRESS_TICKS && ++button->heldTicks == LONG_PRESS_TICKS)
+        {
+            pushEvent(BUTTON_EVENT_LONG_PRESS, number);
+        }
+    }
+    else if (button->clickTicks < NO_CLICK - 1)
+    {
+        button->clickTicks++;
+    }
+}
+
+/**
+ * @brief Appends an event to the queue; it is dropped if the queue is full.
+ *
+ * @param type The kind of event (BUTTON_EVENT_TYPE).
+ * @param button The number of the button.
+ */
+static void pushEvent(uint8_t type, uint8_t button)
+{
+    uint8_t next = (eventTail + 1) % BUTTON_EVENT_QUEUE_LENGTH;
+
+    if (next == eventHead)
+    {
+        return;
+    }
+
+    events[eventTail].type = type;
+    events[eventTail].button = button;
+    eventTail = next;
+}
+
+//* ----------------------------------------- Interrupts -------------------------------------------*/
+
+/**
+ * @brief Watchdog interval interrupt, samples all buttons once per tick.
+ */
+#pragma vector = WDT_VECTOR
+__interrupt void buttonTickISR(void)
+{
+    uint8_t ports[NUMBER_OF_PORTS];
+    uint8_t tail = eventTail;
+    uint8_t i;
+
+    // Read every port once, so buttons on the same port are sampled at the same time
+    ports[BUTTON_PORT_1] = P1IN;
+    ports[BUTTON_PORT_2] = P2IN;
+    ports[BUTTON_PORT_3] = P3IN;
+
+    for (i = 0; i < buttonCount; i++)
+    {
+        updateButton(i, !(ports[buttons[i].port] & buttons[i].pin));
+    }
+
+    // Let a sleeping main loop take the new events
+    if (eventTail != tail)
+    {
+        __bic_SR_register_on_exit(LPM4_bits);
+    }
+}
@@ -30,6 +30,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+// Project includes
+#include "Buttons.h"
+#include "Power.h"
+
 //* ----------------------------------------- Defines ---------------------------------------------*/
 
 #define LED_RED (BIT0)
@@ -45,7 +49,10 @@
 
 #define SEQUENCE_COUNT ((uint8_t)5)
 #define NUMBER_OF_LEDS ((uint8_t)3)
-#define DEBOUNCE_DELAY_CYCLES ((uint16_t)20000)
+
+#define TIMER_TICK_MS ((uint16_t)10)             // Period of the animation timer
+#define START_ANIMATION_MS ((uint16_t)2000)      // All LEDs on at the start of a game
+#define SMCLK_HZ ((uint32_t)1000000)             // Set by initMSP()
 
 //* --------------------------------------- Typedefines --------------------------------------------*/
 
@@ -81,6 +88,10 @@ uint8_t u8_LedOrderUserInput[NUMBER_OF_LEDS];
 uint8_t u8_CurrentSequenceIndex = ((uint8_t)0);
 uint8_t u8_CurrentExecutionState = stateNull;
 
+// Buttons in the order of the LEDs they select
+int8_t s8_Buttons[NUMBER_OF_LEDS];
+const uint8_t u8_ButtonLeds[NUMBER_OF_LEDS] = {LED_RED, LED_GRN, LED_BLU};
+
 // Timer-related variables
 volatile uint16_t u16_TimerCount = ((uint16_t)0);
 volatile uint8_t u16_LedIndex = ((uint16_t)0);
@@ -106,12 +117,13 @@ void collectUserInput(uint8_t *p_LedOrderUserInput);
 
 // Helper methods
 bool compareArrays(uint8_t *p_Array1, uint8_t *p_Array2);
-bool debounceInput(uint8_t u8_Port, uint8_t u8_Pin);
+bool getButtonPress(uint8_t *p_Button);
 
 //* ---------------------------------------- Definitions ------------------------------------------*/
 int main(void)
 {
     bool b_Result = false;
+    uint8_t u8_Button = ((uint8_t)0);
 
     initialize();
 
@@ -120,11 +132,17 @@ int main(void)
         switch (u8_CurrentExecutionState)
         {
         case stateNull: // Play starting animation
-            if (debounceInput(PORT_ONE, BUTTON_ONE) || debounceInput(PORT_ONE, BUTTON_TWO) || debounceInput(PORT_ONE, BUTTON_THREE))
+            __disable_interrupt(); // A press between the check and the sleep must wake the CPU
+            if (getButtonPress(&u8_Button))
             {
+                __enable_interrupt();
                 playStartAnimation();
                 u8_CurrentExecutionState = stateOne; // Move to the next execution state
             }
+            else
+            {
+                powerIdle(); // Sleep until the next button event
+            }
             break;
 
         case stateOne: // Play LED sequence for the user
@@ -147,6 +165,7 @@ int main(void)
                 playStartAnimation();
                 u8_CurrentSequenceIndex = ((uint8_t)0);
                 u8_CurrentExecutionState = stateNull;
+                buttonClearEvents(); // Only a new press starts the next game
             }
             else if (b_Result) // User input identical to displayed sequence
             {
@@ -159,6 +178,7 @@ int main(void)
                 playRoundLostAnimation();
                 u8_CurrentSequenceIndex = ((uint8_t)0); // Reset the current sequence index
                 u8_CurrentExecutionState = stateNull;
+                buttonClearEvents(); // Only a new press starts the next game
             }
             break;
 
@@ -173,27 +193,39 @@ int main(void)
  *
  * This function performs the necessary initialization steps to set up the system.
  * It initializes the MSP, disables interrupts, stops the watchdog timer, configures
- * LED pins, sets button pins as input with pull-up resistors, and configures Timer A.
+ * LED pins, sets button pins as input with pull-up resistors, starts the button sampling
+ * and configures Timer A.
+ *
+ * The timer and the button sampling run from ACLK (the VLO), so the CPU sleeps in LPM3
+ * whenever the game waits. The VLO is measured once to set the timer period.
  */
 void initialize()
 {
+    uint16_t u16_AclkHz = ((uint16_t)0);
+
     initMSP(); // Initialize the MSP
 
     __disable_interrupt(); // Disable interrupts globally
 
+    initPower();                              // ACLK from the VLO
+    u16_AclkHz = powerMeasureAclk(SMCLK_HZ); // The VLO varies from part to part
+
     WDTCTL = WDTPW + WDTHOLD; // Stop the watchdog timer
 
     P3DIR |= (LED_RED + LED_GRN + LED_BLU);  // Set LED pins as output
     P3OUT &= ~(LED_RED + LED_GRN + LED_BLU); // Turn off all LEDs initially
 
-    P1DIR &= ~(BUTTON_ONE + BUTTON_TWO + BUTTON_THREE); // Set button pins as input
-    P1REN |= (BUTTON_ONE + BUTTON_TWO + BUTTON_THREE);  // Enable pull-up resistor for buttons
-    P1OUT |= (BUTTON_ONE + BUTTON_TWO + BUTTON_THREE);  // Set pull-up resistor for buttons
+    // Set button pins as input with pull-up resistor, they are debounced in the background
+    s8_Buttons[0] = buttonAdd(BUTTON_PORT_1, BUTTON_ONE);
+    s8_Buttons[1] = buttonAdd(BUTTON_PORT_1, BUTTON_TWO);
+    s8_Buttons[2] = buttonAdd(BUTTON_PORT_1, BUTTON_THREE);
+    initButtons();
+    powerRequire(POWER_ACLK); // The buttons are sampled all the time
 
     // Configure Timer A
-    TA0CTL = TASSEL_2 + MC_0 + TACLR; // Use the SMCLK as the clock source, disable timer for now, clear timer
-    TA0CCR0 = ((uint8_t)1000);          // Set CCR0 to produce 100 ms per count
-    TA0CCTL0 &= ~CCIE;                // Enable the interrupt for CCR0
+    TA0CTL = TASSEL_1 + MC_0 + TACLR;                             // Use the ACLK as the clock source, disable timer for now, clear timer
+    TA0CCR0 = u16_AclkHz / (((uint16_t)1000) / TIMER_TICK_MS) - 1; // Set CCR0 to produce TIMER_TICK_MS per count
+    TA0CCTL0 &= ~CCIE;                                            // Disable the interrupt for CCR0 for now
 
     __enable_interrupt(); // Enable global interrupts
 }
@@ -202,12 +234,19 @@ void initialize()
  * @brief Plays the start animation.
  *
  * This function turns on all LEDs, introduces a delay of 2 seconds, and then turns off all LEDs.
- * The delay is achieved using the __delay_cycles function.
+ * The delay is timed by Timer A, the CPU sleeps in between.
  */
 void playStartAnimation()
 {
     PORT_THREE |= (LED_RED + LED_GRN + LED_BLU);  // Turn on all LEDs
-    __delay_cycles((uint32_t)2000000);            // Delay for 2 seconds
+
+    startTimer();
+    while (u16_TimerCount < START_ANIMATION_MS) // Delay for 2 seconds
+    {
+        powerIdle();
+    }
+    stopTimer();
+
     PORT_THREE &= ~(LED_RED + LED_GRN + LED_BLU); // Turn off all LEDs
 }
 
@@ -251,6 +290,8 @@ void playCurrentSequenceAnimation(ledSequence *p_CurrentSequence)
             {
                 // Errors do nothing for now
             }
+
+            powerIdle(); // Sleep until the next timer tick
         }
     }
 
@@ -294,6 +335,8 @@ void playRoundWonAnimation()
             {
                 // Errors do nothing for now
             }
+
+            powerIdle(); // Sleep until the next timer tick
         }
     }
     PORT_THREE &= ~(LED_RED + LED_GRN + LED_BLU); // Turn off all LEDs
@@ -345,6 +388,8 @@ void playRoundLostAnimation()
             {
                 // Errors do nothing for now
             }
+
+            powerIdle(); // Sleep until the next timer tick
         }
     }
     PORT_THREE &= ~(LED_RED + LED_GRN + LED_BLU); // Turn off all LEDs
@@ -396,6 +441,8 @@ void playGameWonAnimation()
             {
                 // Errors do nothing for now
             }
+
+            powerIdle(); // Sleep until the next timer tick
         }
     }
 
@@ -408,11 +455,16 @@ void playGameWonAnimation()
  *
  * This function configures Timer A0 in up mode and enables the interrupt vectors for CCR0.
  * It allows the timer to start counting and trigger interrupts at the specified interval.
+ * The animation time starts at 0.
  */
 void startTimer()
 {
-    TA0CTL |= MC_1; // Set timer to up mode
-    CCTL0 |= CCIE;  // Enable interrupt vectors for CCR0
+    u16_TimerCount = ((uint16_t)0);
+    powerRequire(POWER_ACLK);
+
+    TA0CTL |= TACLR; // Start a full period
+    TA0CTL |= MC_1;  // Set timer to up mode
+    CCTL0 |= CCIE;   // Enable interrupt vectors for CCR0
 }
 
 /**
@@ -423,55 +475,44 @@ void startTimer()
  */
 void stopTimer()
 {
-    TA0CTL |= MC_0; // Set timer to off state
-    CCTL0 &= ~CCIE; // Disable interrupt vectors for CCR0
+    TA0CTL &= ~MC_3; // Set timer to off state, MC_0 is no bit that could be set
+    CCTL0 &= ~CCIE;  // Disable interrupt vectors for CCR0
+
+    powerRelease(POWER_ACLK);
 }
 
 /**
- * @brief Collects user input by polling buttons one to three with debouncing.
+ * @brief Collects user input from the button events.
  *
- * This function polls buttons one to three until all of them have been pressed.
+ * This function waits until buttons one to three have been pressed three times in total.
  * The order in which the buttons have been pressed is stored in the array ledOrderUserInput.
- * Debouncing is applied to the button inputs using the debounceInput function.
+ * Presses made while the sequence was shown are discarded. Debouncing is done in the
+ * background, every press is reported exactly once, so there is no need to wait for the release.
  *
  * @param p_LedOrderUserInput Pointer to the array where the user input will be stored.
  */
 void collectUserInput(uint8_t *p_LedOrderUserInput)
 {
     uint8_t u8_CurrentIndex = ((uint8_t)0);
+    uint8_t u8_Button = ((uint8_t)0);
 
-    // Continue polling buttons until all three buttons are pressed
+    buttonClearEvents();
+
+    // Continue until three buttons are pressed
     while (u8_CurrentIndex < NUMBER_OF_LEDS)
     {
-        if (debounceInput(PORT_ONE, BUTTON_ONE))
+        __disable_interrupt(); // A press between the check and the sleep must wake the CPU
+        if (getButtonPress(&u8_Button))
         {
-            // Button one is pressed, store it in the array
-            p_LedOrderUserInput[u8_CurrentIndex] = LED_RED;
+            __enable_interrupt();
+
+            // Store the LED of the pressed button in the array
+            p_LedOrderUserInput[u8_CurrentIndex] = u8_ButtonLeds[u8_Button];
             u8_CurrentIndex++;
-            while (debounceInput(PORT_ONE, BUTTON_ONE))
-            {
-                // Wait for button release to avoid multiple presses being registered
-            }
         }
-        else if (debounceInput(PORT_ONE, BUTTON_TWO))
+        else
         {
-            // Button two is pressed, store it in the array
-            p_LedOrderUserInput[u8_CurrentIndex] = LED_GRN;
-            u8_CurrentIndex++;
-            while (debounceInput(PORT_ONE, BUTTON_TWO))
-            {
-                // Wait for button release to avoid multiple presses being registered
-            }
-        }
-        else if (debounceInput(PORT_ONE, BUTTON_THREE))
-        {
-            // Button three is pressed, store it in the array
-            p_LedOrderUserInput[u8_CurrentIndex] = LED_BLU;
-            u8_CurrentIndex++;
-            while (debounceInput(PORT_ONE, BUTTON_THREE))
-            {
-                // Wait for button release to avoid multiple presses being registered
-            }
+            powerIdle(); // Sleep until the next button event
         }
     }
 }
@@ -503,32 +544,37 @@ bool compareArrays(uint8_t *p_Array1, uint8_t *p_Array2)
 }
 
 /**
- * @brief Debounces a button input using a time delay.
+ * @brief Takes the next button press from the event queue.
  *
- * This function debounces a button input by checking its state over time.
- * It uses a time delay to filter out spurious signals and provide a stable button state.
+ * This function checks the event queue of the button module for a press of buttons one to three.
+ * It does not block; other events (release, long press, ...) are dropped.
  *
- * @param u8_Port Port register of the button pin.
- * @param u8_Pin Pin number of the button.
- * @return 1 if the button is pressed after debouncing, 0 otherwise.
+ * @param p_Button Pointer to where the index of the pressed button (0 to 2) is stored.
+ * @return true if a button has been pressed, false otherwise.
  */
-bool debounceInput(uint8_t u8_Port, uint8_t u8_Pin)
+bool getButtonPress(uint8_t *p_Button)
 {
-    bool b_ButtonState = false; // Default to not pressed
+    ButtonEvent event;
+    uint8_t u8_ButtonIndex = ((uint8_t)0);
 
-    if (!(u8_Port & u8_Pin))
+    while (buttonGetEvent(&event))
     {
-        b_ButtonState = true; // Set state to pressed
-
-        __delay_cycles(DEBOUNCE_DELAY_CYCLES); // Wait for a time gap to debounce the button input signal
+        if (event.type != BUTTON_EVENT_PRESSED)
+        {
+            continue;
+        }
 
-        if (u8_Port & u8_Pin)
+        for (u8_ButtonIndex = ((uint8_t)0); u8_ButtonIndex < NUMBER_OF_LEDS; u8_ButtonIndex++)
         {
-            b_ButtonState = false; // It turned out the signal was a fluke; reset the state
+            if (s8_Buttons[u8_ButtonIndex] == event.button)
+            {
+                *p_Button = u8_ButtonIndex;
+                return true;
+            }
         }
     }
 
-    return b_ButtonState;
+    return false;
 }
 
 //* ----------------------------------------- Interrupts -------------------------------------------*/
@@ -538,8 +584,10 @@ bool debounceInput(uint8_t u8_Port, uint8_t u8_Pin)
 __interrupt void Timer_A(void)
 {
     CCTL0 &= ~CCIE; // Disable interrupt vectors for CCR0
-    u16_TimerCount++;
+    u16_TimerCount += TIMER_TICK_MS;
     CCTL0 |= CCIE; // Enable interrupt vectors for CCR0
 
     TACTL &= ~TAIFG; // clear interrupt Flag
+
+    POWER_WAKE_ON_EXIT(); // The animation continues in the main loop
 }
@@ -0,0 +1,115 @@
+/**
+ * @file    AdcFilter.h
+ * @brief   Header file for AdcFilter.c
+ *
+ * This file contains declarations of the integer filters used to smooth ADC10 readings:
+ * a moving average, an exponential smoothing filter with a shift-based alpha and an
+ * oversample-and-decimate stage that gains extra effective bits from the 10-bit converter.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ */
+
+#ifndef ADCFILTER_H_
+#define ADCFILTER_H_
+
+#include <stdint.h>
+
+#define MOVING_AVERAGE_LENGTH 8    /** Window length of the moving average, must be a power of two */
+#define MOVING_AVERAGE_SHIFT 3     /** log2(MOVING_AVERAGE_LENGTH) */
+#define EXP_FILTER_MAX_SHIFT 6     /** Largest alpha shift, keeps (1023 << shift) inside 16 bits */
+#define DECIMATOR_MAX_EXTRA_BITS 2 /** Largest resolution gain, 4^2 * 1023 still fits 16 bits */
+
+// Moving average over the last MOVING_AVERAGE_LENGTH samples
+typedef struct
+{
+    uint16_t samples[MOVING_AVERAGE_LENGTH]; /** Ring of the most recent samples */
+    uint16_t sum;                            /** Running sum of the ring */
+    uint8_t index;                           /** Position of the oldest sample */
+} MovingAverageFilter;
+
+// Exponential smoothing y += (x - y) / 2^shift, state kept scaled by 2^shift
+typedef struct
+{
+    uint16_t state; /** Filter output scaled by 2^shift */
+    uint8_t shift;  /** Alpha = 1 / 2^shift */
+} ExponentialFilter;
+
+// Oversample-and-decimate accumulator yielding (10 + extraBits)-bit results
+typedef struct
+{
+    uint16_t accumulator; /** Sum of the samples collected so far */
+    uint16_t result;      /** Last completed decimated value */
+    uint8_t count;        /** Number of samples collected so far */
+    uint8_t extraBits;    /** Additional bits of resolution (0 to DECIMATOR_MAX_EXTRA_BITS) */
+} Decimator;
+
+/**
+ * @brief Initializes a moving average filter.
+ *
+ * The window is pre-filled with the given value so the first outputs do not ramp up from zero.
+ *
+ * @param filter Pointer to the filter to initialize.
+ * @param initialValue Value the window is filled with.
+ */
+void movingAverageInit(MovingAverageFilter *filter, uint16_t initialValue);
+
+/**
+ * @brief Adds a sample to a moving average filter.
+ *
+ * @param filter Pointer to the filter.
+ * @param sample The new 10-bit ADC sample.
+ * @return The average over the last MOVING_AVERAGE_LENGTH samples.
+ */
+uint16_t movingAverageUpdate(MovingAverageFilter *filter, uint16_t sample);
+
+/**
+ * @brief Initializes an exponential smoothing filter.
+ *
+ * @param filter Pointer to the filter to initialize.
+ * @param shift Alpha as a power of two (alpha = 1 / 2^shift), clamped to EXP_FILTER_MAX_SHIFT.
+ * @param initialValue Initial output of the filter.
+ */
+void expFilterInit(ExponentialFilter *filter, uint8_t shift, uint16_t initialValue);
+
+/**
+ * @brief Adds a sample to an exponential smoothing filter.
+ *
+ * @param filter Pointer to the filter.
+ * @param sample The new 10-bit ADC sample.
+ * @return The smoothed value.
+ */
+uint16_t expFilterUpdate(ExponentialFilter *filter, uint16_t sample);
+
+/**
+ * @brief Initializes an oversample-and-decimate stage.
+ *
+ * @param decimator Pointer to the decimator to initialize.
+ * @param extraBits Bits of resolution to gain, clamped to DECIMATOR_MAX_EXTRA_BITS.
+ *                  4^extraBits samples are needed per result.
+ */
+void decimatorInit(Decimator *decimator, uint8_t extraBits);
+
+/**
+ * @brief Adds a sample to an oversample-and-decimate stage.
+ *
+ * @param decimator Pointer to the decimator.
+ * @param sample The new 10-bit ADC sample.
+ * @return 1 if a new result is available in decimator->result, 0 otherwise.
+ */
+uint8_t decimatorUpdate(Decimator *decimator, uint16_t sample);
+
+/**
+ * @brief Oversamples and decimates a block of DTC frames in one go.
+ *
+ * The DTC stores one frame of ADC_CHANNELS values per sequence, so consecutive samples of
+ * one channel are `stride` words apart.
+ *
+ * @param samples Pointer to the first sample of the channel in the DTC buffer.
+ * @param stride Distance in words between two samples of the same channel.
+ * @param extraBits Bits of resolution to gain; the buffer must hold 4^extraBits frames.
+ * @return The (10 + extraBits)-bit decimated value.
+ */
+uint16_t decimateFrames(const uint16_t *samples, uint8_t stride, uint8_t extraBits);
+
+#endif /* ADCFILTER_H_ */
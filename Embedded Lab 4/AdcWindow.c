@@ -0,0 +1,239 @@
+/**
+ * @file    AdcWindow.c
+ * @brief   Window comparator for the ADC channels.
+ *
+ * This file contains the implementation of the ADC window comparator. It is registered as
+ * the ADC frame callback, so every frame the DTC completes is checked in the ADC interrupt.
+ * The main loop only has to look at the event flags and can skip all work while no channel
+ * changes its band.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+#include <msp430.h>
+
+#include "Hardware.h"
+#include "AdcFilter.h"
+#include "AdcWindow.h"
+
+// State of one registered window
+typedef struct
+{
+    const uint16_t *thresholds; /** Ascending band limits, or 0 for a fixed step */
+    AdcWindowCallback callback; /** Function called on a band change */
+    ExponentialFilter filter;   /** Smoothing applied before the comparison */
+    uint16_t step;              /** Band width of a fixed-step window */
+    uint16_t value;             /** Latest smoothed value */
+    uint8_t channel;            /** Watched ADC channel */
+    uint8_t count;              /** Number of thresholds */
+    uint8_t hysteresis;         /** Hysteresis around every band limit */
+    uint8_t band;               /** Current band */
+} AdcWindow;
+
+static AdcWindow windows[ADC_WINDOW_MAX];  /**< Registered windows */
+static uint8_t windowCount = 0;            /**< Number of registered windows */
+static volatile uint8_t pendingEvents = 0; /**< One bit per window with a band change */
+
+/**
+ * @brief Checks whether a band has an upper limit.
+ *
+ * @param window Pointer to the window.
+ * @param band The band to check.
+ * @return 1 if values above the band exist, 0 for the topmost band of a threshold table.
+ */
+static uint8_t hasUpperLimit(const AdcWindow *window, uint8_t band)
+{
+    return (window->thresholds == 0) || (band < window->count);
+}
+
+/**
+ * @brief Returns the largest value that still belongs to a band.
+ *
+ * @param window Pointer to the window.
+ * @param band The band.
+ * @return The upper limit of the band.
+ */
+static uint16_t upperLimit(const AdcWindow *window, uint8_t band)
+{
+    if (window->thresholds == 0)
+    {
+        return (band + 1) * window->step - 1;
+    }
+    return window->thresholds[band];
+}
+
+/**
+ * @brief Moves a band up or down until it contains the value.
+ *
+ * @param window Pointer to the window.
+ * @param value The new channel value.
+ * @param band The band to start from.
+ * @param hysteresis Distance the value has to pass a band limit.
+ * @return The band the value belongs to.
+ */
+static uint8_t findBand(const AdcWindow *window, uint16_t value, uint8_t band, uint8_t hysteresis)
+{
+    while (hasUpperLimit(window, band) && value > upperLimit(window, band) + hysteresis)
+    {
+        band++;
+    }
+    while (band > 0 && value + hysteresis <= upperLimit(window, band - 1))
+    {
+        band--;
+    }
+    return band;
+}
+
+/**
+ * @brief Checks all windows against a completed frame; runs in the ADC interrupt.
+ *
+ * @param frame The frame the DTC has just completed.
+ */
+static void checkWindows(const uint16_t *frame)
+{
+    AdcWindow *window;
+    uint16_t value;
+    uint8_t band;
+    uint8_t i;
+
+    for (i = 0; i < windowCount; i++)
+    {
+        window = &windows[i];
+
+        if (window->band == ADC_WINDOW_BAND_UNKNOWN)
+        {
+            // Start the filter at the first value instead of ramping up from zero
+            expFilterInit(&window->filter, window->filter.shift, frame[window->channel]);
+            value = frame[window->channel];
+            band = findBand(window, value, 0, 0);
+        }
+        else
+        {
+            value = expFilterUpdate(&window->filter, frame[window->channel]);
+            band = findBand(window, value, window->band, window->hysteresis);
+        }
+
+        window->value = value;
+
+        if (band != window->band)
+        {
+            window->band = band;
+            pendingEvents |= 1 << i;
+
+            if (window->callback)
+            {
+                window->callback(i, band);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Adds a window to the list.
+ *
+ * @return The window handle, or ADC_WINDOW_INVALID if all windows are in use.
+ */
+static uint8_t addWindow(uint8_t channel, const uint16_t *thresholds, uint8_t count, uint16_t step,
+                         uint8_t hysteresis, uint8_t filterShift, AdcWindowCallback callback)
+{
+    AdcWindow *window;
+
+    if (windowCount >= ADC_WINDOW_MAX)
+    {
+        return ADC_WINDOW_INVALID;
+    }
+
+    window = &windows[windowCount];
+    window->thresholds = thresholds;
+    window->count = count;
+    window->step = step;
+    window->channel = channel;
+    window->hysteresis = hysteresis;
+    window->callback = callback;
+    window->value = 0;
+    expFilterInit(&window->filter, filterShift, 0);
+    window->band = ADC_WINDOW_BAND_UNKNOWN;
+
+    // Publish the window only after it is complete, the ADC interrupt may already run
+    return windowCount++;
+}
+
+/**
+ * @brief Initializes the window comparator.
+ */
+void initAdcWindow(void)
+{
+    windowCount = 0;
+    pendingEvents = 0;
+    setAdcFrameCallback(checkWindows);
+}
+
+/**
+ * @brief Registers a window with a table of thresholds.
+ *
+ * @return The window handle, or ADC_WINDOW_INVALID if all windows are in use.
+ */
+uint8_t adcWindowRegister(uint8_t channel, const uint16_t *thresholds, uint8_t count, uint8_t hysteresis,
+                          uint8_t filterShift, AdcWindowCallback callback)
+{
+    return addWindow(channel, thresholds, count, 0, hysteresis, filterShift, callback);
+}
+
+/**
+ * @brief Registers a window with bands of equal width.
+ *
+ * @return The window handle, or ADC_WINDOW_INVALID if all windows are in use.
+ */
+uint8_t adcWindowRegisterStep(uint8_t channel, uint16_t step, uint8_t hysteresis, uint8_t filterShift,
+                              AdcWindowCallback callback)
+{
+    if (step == 0)
+    {
+        return ADC_WINDOW_INVALID;
+    }
+    return addWindow(channel, 0, 0, step, hysteresis, filterShift, callback);
+}
+
+/**
+ * @brief Returns and clears the pending band change events.
+ *
+ * @return Bit mask with bit n set if window n changed its band since the last call.
+ */
+uint8_t adcWindowGetEvents(void)
+{
+    uint8_t events;
+    uint16_t interruptState;
+
+    interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    events = pendingEvents;
+    pendingEvents = 0;
+    __set_interrupt_state(interruptState);
+
+    return events;
+}
+
+/**
+ * @brief Returns the current band of a window.
+ *
+ * @param window The window handle.
+ * @return The band, or ADC_WINDOW_BAND_UNKNOWN before the first frame.
+ */
+uint8_t adcWindowGetBand(uint8_t window)
+{
+    return windows[window].band;
+}
+
+/**
+ * @brief Returns the latest (smoothed) channel value of a window.
+ *
+ * @param window The window handle.
+ * @return The value the band was last evaluated for.
+ */
+uint16_t adcWindowGetValue(uint8_t window)
+{
+    return windows[window].value;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file    AdcWindow.h
+ * @brief   Header file for AdcWindow.c
+ *
+ * This file contains declarations of the ADC window comparator. A window watches one ADC
+ * channel and splits its range into bands, either at a table of thresholds or at a fixed
+ * step. Every completed DTC frame is checked in the ADC interrupt and an event is raised
+ * only when the channel moves into another band. A hysteresis around each threshold keeps
+ * a noisy value from toggling between two bands, and each window can smooth its channel
+ * with an exponential filter before the comparison.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ */
+
+#ifndef ADCWINDOW_H_
+#define ADCWINDOW_H_
+
+#include <stdint.h>
+
+#define ADC_WINDOW_MAX 4                /** Maximum number of registered windows */
+#define ADC_WINDOW_INVALID 0xFF         /** Returned when no window could be registered */
+#define ADC_WINDOW_BAND_UNKNOWN 0xFF    /** Band of a window before its first frame */
+
+// Function called from the ADC interrupt when a window changes its band
+typedef void (*AdcWindowCallback)(uint8_t window, uint8_t band);
+
+/**
+ * @brief Initializes the window comparator.
+ *
+ * Removes all windows and registers the comparator as the ADC frame callback.
+ */
+void initAdcWindow(void);
+
+/**
+ * @brief Registers a window with a table of thresholds.
+ *
+ * A value above thresholds[i] lies in band i + 1 or higher, so `count` thresholds split
+ * the channel into count + 1 bands. A simple low/high window uses two thresholds.
+ *
+ * @param channel The ADC channel (ADC_Channel) to watch.
+ * @param thresholds Pointer to `count` ascending thresholds; must stay valid.
+ * @param count Number of thresholds.
+ * @param hysteresis Distance a value has to pass a threshold before the band changes.
+ * @param filterShift Exponential smoothing alpha (1 / 2^filterShift), 0 compares raw values.
+ * @param callback Function called on a band change, or 0 to use the event flags only.
+ * @return The window handle, or ADC_WINDOW_INVALID if all windows are in use.
+ */
+uint8_t adcWindowRegister(uint8_t channel, const uint16_t *thresholds, uint8_t count, uint8_t hysteresis,
+                          uint8_t filterShift, AdcWindowCallback callback);
+
+/**
+ * @brief Registers a window with bands of equal width.
+ *
+ * The band of a value is value / step, e.g. a step of 10 yields one band per percent of
+ * a 0-1000 range.
+ *
+ * @param channel The ADC channel (ADC_Channel) to watch.
+ * @param step Width of each band.
+ * @param hysteresis Distance a value has to pass a band limit before the band changes.
+ * @param filterShift Exponential smoothing alpha (1 / 2^filterShift), 0 compares raw values.
+ * @param callback Function called on a band change, or 0 to use the event flags only.
+ * @return The window handle, or ADC_WINDOW_INVALID if all windows are in use.
+ */
+uint8_t adcWindowRegisterStep(uint8_t channel, uint16_t step, uint8_t hysteresis, uint8_t filterShift,
+                              AdcWindowCallback callback);
+
+/**
+ * @brief Returns and clears the pending band change events.
+ *
+ * @return Bit mask with bit n set if window n changed its band since the last call.
+ */
+uint8_t adcWindowGetEvents(void);
+
+/**
+ * @brief Returns the current band of a window.
+ *
+ * @param window The window handle.
+ * @return The band, or ADC_WINDOW_BAND_UNKNOWN before the first frame.
+ */
+uint8_t adcWindowGetBand(uint8_t window);
+
+/**
+ * @brief Returns the latest (smoothed) channel value of a window.
+ *
+ * @param window The window handle.
+ * @return The value the band was last evaluated for.
+ */
+uint16_t adcWindowGetValue(uint8_t window);
+
+#endif /* ADCWINDOW_H_ */
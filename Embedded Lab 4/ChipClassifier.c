@@ -0,0 +1,236 @@
+/**
+ * @file    ChipClassifier.c
+ * @brief   Nearest-centroid classification of poker chips.
+ *
+ * This file contains the implementation of a configurable nearest-centroid classifier for
+ * the red/green LDR feature vector and of the calibration mode that learns the centroids.
+ * The distance is the city-block distance |dr| + |dg|, which needs no multiplication on
+ * the MSP430G2553 (no hardware multiplier) and separates the well-spaced chip classes just
+ * as well as the Euclidean distance.
+ *
+ * Learned centroids are stored in information flash segment C together with a magic word,
+ * so they survive a reset and a re-flash of the main memory.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+#include <msp430.h>
+
+#include "ChipClassifier.h"
+
+#define CENTROID_STORE_ADDRESS 0x1040 /**< Information memory segment C */
+#define CENTROID_STORE_MAGIC 0xC41B   /**< Marks a valid stored calibration */
+
+// Layout of the calibration in information flash
+typedef struct
+{
+    uint16_t magic;
+    ChipFeatures centroids[NUM_CHIP_CLASSES];
+} CentroidStore;
+
+// Default centroids, roughly the old single-reading bands split across both colours
+static const ChipFeatures defaultCentroids[NUM_CHIP_CLASSES] = {
+    {150, 150}, // CHIP_NONE
+    {75, 75},   // CHIP_WHITE
+    {25, 25}    // CHIP_BLACK
+};
+
+static const char *const chipClassNames[NUM_CHIP_CLASSES] = {"None", "White", "Black"};
+
+static ChipFeatures centroids[NUM_CHIP_CLASSES]; /**< Active centroids */
+static uint8_t calibrationActive = 0;            /**< 1 while the calibration mode runs */
+static uint8_t calibrationClass;                 /**< Class currently being calibrated */
+static uint8_t calibrationCount;                 /**< Samples collected for that class */
+static uint16_t calibrationRedSum;               /**< Sum of the red features collected */
+static uint16_t calibrationGreenSum;             /**< Sum of the green features collected */
+
+/**
+ * @brief Returns the absolute difference of two values.
+ *
+ * @param a First value.
+ * @param b Second value.
+ * @return |a - b|
+ */
+static uint16_t absoluteDifference(uint16_t a, uint16_t b)
+{
+    return (a > b) ? a - b : b - a;
+}
+
+/**
+ * @brief Initializes the chip classifier.
+ *
+ * Loads the centroids from information flash if a calibration was stored, otherwise the
+ * built-in default centroids are used.
+ */
+void initChipClassifier(void)
+{
+    const CentroidStore *store = (const CentroidStore *)CENTROID_STORE_ADDRESS;
+    const ChipFeatures *source = (store->magic == CENTROID_STORE_MAGIC) ? store->centroids : defaultCentroids;
+    uint8_t i;
+
+    for (i = 0; i < NUM_CHIP_CLASSES; i++)
+    {
+        centroids[i] = source[i];
+    }
+    calibrationActive = 0;
+}
+
+/**
+ * @brief Classifies a feature vector.
+ *
+ * @param features Pointer to the feature vector to classify.
+ * @return The class (CHIP_CLASS) with the nearest centroid.
+ */
+uint8_t classifyChip(const ChipFeatures *features)
+{
+    uint8_t bestClass = CHIP_NONE;
+    uint16_t bestDistance = 0xFFFF;
+    uint16_t distance;
+    uint8_t i;
+
+    for (i = 0; i < NUM_CHIP_CLASSES; i++)
+    {
+        distance = absoluteDifference(features->red, centroids[i].red) + absoluteDifference(features->green, centroids[i].green);
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            bestClass = i;
+        }
+    }
+
+    return bestClass;
+}
+
+/**
+ * @brief Returns the display name of a chip class.
+ *
+ * @param chipClass The chip class.
+ * @return Pointer to a constant string with the name of the class.
+ */
+const char *getChipClassName(uint8_t chipClass)
+{
+    if (chipClass >= NUM_CHIP_CLASSES)
+    {
+        return "ERROR";
+    }
+    return chipClassNames[chipClass];
+}
+
+/**
+ * @brief Replaces the centroid of a class.
+ *
+ * @param chipClass The chip class whose centroid is replaced.
+ * @param centroid Pointer to the new centroid.
+ */
+void setChipCentroid(uint8_t chipClass, const ChipFeatures *centroid)
+{
+    if (chipClass < NUM_CHIP_CLASSES)
+    {
+        centroids[chipClass] = *centroid;
+    }
+}
+
+/**
+ * @brief Stores the current centroids in information flash.
+ *
+ * Erases segment C and writes the magic word followed by the centroids. The flash timing
+ * generator runs from MCLK / 3 = 333 kHz, inside the 257-476 kHz window of the G2553.
+ * Interrupts are disabled because the flash cannot be read while it is being written.
+ */
+void saveChipCentroids(void)
+{
+    volatile uint16_t *flash = (volatile uint16_t *)CENTROID_STORE_ADDRESS;
+    const uint16_t *source = (const uint16_t *)centroids;
+    uint8_t i;
+
+    __disable_interrupt();
+
+    FCTL2 = FWKEY + FSSEL_1 + FN1; // MCLK / 3 as flash timing generator
+    FCTL3 = FWKEY;                 // Unlock the flash
+    FCTL1 = FWKEY + ERASE;         // Segment erase
+    *flash = 0;                    // Dummy write starts the erase
+
+    FCTL1 = FWKEY + WRT; // Word write
+    flash[0] = CENTROID_STORE_MAGIC;
+    for (i = 0; i < NUM_CHIP_CLASSES * (sizeof(ChipFeatures) / sizeof(uint16_t)); i++)
+    {
+        flash[i + 1] = source[i];
+    }
+
+    FCTL1 = FWKEY;        // Leave write mode
+    FCTL3 = FWKEY + LOCK; // Lock the flash again
+
+    __enable_interrupt();
+}
+
+/**
+ * @brief Starts the calibration mode with the first chip class.
+ */
+void startChipCalibration(void)
+{
+    calibrationClass = CHIP_NONE;
+    calibrationCount = 0;
+    calibrationRedSum = 0;
+    calibrationGreenSum = 0;
+    calibrationActive = 1;
+}
+
+/**
+ * @brief Returns whether the calibration mode is active.
+ *
+ * @return 1 if a calibration is running, 0 otherwise.
+ */
+uint8_t isChipCalibrationActive(void)
+{
+    return calibrationActive;
+}
+
+/**
+ * @brief Returns the chip class currently being calibrated.
+ *
+ * @return The chip class (CHIP_CLASS) whose samples are collected.
+ */
+uint8_t getChipCalibrationClass(void)
+{
+    return calibrationClass;
+}
+
+/**
+ * @brief Adds a measurement to the centroid of the class being calibrated.
+ *
+ * @param features Pointer to the measured feature vector.
+ * @return The calibration progress (CALIBRATION_STATE).
+ */
+uint8_t addChipCalibrationSample(const ChipFeatures *features)
+{
+    ChipFeatures centroid;
+
+    calibrationRedSum += features->red;
+    calibrationGreenSum += features->green;
+
+    if (++calibrationCount < CHIP_CALIBRATION_SAMPLES)
+    {
+        return CALIBRATION_SAMPLING;
+    }
+
+    centroid.red = calibrationRedSum / CHIP_CALIBRATION_SAMPLES;
+    centroid.green = calibrationGreenSum / CHIP_CALIBRATION_SAMPLES;
+    setChipCentroid(calibrationClass, &centroid);
+
+    calibrationCount = 0;
+    calibrationRedSum = 0;
+    calibrationGreenSum = 0;
+
+    if (++calibrationClass < NUM_CHIP_CLASSES)
+    {
+        return CALIBRATION_NEXT_CLASS;
+    }
+
+    saveChipCentroids();
+    calibrationActive = 0;
+
+    return CALIBRATION_DONE;
+}
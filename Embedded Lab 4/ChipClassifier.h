@@ -0,0 +1,115 @@
+/**
+ * @file    ChipClassifier.h
+ * @brief   Header file for ChipClassifier.c
+ *
+ * This file contains declarations of the nearest-centroid chip classifier. A chip is
+ * described by a 2-D feature vector (LDR response under red light, LDR response under
+ * green light) and assigned to the class with the closest centroid. The centroids can be
+ * learned in a calibration mode and are kept in information flash.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ */
+
+#ifndef CHIPCLASSIFIER_H_
+#define CHIPCLASSIFIER_H_
+
+#include <stdint.h>
+
+#define CHIP_CALIBRATION_SAMPLES 8 /** Measurements averaged into each learned centroid */
+
+// Enum for the chip classes
+typedef enum
+{
+    CHIP_NONE,   /** No chip on the sleeve */
+    CHIP_WHITE,  /** White chip */
+    CHIP_BLACK,  /** Black chip */
+    NUM_CHIP_CLASSES
+} CHIP_CLASS;
+
+// Enum for the result of adding a calibration sample
+typedef enum
+{
+    CALIBRATION_SAMPLING,   /** More samples are needed for the current class */
+    CALIBRATION_NEXT_CLASS, /** The current class is learned, continue with the next one */
+    CALIBRATION_DONE        /** All classes are learned and stored in flash */
+} CALIBRATION_STATE;
+
+// 2-D feature vector of one measurement
+typedef struct
+{
+    uint16_t red;   /** LDR response to the red LED */
+    uint16_t green; /** LDR response to the green LED */
+} ChipFeatures;
+
+/**
+ * @brief Initializes the chip classifier.
+ *
+ * Loads the centroids from information flash if a calibration was stored, otherwise the
+ * built-in default centroids are used.
+ */
+void initChipClassifier(void);
+
+/**
+ * @brief Classifies a feature vector.
+ *
+ * @param features Pointer to the feature vector to classify.
+ * @return The class (CHIP_CLASS) with the nearest centroid.
+ */
+uint8_t classifyChip(const ChipFeatures *features);
+
+/**
+ * @brief Returns the display name of a chip class.
+ *
+ * @param chipClass The chip class.
+ * @return Pointer to a constant string with the name of the class.
+ */
+const char *getChipClassName(uint8_t chipClass);
+
+/**
+ * @brief Replaces the centroid of a class.
+ *
+ * The change is kept in RAM only; call saveChipCentroids() to store it.
+ *
+ * @param chipClass The chip class whose centroid is replaced.
+ * @param centroid Pointer to the new centroid.
+ */
+void setChipCentroid(uint8_t chipClass, const ChipFeatures *centroid);
+
+/**
+ * @brief Stores the current centroids in information flash.
+ */
+void saveChipCentroids(void);
+
+/**
+ * @brief Starts the calibration mode with the first chip class.
+ */
+void startChipCalibration(void);
+
+/**
+ * @brief Returns whether the calibration mode is active.
+ *
+ * @return 1 if a calibration is running, 0 otherwise.
+ */
+uint8_t isChipCalibrationActive(void);
+
+/**
+ * @brief Returns the chip class currently being calibrated.
+ *
+ * @return The chip class (CHIP_CLASS) whose samples are collected.
+ */
+uint8_t getChipCalibrationClass(void);
+
+/**
+ * @brief Adds a measurement to the centroid of the class being calibrated.
+ *
+ * After CHIP_CALIBRATION_SAMPLES measurements the averaged centroid replaces the old one
+ * and the calibration moves on to the next class. After the last class the centroids are
+ * stored in flash and the calibration mode ends.
+ *
+ * @param features Pointer to the measured feature vector.
+ * @return The calibration progress (CALIBRATION_STATE).
+ */
+uint8_t addChipCalibrationSample(const ChipFeatures *features);
+
+#endif /* CHIPCLASSIFIER_H_ */
@@ -0,0 +1,327 @@
+/**
+ * @file    Console.c
+ * @brief   Functions for the serial command console.
+ *
+ * This file contains the implementation of the command console. The received bytes are
+ * collected in a line buffer; at the end of the line the spaces are replaced by string
+ * terminators and the words are passed to the handler as pointers into the buffer. The
+ * name hashes are stored in the constant table (flash); a typed command is hashed while
+ * it is looked up and only compared in full when the hash matches.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "Console.h"
+
+#define CONSOLE_PROMPT "> "
+
+#define HELP_HASH 0x5C94 // consoleHash("help")
+
+#define KEY_BACKSPACE 0x08
+#define KEY_DELETE 0x7F
+
+// Defined by templateEMP.h in main.c
+extern char serialAvailable(void);
+extern int serialRead(void);
+extern void serialWrite(char tx);
+extern void serialPrint(char *tx);
+extern void serialPrintln(char *tx);
+
+void initConsole(const ConsoleCommand *commands, uint8_t count);
+void consolePoll(void);
+uint8_t consoleLineActive(void);
+void consoleRedrawLine(void);
+uint16_t consoleHash(const char *name);
+int8_t consoleParseInt(const char *text, int16_t *value);
+static void runLine(void);
+static uint8_t splitLine(char *line, char *argv[]);
+static void printHelp(void);
+
+static const ConsoleCommand *commandTable = 0;           /**< Commands of the application */
+static uint8_t commandCount = 0;                          /**< Entries of the table */
+static char line[CONSOLE_LINE_LENGTH + 1];                /**< Line being typed */
+static uint8_t lineLength = 0;                            /**< Characters in the line */
+static uint8_t lineOverflow = 0;                          /**< 1 if characters were dropped */
+
+/**
+ * @brief Initializes the console.
+ *
+ * @param commands The command table.
+ * @param count Number of commands, at most CONSOLE_MAX_COMMANDS.
+ */
+void initConsole(const ConsoleCommand *commands, uint8_t count)
+{
+    uint8_t i;
+
+    if (count > CONSOLE_MAX_COMMANDS)
+    {
+        count = CONSOLE_MAX_COMMANDS;
+    }
+
+    commandTable = commands;
+    commandCount = count;
+
+    // A hash that does not match would make the command unreachable
+    for (i = 0; i < count; i++)
+    {
+        if (commands[i].hash != consoleHash(commands[i].name))
+        {
+            serialPrint("Wrong hash: ");
+            serialPrintln((char *)commands[i].name);
+        }
+    }
+
+    lineLength = 0;
+    lineOverflow = 0;
+    serialPrint(CONSOLE_PROMPT);
+}
+
+/**
+ * @brief Processes the received bytes.
+ */
+void consolePoll(void)
+{
+    char received;
+
+    while (serialAvailable())
+    {
+        received = (char)serialRead();
+
+        if (received == '\r' || received == '\n')
+        {
+            // An empty line after '\r' is the '\n' of a CR LF terminal
+            if (lineLength == 0 && !lineOverflow && received == '\n')
+            {
+                continue;
+            }
+
+            serialPrint("\r\n");
+            runLine();
+            serialPrint(CONSOLE_PROMPT);
+        }
+        else if (received == KEY_BACKSPACE || received == KEY_DELETE)
+        {
+            if (lineLength > 0)
+            {
+                lineLength--;
+                serialPrint("\b \b");
+            }
+        }
+        else if (received >= ' ' && received < KEY_DELETE)
+        {
+            if (lineLength < CONSOLE_LINE_LENGTH)
+            {
+                line[lineLength++] = received;
+                serialWrite(received);
+            }
+            else
+            {
+                lineOverflow = 1;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Checks whether a command is being typed.
+ *
+ * @return Returns 1 while the line holds characters, 0 otherwise.
+ */
+uint8_t consoleLineActive(void)
+{
+    return lineLength > 0;
+}
+
+/**
+ * @brief Prints the prompt and the line typed so far again.
+ */
+void consoleRedrawLine(void)
+{
+    uint8_t i;
+
+    serialPrint(CONSOLE_PROMPT);
+    for (i = 0; i < lineLength; i++)
+    {
+        serialWrite(line[i]);
+    }
+}
+
+/**
+ * @brief Hashes a command name (djb2 with XOR, the multiplication by 33 is a shift and
+ *        an addition).
+ *
+ * @param name The name.
+ *
+ * @return The hash.
+ */
+uint16_t consoleHash(const char *name)
+{
+    uint16_t hash = 5381;
+
+    while (*name)
+    {
+        hash = ((hash << 5) + hash) ^ (uint8_t)*name++;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Parses a decimal integer argument.
+ *
+ * @param text The argument, with an optional leading '-'.
+ * @param value Pointer to the result; not changed on an error.
+ *
+ * @return Returns 0 on success, or -1 if the text is no number or does not fit in
+ *         16 bits.
+ */
+int8_t consoleParseInt(const char *text, int16_t *value)
+{
+    uint16_t number = 0;
+    uint16_t limit = INT16_MAX;
+    uint8_t negative = 0;
+
+    if (*text == '-')
+    {
+        negative = 1;
+        limit = (uint16_t)INT16_MAX + 1;
+        text++;
+    }
+
+    if (*text == '\0')
+    {
+        return -1;
+    }
+
+    // Stops at the terminator of the word, no waiting for further input
+    while (*text)
+    {
+        if (*text < '0' || *text > '9')
+        {
+            return -1;
+        }
+
+        if (number > (limit - (uint16_t)(*text - '0')) / 10)
+        {
+            return -1;
+        }
+
+        number = number * 10 + (*text - '0');
+        text++;
+    }
+
+    *value = negative ? (int16_t)(0U - number) : (int16_t)number;
+    return 0;
+}
+
+/**
+ * @brief Runs the command of the completed line and clears the line.
+ */
+static void runLine(void)
+{
+    char *argv[CONSOLE_MAX_ARGS + 1];
+    uint8_t argc;
+    uint16_t hash;
+    uint8_t i;
+
+    line[lineLength] = '\0';
+    lineLength = 0;
+
+    if (lineOverflow)
+    {
+        lineOverflow = 0;
+        serialPrintln("Line too long");
+        return;
+    }
+
+    argc = splitLine(line, argv);
+    if (argc == 0)
+    {
+        return;
+    }
+    if (argc > CONSOLE_MAX_ARGS)
+    {
+        serialPrintln("Too many arguments");
+        return;
+    }
+
+    hash = consoleHash(argv[0]);
+
+    if (hash == HELP_HASH && strcmp(argv[0], "help") == 0)
+    {
+        printHelp();
+        return;
+    }
+
+    for (i = 0; i < commandCount; i++)
+    {
+        if (commandTable[i].hash == hash && strcmp(commandTable[i].name, argv[0]) == 0)
+        {
+            commandTable[i].handler(argc, argv);
+            return;
+        }
+    }
+
+    serialPrint("Unknown command: ");
+    serialPrintln(argv[0]);
+}
+
+/**
+ * @brief Splits a line into words in place.
+ *
+ * @param line The line; the spaces are replaced by terminators.
+ * @param argv Array of CONSOLE_MAX_ARGS + 1 entries for the words.
+ *
+ * @return The number of words; CONSOLE_MAX_ARGS + 1 if there are more words than fit.
+ */
+static uint8_t splitLine(char *line, char *argv[])
+{
+    uint8_t argc = 0;
+
+    while (*line)
+    {
+        // Terminate the previous word and skip the spaces
+        while (*line == ' ')
+        {
+            *line++ = '\0';
+        }
+        if (*line == '\0')
+        {
+            break;
+        }
+
+        argv[argc++] = line;
+        if (argc > CONSOLE_MAX_ARGS)
+        {
+            break;
+        }
+
+        while (*line && *line != ' ')
+        {
+            line++;
+        }
+    }
+
+    return argc;
+}
+
+/**
+ * @brief Prints the commands with their help texts.
+ */
+static void printHelp(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < commandCount; i++)
+    {
+        serialPrint((char *)commandTable[i].name);
+        serialPrint(" ");
+        serialPrintln((char *)commandTable[i].help);
+    }
+    serialPrintln("help - this list");
+}
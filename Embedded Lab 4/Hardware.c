@@ -17,6 +17,11 @@
 
 #define ZERO 0 /**< Zero value */
 
+static volatile uint16_t tickCount = ZERO;    /**< Milliseconds since initTimer() */
+static TickCallback tickCallback = 0;         /**< Function called on every tick */
+static AdcFrameCallback adcFrameCallback = 0; /**< Function called on every completed frame */
+static uint16_t *adcFrame = 0;                /**< Target of the running DTC transfer */
+
 /**
  * @brief Initializes the buttons.
  *
@@ -37,15 +42,20 @@ void initButtons()
  * @brief Returns the currently pressed button.
  *
  * This function checks the input states of pins P3.0 and P3.1 to determine if a button is pressed.
+ * If both pins are low, it returns BUTTON_BOTH.
  * If P3.0 is low, it returns BUTTON_1, indicating that the first button is pressed.
  * If P3.1 is low, it returns BUTTON_2, indicating that the second button is pressed.
  * If neither button is pressed, it returns BUTTON_NONE.
  *
- * @return The currently pressed button (BUTTON_1, BUTTON_2, or BUTTON_NONE).
+ * @return The currently pressed button (BUTTON_1, BUTTON_2, BUTTON_BOTH or BUTTON_NONE).
  */
 uint8_t getPressedButton()
 {
-	if ((P3IN & BIT0) == ZERO)
+	if ((P3IN & (BIT0 | BIT1)) == ZERO)
+	{
+		return BUTTON_BOTH;
+	}
+	else if ((P3IN & BIT0) == ZERO)
 	{
 		return BUTTON_1;
 	}
@@ -77,20 +87,27 @@ void initLEDs()
 /**
  * @brief Sets the state of the LEDs.
  *
- * This function controls the state of the LEDs connected to pins P3.2 and P3.3.
+ * This function controls the state of the red LED on P3.2 and the green LED on P3.3.
  *
- * @param state The state to set the LEDs to. Use LED_ON to turn the LEDs on,
- *              and any other value to turn them off.
+ * @param state The state to set the LEDs to. Use LED_ON to turn both LEDs on, LED_RED or
+ *              LED_GREEN to turn on a single LED, and any other value to turn them off.
  */
 void setLEDState(uint8_t state)
 {
-	if (state == LED_ON)
+	switch (state)
 	{
+	case LED_ON:
 		P3OUT |= BIT2 + BIT3; // Enable both LEDs (P3.2 and P3.3)
-	}
-	else
-	{
+		break;
+	case LED_RED:
+		P3OUT = (P3OUT & ~BIT3) | BIT2; // Enable only the red LED (P3.2)
+		break;
+	case LED_GREEN:
+		P3OUT = (P3OUT & ~BIT2) | BIT3; // Enable only the green LED (P3.3)
+		break;
+	default:
 		P3OUT &= ~(BIT2 + BIT3); // Disable both LEDs (P3.2 and P3.3)
+		break;
 	}
 }
 
@@ -100,11 +117,12 @@ void setLEDState(uint8_t state)
  * This function configures the ADC settings to enable analog input conversion.
  * It sets up the ADC channels, reference voltage, sample-and-hold time, and ADC conversion
  * sequence. Additionally, it enables the ADC and sets up the data transfer control for the ADC.
+ * The ADC interrupt fires once the DTC has transferred a complete frame.
  */
 void initADC(void)
 {
-	ADC10CTL1 = INCH_7 + ADC10DIV_0 + CONSEQ_3 + SHS_0; // Set input channel 7, ADC clock divider, conversion sequence, and sample-and-hold source
-	ADC10CTL0 = SREF_0 + ADC10SHT_2 + MSC + ADC10ON;	// Set reference voltage, sample-and-hold time, multiple sample conversion, and turn on ADC
+	ADC10CTL1 = INCH_7 + ADC10DIV_0 + CONSEQ_3 + SHS_0;		  // Set input channel 7, ADC clock divider, conversion sequence, and sample-and-hold source
+	ADC10CTL0 = SREF_0 + ADC10SHT_2 + MSC + ADC10ON + ADC10IE; // Set reference voltage, sample-and-hold time, multiple sample conversion, frame interrupt, and turn on ADC
 	ADC10AE0 = BIT7 + BIT6 + BIT5 + BIT4 + BIT3 + BIT0; // Enable analog input channels 0, 3, 4, 5, 6, and 7
 	ADC10DTC1 = ADC_CHANNELS;							// Set the number of conversions to perform
 }
@@ -125,5 +143,82 @@ void readADC(uint16_t *adcChannelValues)
 	ADC10CTL0 |= ENC + ADC10SC; // Start ADC conversion
 
 	// Set ADC buffer register address to store conversion results
+	adcFrame = adcChannelValues;
 	ADC10SA = (uint16_t)adcChannelValues;
 }
+
+/**
+ * @brief Registers the function called when the DTC has completed a frame.
+ *
+ * @param callback The function to call, or 0 to disable the callback.
+ */
+void setAdcFrameCallback(AdcFrameCallback callback)
+{
+	adcFrameCallback = callback;
+}
+
+
+/**
+ * @brief Initializes the millisecond timer.
+ *
+ * This function configures Timer A0 in up mode from SMCLK so that the CCR0 interrupt
+ * fires every 1 ms.
+ */
+void initTimer(void)
+{
+	TA0CCR0 = TIMER_TICKS_PER_MS - 1; // 1 ms period at SMCLK = 1MHz
+	TA0CCTL0 = CCIE;                  // Enable the CCR0 interrupt
+	TA0CTL = TASSEL_2 + MC_1 + TACLR; // SMCLK, up mode, clear TAR
+}
+
+/**
+ * @brief Registers the function called from the 1 ms timer interrupt.
+ *
+ * @param callback The function to call on every tick, or 0 to disable the callback.
+ */
+void setTickCallback(TickCallback callback)
+{
+	tickCallback = callback;
+}
+
+/**
+ * @brief Returns the number of milliseconds since initTimer() was called.
+ *
+ * @return The tick counter, wrapping around after 65535 ms.
+ */
+uint16_t getTickCount(void)
+{
+	return tickCount; // A 16-bit read is atomic on the MSP430
+}
+
+/**
+ * @brief Timer A0 CCR0 interrupt service routine.
+ *
+ * This ISR is triggered every 1 ms. It advances the tick counter and runs the
+ * registered tick callback.
+ */
+#pragma vector = TIMER0_A0_VECTOR
+__interrupt void timer0A0ISR(void)
+{
+	tickCount++;
+
+	if (tickCallback)
+	{
+		tickCallback();
+	}
+}
+
+/**
+ * @brief ADC10 interrupt service routine.
+ *
+ * This ISR is triggered when the DTC has written the last value of a frame. It passes the
+ * completed frame to the registered frame callback.
+ */
+#pragma vector = ADC10_VECTOR
+__interrupt void adc10ISR(void)
+{
+	if (adcFrameCallback)
+	{
+		adcFrameCallback(adcFrame);
+	}
+}
@@ -15,6 +15,13 @@
 #include <stdint.h>
 
 #define ADC_CHANNELS 8 /** Number of ADC channels */
+#define TIMER_TICKS_PER_MS 1000 /** SMCLK cycles per millisecond (SMCLK = 1MHz) */
+
+// Function called from the 1 ms timer interrupt
+typedef void (*TickCallback)(void);
+
+// Function called from the ADC interrupt with the frame the DTC has just completed
+typedef void (*AdcFrameCallback)(const uint16_t *frame);
 
 // Enum for ADC channels, stored in reverse order due to hardware constraints
 typedef enum
@@ -32,8 +39,10 @@ typedef enum
 // Enum for LED states
 typedef enum
 {
-    LED_OFF, /** LED is turned off */
-    LED_ON   /** LED is turned on */
+    LED_OFF,  /** Both LEDs are turned off */
+    LED_ON,   /** Both LEDs are turned on */
+    LED_RED,  /** Only the red LED is turned on */
+    LED_GREEN /** Only the green LED is turned on */
 } LED_STATE;
 
 // Enum for button states
@@ -41,7 +50,8 @@ typedef enum
 {
     BUTTON_NONE, /** No button is pressed */
     BUTTON_1,    /** Button 1 is pressed */
-    BUTTON_2     /** Button 2 is pressed */
+    BUTTON_2,    /** Button 2 is pressed */
+    BUTTON_BOTH  /** Button 1 and button 2 are pressed together */
 } Button;
 
 /**
@@ -57,7 +67,7 @@ void initLEDs(void);
  *
  * This function controls the state of the LEDs connected to the pins.
  *
- * @param state The state to set the LEDs to (LED_OFF or LED_ON).
+ * @param state The state to set the LEDs to (LED_OFF, LED_ON, LED_RED or LED_GREEN).
  */
 void setLEDState(uint8_t state);
 
@@ -80,6 +90,15 @@ void initADC(void);
  */
 void readADC(uint16_t *adcChannelValues);
 
+/**
+ * @brief Registers the function called when the DTC has completed a frame.
+ *
+ * The callback runs in interrupt context after every frame started by readADC().
+ *
+ * @param callback The function to call, or 0 to disable the callback.
+ */
+void setAdcFrameCallback(AdcFrameCallback callback);
+
 /**
  * @brief Initializes the buttons.
  *
@@ -93,8 +112,30 @@ void initButtons(void);
  *
  * This function checks the input states of pins connected to buttons to determine if a button is pressed.
  *
- * @return The currently pressed button (BUTTON_1, BUTTON_2, or BUTTON_NONE).
+ * @return The currently pressed button (BUTTON_1, BUTTON_2, BUTTON_BOTH or BUTTON_NONE).
  */
 uint8_t getPressedButton(void);
 
+/**
+ * @brief Initializes the millisecond timer.
+ *
+ * This function configures Timer A0 to generate an interrupt every 1 ms. The interrupt
+ * increments the tick counter and calls the registered tick callback.
+ */
+void initTimer(void);
+
+/**
+ * @brief Registers the function called from the 1 ms timer interrupt.
+ *
+ * @param callback The function to call on every tick, or 0 to disable the callback.
+ */
+void setTickCallback(TickCallback callback);
+
+/**
+ * @brief Returns the number of milliseconds since initTimer() was called.
+ *
+ * @return The tick counter, wrapping around after 65535 ms.
+ */
+uint16_t getTickCount(void);
+
 #endif /* HARDWARE_H_ */
@@ -0,0 +1,226 @@
+/**
+ * @file    LdrLockIn.c
+ * @brief   Lock-in style LDR acquisition for the chip detector.
+ *
+ * This file contains the implementation of a synchronous LDR measurement. A state machine
+ * running in the 1 ms timer interrupt steps through three illumination phases (red only,
+ * green only, both LEDs off), waits until the LDR has settled after each switch and
+ * accumulates samples of CHANNEL_6 from the ADC DTC. Subtracting the dark average from
+ * the red and green averages removes the ambient light from both colour channels.
+ *
+ * The LDR needs a few milliseconds to follow an abrupt change of light. Instead of a fixed
+ * delay, a phase is considered settled as soon as two consecutive 1 ms samples differ by no
+ * more than LOCKIN_SETTLE_TOLERANCE, so bright (fast) readings finish early and dark (slow)
+ * readings get the time they need, bounded by LOCKIN_SETTLE_TIMEOUT_MS.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+#include <msp430.h>
+
+#include "Hardware.h"
+#include "LdrLockIn.h"
+
+#define LOCKIN_SAMPLES_PER_RESULT (LOCKIN_SAMPLES_PER_PHASE * LOCKIN_CYCLES)
+
+// Enum for the illumination phases, in the order they are measured
+typedef enum
+{
+    PHASE_RED,   /** Only the red LED is on */
+    PHASE_GREEN, /** Only the green LED is on */
+    PHASE_DARK,  /** Both LEDs are off, ambient light only */
+    NUM_PHASES   /** Number of phases per cycle */
+} LOCKIN_PHASE;
+
+// Enum for the acquisition states
+typedef enum
+{
+    LOCKIN_IDLE,   /** No measurement running */
+    LOCKIN_SETTLE, /** Waiting for the LDR to settle after an LED switch */
+    LOCKIN_SAMPLE, /** Accumulating samples of the current phase */
+    LOCKIN_DONE    /** Result ready to be picked up by lockInPoll() */
+} LOCKIN_STATE;
+
+// LED state of each phase
+static const uint8_t phaseLedStates[NUM_PHASES] = {LED_RED, LED_GREEN, LED_OFF};
+
+static uint16_t frame[ADC_CHANNELS];         /**< DTC target of the acquisition */
+static volatile uint8_t state = LOCKIN_IDLE; /**< Current acquisition state */
+static uint8_t phase;                        /**< Current illumination phase */
+static uint16_t previousSample;              /**< Last sample, used for the settle check */
+static uint8_t phaseTicks;                   /**< Ticks spent settling in the current phase */
+static uint8_t sampleCount;                  /**< Samples accumulated in the current phase */
+static uint8_t cycleCount;                   /**< Completed red/green/dark cycles */
+static uint16_t phaseSums[NUM_PHASES];       /**< Sum of all samples of each phase */
+static uint16_t startTick;                   /**< Tick count at the start of the measurement */
+static LockInResult lastResult;              /**< Result of the last completed measurement */
+
+/**
+ * @brief Switches the LEDs and enters a new phase.
+ *
+ * @param newPhase The phase to enter.
+ */
+static void enterPhase(uint8_t newPhase)
+{
+    phase = newPhase;
+    phaseTicks = 0;
+    sampleCount = 0;
+    setLEDState(phaseLedStates[newPhase]);
+    state = LOCKIN_SETTLE;
+}
+
+/**
+ * @brief Checks whether the LDR has settled after the last LED switch.
+ *
+ * The first sample of a phase is never accepted because its frame may have been converted
+ * before the LEDs switched.
+ *
+ * @param sample The latest LDR sample.
+ * @return 1 if the LDR has settled or the settle timeout expired, 0 otherwise.
+ */
+static uint8_t isSettled(uint16_t sample)
+{
+    uint16_t difference = (sample > previousSample) ? sample - previousSample : previousSample - sample;
+
+    previousSample = sample;
+    phaseTicks++;
+
+    return (phaseTicks > 1 && difference <= LOCKIN_SETTLE_TOLERANCE) || phaseTicks >= LOCKIN_SETTLE_TIMEOUT_MS;
+}
+
+/**
+ * @brief Subtracts the ambient average from an illuminated phase.
+ *
+ * @param illuminatedSum Sum of the samples of an illuminated phase.
+ * @return The LED contribution, clamped at 0.
+ */
+static uint16_t removeAmbient(uint16_t illuminatedSum)
+{
+    uint16_t illuminated = illuminatedSum / LOCKIN_SAMPLES_PER_RESULT;
+
+    return (illuminated > lastResult.ambient) ? illuminated - lastResult.ambient : 0;
+}
+
+/**
+ * @brief Completes the measurement and stores the result.
+ */
+static void finishMeasurement(void)
+{
+    setLEDState(LED_OFF);
+
+    lastResult.ambient = phaseSums[PHASE_DARK] / LOCKIN_SAMPLES_PER_RESULT;
+    lastResult.red = removeAmbient(phaseSums[PHASE_RED]);
+    lastResult.green = removeAmbient(phaseSums[PHASE_GREEN]);
+    lastResult.latencyMs = getTickCount() - startTick;
+
+    state = LOCKIN_DONE;
+}
+
+/**
+ * @brief Acquisition state machine, called every 1 ms from the timer interrupt.
+ *
+ * Each tick consumes the frame the DTC filled since the previous tick and re-arms the DTC
+ * for the next one.
+ */
+static void lockInTick(void)
+{
+    uint16_t sample = frame[CHANNEL_6];
+
+    switch (state)
+    {
+    case LOCKIN_SETTLE:
+        if (isSettled(sample))
+        {
+            state = LOCKIN_SAMPLE;
+        }
+        break;
+    case LOCKIN_SAMPLE:
+        phaseSums[phase] += sample;
+        if (++sampleCount < LOCKIN_SAMPLES_PER_PHASE)
+        {
+            break;
+        }
+        if (phase + 1 < NUM_PHASES)
+        {
+            enterPhase(phase + 1);
+        }
+        else if (++cycleCount < LOCKIN_CYCLES)
+        {
+            enterPhase(PHASE_RED);
+        }
+        else
+        {
+            finishMeasurement();
+            return;
+        }
+        break;
+    default:
+        return; // Idle or done, leave the ADC alone
+    }
+
+    readADC(frame); // Arm the DTC for the next tick
+}
+
+/**
+ * @brief Initializes the lock-in acquisition.
+ *
+ * This function starts the millisecond timer and registers the acquisition state machine
+ * as its tick callback.
+ */
+void initLockIn(void)
+{
+    state = LOCKIN_IDLE;
+    setTickCallback(lockInTick);
+    initTimer();
+}
+
+/**
+ * @brief Polls the lock-in acquisition.
+ *
+ * @param result Pointer to the structure the finished measurement is copied to.
+ * @return 1 if a new result was stored in `result`, 0 if the measurement is still running.
+ */
+uint8_t lockInPoll(LockInResult *result)
+{
+    uint8_t i;
+
+    if (state == LOCKIN_DONE)
+    {
+        *result = lastResult;
+        state = LOCKIN_IDLE;
+        return 1;
+    }
+
+    if (state == LOCKIN_IDLE)
+    {
+        for (i = 0; i < NUM_PHASES; i++)
+        {
+            phaseSums[i] = 0;
+        }
+        cycleCount = 0;
+        startTick = getTickCount();
+        previousSample = frame[CHANNEL_6];
+        readADC(frame);
+        enterPhase(PHASE_RED);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Aborts a running measurement and switches the LEDs off.
+ */
+void lockInStop(void)
+{
+    uint16_t interruptState;
+
+    // Called on every pass of the main loop, so keep the caller's interrupt state
+    interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    state = LOCKIN_IDLE;
+    setLEDState(LED_OFF);
+    __set_interrupt_state(interruptState);
+}
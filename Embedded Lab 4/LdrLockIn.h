@@ -0,0 +1,62 @@
+/**
+ * @file    LdrLockIn.h
+ * @brief   Header file for LdrLockIn.c
+ *
+ * This file contains declarations of the lock-in style LDR acquisition used by the chip
+ * detector. The LEDs are modulated from the 1 ms timer tick and the LDR is sampled under
+ * red-only light, green-only light and with both LEDs off, so ambient light can be
+ * subtracted from each colour.
+ *
+ * This is a tick-synchronous chopper, not a Timer_A-driven lock-in: the LEDs are switched
+ * by software in the 1 ms tick, so a phase lasts a whole number of ticks and its length
+ * follows the settling of the LDR instead of a fixed modulation frequency.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ */
+
+#ifndef LDRLOCKIN_H_
+#define LDRLOCKIN_H_
+
+#include <stdint.h>
+
+#define LOCKIN_SAMPLES_PER_PHASE 4   /** Samples averaged once the LDR has settled */
+#define LOCKIN_CYCLES 1              /** Red/green/dark modulation cycles per measurement */
+#define LOCKIN_SETTLE_TOLERANCE 2    /** Max. change between two 1 ms samples of a settled LDR */
+#define LOCKIN_SETTLE_TIMEOUT_MS 20  /** Give up waiting for the LDR after this time */
+
+// Result of one lock-in measurement
+typedef struct
+{
+    uint16_t red;       /** Red LED contribution: red-lit average - ambient, clamped at 0 */
+    uint16_t green;     /** Green LED contribution: green-lit average - ambient, clamped at 0 */
+    uint16_t ambient;   /** Average LDR value with both LEDs off */
+    uint16_t latencyMs; /** Time from the start of the measurement to the result */
+} LockInResult;
+
+/**
+ * @brief Initializes the lock-in acquisition.
+ *
+ * This function starts the millisecond timer and registers the acquisition state machine
+ * as its tick callback. initLEDs() and initADC() must have been called before.
+ */
+void initLockIn(void);
+
+/**
+ * @brief Polls the lock-in acquisition.
+ *
+ * Starts a new measurement if none is running and returns the result once it is complete.
+ * While a measurement runs, the acquisition owns the ADC and the LEDs; readADC() must not
+ * be called until lockInStop().
+ *
+ * @param result Pointer to the structure the finished measurement is copied to.
+ * @return 1 if a new result was stored in `result`, 0 if the measurement is still running.
+ */
+uint8_t lockInPoll(LockInResult *result);
+
+/**
+ * @brief Aborts a running measurement and switches the LEDs off.
+ */
+void lockInStop(void);
+
+#endif /* LDRLOCKIN_H_ */
@@ -0,0 +1,146 @@
+/**
+ * @file    MessageBuilder.c
+ * @brief   Append-only builder for console messages.
+ *
+ * This file contains the implementation of the message builder. All appends write directly
+ * to the final buffer or sink, there are no intermediate copies. Numbers are converted
+ * digit by digit by subtracting powers of ten, which is cheaper on the MSP430G2553 than a
+ * software division per digit.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+
+#include "MessageBuilder.h"
+
+#define MAX_DIGITS 5 /**< Digits of the largest 16-bit number */
+
+static const uint16_t powersOfTen[MAX_DIGITS] = {10000, 1000, 100, 10, 1};
+
+/**
+ * @brief Starts a message in a buffer.
+ *
+ * @param builder Pointer to the builder.
+ * @param buffer Pointer to the buffer the message is written to.
+ * @param size Size of the buffer including the terminator, at least 1.
+ */
+void messageInit(MessageBuilder *builder, char *buffer, uint8_t size)
+{
+    builder->buffer = buffer;
+    builder->sink = 0;
+    builder->size = size;
+    builder->length = 0;
+    buffer[0] = '\0';
+}
+
+/**
+ * @brief Starts a message that is streamed to a character sink.
+ *
+ * @param builder Pointer to the builder.
+ * @param sink Function receiving every appended character.
+ */
+void messageInitSink(MessageBuilder *builder, MessageSink sink)
+{
+    builder->buffer = 0;
+    builder->sink = sink;
+    builder->size = 0;
+    builder->length = 0;
+}
+
+/**
+ * @brief Appends a single character.
+ *
+ * @param builder Pointer to the builder.
+ * @param c The character to append.
+ */
+void messageAppendChar(MessageBuilder *builder, char c)
+{
+    if (builder->buffer == 0)
+    {
+        builder->sink(c);
+        builder->length++;
+    }
+    else if (builder->length + 1 < builder->size)
+    {
+        builder->buffer[builder->length++] = c;
+        builder->buffer[builder->length] = '\0';
+    }
+}
+
+/**
+ * @brief Appends a null-terminated string.
+ *
+ * @param builder Pointer to the builder.
+ * @param text Pointer to the string to append.
+ */
+void messageAppendText(MessageBuilder *builder, const char *text)
+{
+    while (*text)
+    {
+        messageAppendChar(builder, *text++);
+    }
+}
+
+/**
+ * @brief Appends an unsigned number, right-aligned with spaces.
+ *
+ * @param builder Pointer to the builder.
+ * @param value The number to append.
+ * @param width Minimum number of characters; longer numbers are not cut.
+ */
+void messageAppendUint(MessageBuilder *builder, uint16_t value, uint8_t width)
+{
+    uint8_t first = 0;
+    uint8_t i;
+    char digit;
+
+    // Skip the leading zeros, the last digit is always printed
+    while (first < MAX_DIGITS - 1 && value < powersOfTen[first])
+    {
+        first++;
+    }
+
+    while (width > MAX_DIGITS - first)
+    {
+        messageAppendChar(builder, ' ');
+        width--;
+    }
+
+    for (i = first; i < MAX_DIGITS; i++)
+    {
+        digit = '0';
+        while (value >= powersOfTen[i])
+        {
+            value -= powersOfTen[i];
+            digit++;
+        }
+        messageAppendChar(builder, digit);
+    }
+}
+
+/**
+ * @brief Appends a right-aligned number followed by a percent sign.
+ *
+ * @param builder Pointer to the builder.
+ * @param value The percentage to append.
+ * @param width Minimum number of characters of the number.
+ */
+void messageAppendPercent(MessageBuilder *builder, uint16_t value, uint8_t width)
+{
+    messageAppendUint(builder, value, width);
+    messageAppendChar(builder, '%');
+}
+
+/**
+ * @brief Returns the number of characters appended so far.
+ *
+ * @param builder Pointer to the builder.
+ * @return The message length.
+ */
+uint8_t messageLength(const MessageBuilder *builder)
+{
+    return builder->length;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file    MessageBuilder.h
+ * @brief   Header file for MessageBuilder.c
+ *
+ * This file contains declarations of an append-only builder for console messages. The
+ * builder writes straight into one caller-provided buffer or, without a buffer, straight
+ * to a character sink such as the UART. Numbers are converted by repeated subtraction, so
+ * neither the libc formatting functions nor a software division are needed.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ */
+
+#ifndef MESSAGEBUILDER_H_
+#define MESSAGEBUILDER_H_
+
+#include <stdint.h>
+
+// Function receiving every character of a streamed message
+typedef void (*MessageSink)(char c);
+
+// State of one message being built
+typedef struct
+{
+    char *buffer;     /** Target buffer, or 0 to stream to the sink */
+    MessageSink sink; /** Character sink used without a buffer */
+    uint8_t size;     /** Size of the buffer including the terminator */
+    uint8_t length;   /** Characters appended so far */
+} MessageBuilder;
+
+/**
+ * @brief Starts a message in a buffer.
+ *
+ * The buffer is always kept null-terminated. Characters that do not fit are dropped.
+ *
+ * @param builder Pointer to the builder.
+ * @param buffer Pointer to the buffer the message is written to.
+ * @param size Size of the buffer including the terminator, at least 1.
+ */
+void messageInit(MessageBuilder *builder, char *buffer, uint8_t size);
+
+/**
+ * @brief Starts a message that is streamed to a character sink.
+ *
+ * @param builder Pointer to the builder.
+ * @param sink Function receiving every appended character.
+ */
+void messageInitSink(MessageBuilder *builder, MessageSink sink);
+
+/**
+ * @brief Appends a single character.
+ *
+ * @param builder Pointer to the builder.
+ * @param c The character to append.
+ */
+void messageAppendChar(MessageBuilder *builder, char c);
+
+/**
+ * @brief Appends a null-terminated string.
+ *
+ * @param builder Pointer to the builder.
+ * @param text Pointer to the string to append.
+ */
+void messageAppendText(MessageBuilder *builder, const char *text);
+
+/**
+ * @brief Appends an unsigned number, right-aligned with spaces.
+ *
+ * @param builder Pointer to the builder.
+ * @param value The number to append.
+ * @param width Minimum number of characters; longer numbers are not cut.
+ */
+void messageAppendUint(MessageBuilder *builder, uint16_t value, uint8_t width);
+
+/**
+ * @brief Appends a right-aligned number followed by a percent sign.
+ *
+ * @param builder Pointer to the builder.
+ * @param value The percentage to append.
+ * @param width Minimum number of characters of the number.
+ */
+void messageAppendPercent(MessageBuilder *builder, uint16_t value, uint8_t width);
+
+/**
+ * @brief Returns the number of characters appended so far.
+ *
+ * In buffer mode this is the length of the stored string.
+ *
+ * @param builder Pointer to the builder.
+ * @return The message length.
+ */
+uint8_t messageLength(const MessageBuilder *builder);
+
+#endif /* MESSAGEBUILDER_H_ */
@@ -13,12 +13,13 @@
 
 #include <stdint.h>
 #include <string.h>
-#include <stdio.h>
 
+#include "Hardware.h"
+#include "MessageBuilder.h"
 #include "StringDisplay.h"
 
-#define CHAR_ARRAY_LENGTH 5
-#define NUM_SPACES_TO_PAD 4
+#define LINE_LENGTH 25 // Longest ADC line plus terminator
+#define NUMBER_WIDTH 4 // Numbers are right-aligned to four digits
 
 #define GAGE_VALUE_1111 " 1111"
 #define GAGE_VALUE_1110 " 1110"
@@ -26,9 +27,12 @@
 #define GAGE_VALUE_1000 " 1000"
 #define GAGE_VALUE_0000 " 0000"
 
+#define ANSI_CLEAR_LINE "\x1b[2K" // Erases the whole line, the cursor stays in place
+#define ANSI_REFRESH_LENGTH 5      // Carriage return plus ANSI_CLEAR_LINE
+
 #define ZERO 0
 #define ONE 1
-#define TWENTY_FIVE 25
+#define TWO 2
 
 #define ONE_HUNDRED 100
 #define TWO_HUNDRED 200
@@ -41,171 +45,309 @@
 #define NINE_HUNDRED 900
 #define ONE_THOUSAND 1000
 
-void convertToGage(uint16_t value, char *gageStr);
-void convertToCapColour(uint16_t value, char *colourStr);
+#define PERCENT_MULTIPLIER 205 // 205 / 2^11 approximates 1 / 10
+#define PERCENT_SHIFT 11
+
+// Display text of all values up to an upper limit
+typedef struct
+{
+    uint16_t upperLimit;
+    const char *text;
+} DisplayBand;
+
+// Gage bands, a value above 1000 is out of range
+static const DisplayBand gageBands[] = {
+    {TWO_HUNDRED, GAGE_VALUE_0000},
+    {FOUR_HUNDRED, GAGE_VALUE_1000},
+    {SIX_HUNDRED, GAGE_VALUE_1100},
+    {EIGHT_HUNDRED, GAGE_VALUE_1110},
+    {ONE_THOUSAND, GAGE_VALUE_1111}
+};
+
+// Cap colour bands, a value above 1000 is out of range
+static const DisplayBand capColourBands[] = {
+    {ONE_HUNDRED, "Black"},
+    {TWO_HUNDRED, "White"},
+    {ONE_THOUSAND, "None"}
+};
+
+const char *convertToGage(uint16_t value);
+const char *convertToCapColour(uint16_t value);
 
 uint16_t clampToMax(uint16_t value, uint16_t maxValue);
 uint16_t convertToPercentage(uint16_t value);
 
+// Defined by templateEMP.h in main.c
+extern void serialWrite(char tx);
+extern void serialPrint(char *tx);
+extern void serialPrintln(char *tx);
+
+static uint16_t reportDelta = REPORT_DEFAULT_DELTA;              /**< Change printed immediately */
+static uint16_t reportHeartbeatMs = REPORT_DEFAULT_HEARTBEAT_MS; /**< Longest silence per mode */
+static uint16_t lastReportValue[NUM_PRINT_MODES];                /**< Last printed value per mode */
+static uint16_t lastReportTick[NUM_PRINT_MODES];                 /**< Time of the last print per mode */
+static uint8_t lastReportLength[NUM_PRINT_MODES];                /**< Length of the last printed line per mode */
+static uint8_t lastReportMode = NUM_PRINT_MODES;                 /**< Mode of the open report line */
+static uint8_t reportLineOpen = ZERO;                            /**< 1 while the cursor is behind a report */
+static ReportStatistics reportStatistics;                        /**< Printed and suppressed output */
+
 /**
- * @brief Prints ADC values based on the specified mode.
- *
- * This function formats and prints ADC values according to the specified mode.
- * It converts the ADC value to different formats based on the mode.
+ * @brief Formats an ADC value based on the specified mode.
  *
  * @param mode The mode indicating how to format the ADC value.
- * @param value The ADC value to be printed.
+ * @param value The ADC value to be formatted.
+ * @param message Pointer to the started message the line is appended to.
+ * @return The length of the message, or 0 for an unknown mode.
  */
-void printAdcValues(uint8_t mode, uint16_t value)
+static uint8_t formatAdcValues(uint8_t mode, uint16_t value, MessageBuilder *message)
 {
-    char temp[TWENTY_FIVE];
-    char tempNumericStrn[TWENTY_FIVE]; // Array to store right-aligned print value
-    char tempDisplayStrn[TWENTY_FIVE]; // Array to store right-aligned display value
     uint16_t numericValue = clampToMax(value, ONE_THOUSAND);
-    uint16_t percentValue = convertToPercentage(numericValue);
+
+    if (mode >= NUM_PRINT_MODES)
+    {
+        return ZERO;
+    }
+
+    // Right-align numerical print value
+    messageAppendText(message, "ADC: ");
+    messageAppendUint(message, numericValue, NUMBER_WIDTH);
+    messageAppendText(message, " --> ");
 
     switch (mode)
     {
     case MODE_A:
-        // Right-align numerical print value
-        rightAlignIntToCharArray(numericValue, tempNumericStrn);
-        // Right-align graphical display value
-        rightAlignIntToCharArray(percentValue, tempDisplayStrn);
-        // Format the string
-        sprintf(temp, "ADC: %s --> %s%%", tempNumericStrn, tempDisplayStrn);
-        // Print the formatted string
-        serialPrintln(temp);
+        // Right-align percentage display value
+        messageAppendPercent(message, convertToPercentage(numericValue), NUMBER_WIDTH);
         break;
     case MODE_B:
-        // Right-align print value
-        rightAlignIntToCharArray(numericValue, tempNumericStrn);
-        // Format the gauge display
-        convertToGage(numericValue, tempDisplayStrn);
-        // Format the string
-        sprintf(temp, "ADC: %s --> %s", tempNumericStrn, tempDisplayStrn);
-        // Print the formatted string
-        serialPrintln(temp);
-        break;
-    case MODE_C:
-        // Right-align print value
-        rightAlignIntToCharArray(numericValue, tempNumericStrn);
-        // Format the capacitor color display
-        convertToCapColour(numericValue, tempDisplayStrn);
-        // Format the string
-        sprintf(temp, "ADC: %s --> %s", tempNumericStrn, tempDisplayStrn);
-        // Print the formatted string
-        serialPrintln(temp);
+        // Gauge display
+        messageAppendText(message, convertToGage(numericValue));
         break;
     default:
+        // Capacitor color display
+        messageAppendText(message, convertToCapColour(numericValue));
         break;
     }
+
+    return messageLength(message);
+}
+
+/**
+ * @brief Ends the line the reporter refreshes in place.
+ *
+ * Output printed afterwards starts on a new line instead of behind the reported value, and
+ * the next report starts a new line of its own.
+ */
+void endReportLine(void)
+{
+    if (reportLineOpen)
+    {
+        serialPrint("\r\n");
+        reportLineOpen = ZERO;
+    }
+    lastReportMode = NUM_PRINT_MODES;
 }
 
 /**
- * @brief Converts an integer to a right-aligned character array.
+ * @brief Prints ADC values based on the specified mode.
  *
- * This function converts the given integer to a string and right-aligns it within
- * the provided character array, padding with spaces as needed.
+ * This function formats and prints ADC values according to the specified mode.
+ * It converts the ADC value to different formats based on the mode.
  *
- * @param num The integer to convert.
- * @param charArray Pointer to the character array where the result will be stored.
+ * @param mode The mode indicating how to format the ADC value.
+ * @param value The ADC value to be printed.
  */
-void rightAlignIntToCharArray(uint16_t num, char *charArray)
+void printAdcValues(uint8_t mode, uint16_t value)
 {
-    // Convert integer to string
-    char numStr[CHAR_ARRAY_LENGTH]; // Need space for the null terminator
-    snprintf(numStr, sizeof(numStr), "%d", num);
+    char temp[LINE_LENGTH];
+    MessageBuilder message;
 
-    // Get the length of the integer string
-    uint16_t numStrLen = strlen(numStr);
+    messageInit(&message, temp, sizeof(temp));
+    if (formatAdcValues(mode, value, &message))
+    {
+        endReportLine();
+        // Print the formatted string
+        serialPrintln(temp);
+    }
+}
+
+/**
+ * @brief Sets when the reporter prints an unchanged value again.
+ *
+ * @param delta Minimum change of the value that is printed immediately.
+ * @param heartbeatMs Maximum time between two prints of the same mode.
+ */
+void setReportPolicy(uint16_t delta, uint16_t heartbeatMs)
+{
+    reportDelta = delta;
+    reportHeartbeatMs = heartbeatMs;
+}
 
-    // Calculate the number of spaces to add before the integer
-    uint16_t numSpaces = NUM_SPACES_TO_PAD - numStrLen;
+/**
+ * @brief Prints an ADC value only if it has changed noticeably.
+ *
+ * @param mode The mode indicating how to format the ADC value.
+ * @param value The ADC value to be reported.
+ * @param force 1 to print regardless of the value, e.g. when the displayed band changed.
+ * @return 1 if the line was printed, 0 if it was suppressed.
+ */
+uint8_t reportAdcValues(uint8_t mode, uint16_t value, uint8_t force)
+{
+    char temp[LINE_LENGTH];
+    MessageBuilder message;
+    uint16_t now = getTickCount();
+    uint16_t change;
+    uint8_t length;
 
-    // Fill the character array with spaces followed by the integer string
-    uint16_t i = ZERO;
-    while (i < numSpaces)
+    if (mode >= NUM_PRINT_MODES)
     {
-        charArray[i++] = ' '; // Add spaces
+        return ZERO;
     }
 
-    uint16_t j = ZERO;
-    while (j < numStrLen)
+    change = (value > lastReportValue[mode]) ? value - lastReportValue[mode] : lastReportValue[mode] - value;
+
+    if (!force && mode == lastReportMode && change <= reportDelta &&
+        (uint16_t)(now - lastReportTick[mode]) < reportHeartbeatMs)
     {
-        charArray[i++] = numStr[j++]; // Add integer characters
+        // The old code would have sent the whole line followed by CR LF; the line is not
+        // formatted just to count it, a value within the delta has the length of the last
+        reportStatistics.linesSaved++;
+        reportStatistics.bytesSaved += lastReportLength[mode] + TWO;
+        return ZERO;
     }
 
-    // Add null terminator
-    charArray[CHAR_ARRAY_LENGTH - ONE] = '\0';
+    messageInit(&message, temp, sizeof(temp));
+    length = formatAdcValues(mode, value, &message);
+
+    // Return to the start of the line and clear it, so the value is refreshed in place
+    serialPrint("\r" ANSI_CLEAR_LINE);
+    serialPrint(temp);
+    reportLineOpen = ONE;
+
+    lastReportMode = mode;
+    lastReportValue[mode] = value;
+    lastReportTick[mode] = now;
+    lastReportLength[mode] = length;
+
+    reportStatistics.linesSent++;
+    reportStatistics.bytesSent += length + ANSI_REFRESH_LENGTH;
+
+    return ONE;
+}
+
+/**
+ * @brief Copies the reporter statistics.
+ *
+ * @param statistics Pointer to the structure the statistics are copied to.
+ */
+void getReportStatistics(ReportStatistics *statistics)
+{
+    *statistics = reportStatistics;
+}
+
+/**
+ * @brief Prints the reporter statistics as lines and bytes saved per second.
+ *
+ * @param elapsedMs The time the statistics were collected over.
+ */
+void printReportStatistics(uint16_t elapsedMs)
+{
+    MessageBuilder message;
+    uint16_t seconds = (elapsedMs < ONE_THOUSAND) ? ONE : elapsedMs / ONE_THOUSAND;
+    uint32_t bytesSaved = reportStatistics.bytesSaved / seconds;
+
+    endReportLine();
+    messageInitSink(&message, serialWrite);
+    messageAppendText(&message, "Sent ");
+    messageAppendUint(&message, reportStatistics.linesSent / seconds, ZERO);
+    messageAppendText(&message, "/s, saved ");
+    messageAppendUint(&message, reportStatistics.linesSaved / seconds, ZERO);
+    messageAppendText(&message, " lines/s ");
+    messageAppendUint(&message, (bytesSaved > UINT16_MAX) ? UINT16_MAX : bytesSaved, ZERO);
+    messageAppendText(&message, " B/s\r\n");
+}
+
+/**
+ * @brief Clears the reporter statistics.
+ */
+void resetReportStatistics(void)
+{
+    memset(&reportStatistics, ZERO, sizeof(reportStatistics));
+}
+
+/**
+ * @brief Prints the red and green intensities of a chip together with its colour.
+ *
+ * @param red The LDR response under red light.
+ * @param green The LDR response under green light.
+ * @param colour The name of the detected chip colour.
+ */
+void printChipValues(uint16_t red, uint16_t green, const char *colour)
+{
+    MessageBuilder message;
+
+    endReportLine();
+
+    // Stream the line straight to the UART, both intensities right-aligned
+    messageInitSink(&message, serialWrite);
+    messageAppendText(&message, "R: ");
+    messageAppendUint(&message, clampToMax(red, ONE_THOUSAND), NUMBER_WIDTH);
+    messageAppendText(&message, " G: ");
+    messageAppendUint(&message, clampToMax(green, ONE_THOUSAND), NUMBER_WIDTH);
+    messageAppendText(&message, " --> ");
+    messageAppendText(&message, colour);
+    messageAppendText(&message, "\r\n");
+}
+
+/**
+ * @brief Looks up the text of the band a value lies in.
+ *
+ * @param bands Pointer to the bands, sorted by ascending upper limit.
+ * @param count Number of bands.
+ * @param value The value to look up.
+ * @param outOfRange Text returned for values above the last band.
+ * @return Pointer to the constant text of the band.
+ */
+static const char *lookupBand(const DisplayBand *bands, uint8_t count, uint16_t value, const char *outOfRange)
+{
+    uint8_t i;
+
+    for (i = ZERO; i < count; i++)
+    {
+        if (value <= bands[i].upperLimit)
+        {
+            return bands[i].text;
+        }
+    }
+    return outOfRange;
 }
 
 /**
  * @brief Converts an ADC value to a graphical representation (gage).
  *
  * This function converts the given ADC value to a graphical representation (gage)
- * based on predefined thresholds. It assigns a binary representation to the `gageStr`
- * parameter based on the value range.
+ * based on predefined thresholds in `gageBands`.
  *
  * @param value The ADC value to convert.
- * @param gageStr Pointer to the character array where the gage representation will be stored.
+ * @return Pointer to the constant gage representation, empty for out-of-range values.
  */
-void convertToGage(uint16_t value, char *gageStr)
+const char *convertToGage(uint16_t value)
 {
-    // Check the value range and assign the corresponding binary representation
-    if (value > EIGHT_HUNDRED && value <= ONE_THOUSAND)
-    {
-        strcpy(gageStr, GAGE_VALUE_1111); // Set gageStr to 1111
-    }
-    else if (value > SIX_HUNDRED && value <= EIGHT_HUNDRED)
-    {
-        strcpy(gageStr, GAGE_VALUE_1110); // Set gageStr to 1110
-    }
-    else if (value > FOUR_HUNDRED && value <= SIX_HUNDRED)
-    {
-        strcpy(gageStr, GAGE_VALUE_1100); // Set gageStr to 1100
-    }
-    else if (value > TWO_HUNDRED && value <= FOUR_HUNDRED)
-    {
-        strcpy(gageStr, GAGE_VALUE_1000); // Set gageStr to 1000
-    }
-    else if (value >= ZERO && value <= TWO_HUNDRED)
-    {
-        strcpy(gageStr, GAGE_VALUE_0000); // Set gageStr to 0000
-    }
-    else
-    {
-        // Handle out-of-range values
-        strcpy(gageStr, ""); // Empty string
-    }
+    return lookupBand(gageBands, sizeof(gageBands) / sizeof(gageBands[ZERO]), value, "");
 }
 
 /**
  * @brief Converts an ADC value to a cap colour.
  *
- * This function converts the given ADC value to a cap colour based on predefined thresholds.
- * It assigns a colour string to the `colourStr` parameter based on the value range.
+ * This function converts the given ADC value to a cap colour based on predefined thresholds
+ * in `capColourBands`.
  *
  * @param value The ADC value to convert.
- * @param colourStr Pointer to the character array where the cap colour will be stored.
+ * @return Pointer to the constant colour name, "ERROR" for out-of-range values.
  */
-void convertToCapColour(uint16_t value, char *colourStr)
+const char *convertToCapColour(uint16_t value)
 {
-    if (value > TWO_HUNDRED && value <= ONE_THOUSAND)
-    {
-        strcpy(colourStr, "None"); // No cap
-    }
-    else if (value > ONE_HUNDRED && value <= TWO_HUNDRED)
-    {
-        strcpy(colourStr, "White"); // White cap
-    }
-    else if (value >= ZERO && value <= ONE_HUNDRED)
-    {
-        strcpy(colourStr, "Black"); // Black cap
-    }
-    else // Error
-    {
-        strcpy(colourStr, "ERROR");
-    }
+    return lookupBand(capColourBands, sizeof(capColourBands) / sizeof(capColourBands[ZERO]), value, "ERROR");
 }
 
 /**
@@ -230,11 +372,14 @@ uint16_t clampToMax(uint16_t value, uint16_t maxValue)
  * @brief Converts a value to a percentage.
  *
  * This function converts the given value to a percentage based on a maximum value of 1000.
+ * The multiply-shift (value * 205) >> 11 equals value / 10 for all ADC values 0..1023,
+ * so neither software floating point nor a software division is needed.
  *
  * @param value The value to convert to a percentage.
  * @return The percentage value of the given value, scaled to a maximum of 100.
  */
 uint16_t convertToPercentage(uint16_t value)
 {
-    return (uint16_t)(((double)value / (double)ONE_THOUSAND) * (double)ONE_HUNDRED); // Convert value to percentage
+    // value * 100 / 1000 = value / 10, computed as a multiply-shift without a division
+    return (uint16_t)(((uint32_t)value * PERCENT_MULTIPLIER) >> PERCENT_SHIFT);
 }
\ No newline at end of file
@@ -12,14 +12,29 @@
 #ifndef STRINGDISPLAY_H_
 #define STRINGDISPLAY_H_
 
+#include <stdint.h>
+
+#define REPORT_DEFAULT_DELTA 5           /** Change of an ADC value that is reported immediately */
+#define REPORT_DEFAULT_HEARTBEAT_MS 1000 /** An unchanged value is reported again after this time */
+
 // Enum for printing modes
 typedef enum
 {
     MODE_A, // Left-aligned percentage display
     MODE_B, // Gage display
-    MODE_C  // Cap type display
+    MODE_C, // Cap type display
+    NUM_PRINT_MODES
 } PRINT_MODE;
 
+// Output counters of the change-detecting reporter
+typedef struct
+{
+    uint16_t linesSent;  /** Lines printed by reportAdcValues() */
+    uint16_t linesSaved; /** Lines suppressed because the value did not change */
+    uint32_t bytesSent;  /** Bytes printed, including the in-place refresh sequence */
+    uint32_t bytesSaved; /** Bytes the suppressed lines would have cost */
+} ReportStatistics;
+
 /**
  * @brief Prints ADC values based on the specified mode.
  *
@@ -31,4 +46,65 @@ typedef enum
  */
 void printAdcValues(uint8_t mode, uint16_t value);
 
+/**
+ * @brief Sets when the reporter prints an unchanged value again.
+ *
+ * @param delta Minimum change of the value that is printed immediately.
+ * @param heartbeatMs Maximum time between two prints of the same mode.
+ */
+void setReportPolicy(uint16_t delta, uint16_t heartbeatMs);
+
+/**
+ * @brief Prints an ADC value only if it has changed noticeably.
+ *
+ * The value is printed if it differs from the last printed value of the mode by more than
+ * the delta, if the heartbeat period has passed, if the mode has changed or if `force` is
+ * set. The line is refreshed in place with a carriage return and an ANSI erase-line
+ * sequence instead of scrolling the console. The heartbeat needs the millisecond timer.
+ *
+ * @param mode The mode indicating how to format the ADC value.
+ * @param value The ADC value to be reported.
+ * @param force 1 to print regardless of the value, e.g. when the displayed band changed.
+ * @return 1 if the line was printed, 0 if it was suppressed.
+ */
+uint8_t reportAdcValues(uint8_t mode, uint16_t value, uint8_t force);
+
+/**
+ * @brief Ends the line the reporter refreshes in place.
+ *
+ * Must be called before printing other output with serialPrint(), so it does not end up
+ * behind the reported value. The print functions of this file call it themselves.
+ */
+void endReportLine(void);
+
+/**
+ * @brief Copies the reporter statistics.
+ *
+ * @param statistics Pointer to the structure the statistics are copied to.
+ */
+void getReportStatistics(ReportStatistics *statistics);
+
+/**
+ * @brief Prints the reporter statistics as lines and bytes saved per second.
+ *
+ * @param elapsedMs The time the statistics were collected over.
+ */
+void printReportStatistics(uint16_t elapsedMs);
+
+/**
+ * @brief Clears the reporter statistics.
+ */
+void resetReportStatistics(void);
+
+/**
+ * @brief Prints the red and green intensities of a chip together with its colour.
+ *
+ * Both intensities are printed as right-aligned four-digit numbers.
+ *
+ * @param red The LDR response under red light.
+ * @param green The LDR response under green light.
+ * @param colour The name of the detected chip colour.
+ */
+void printChipValues(uint16_t red, uint16_t green, const char *colour);
+
 #endif /* STRINGDISPLAY_H_ */
@@ -23,6 +23,8 @@
  * (either "White", "Black", or "No chip") formatted with four-digit numbers, right-aligned, to the computer via the
  * serial interface. Note: The LDR requires a few milliseconds to adjust to abrupt changes in light values.
  *
+ * Serial console: type "help" for the commands, e.g. "stats", "report 5 2000" or "calibrate".
+ *
  * @date    25.05.2024
  * @author  Bjoern Metzger & Daniel Korobow
  * @version 1.0
@@ -34,42 +36,256 @@
 
 #include "Hardware.h"
 #include "StringDisplay.h"
+#include "AdcWindow.h"
+#include "LdrLockIn.h"
+#include "ChipClassifier.h"
+#include "Console.h"
+
+#define POTENTIOMETER_FILTER_SHIFT 3 /** Exponential smoothing alpha of 1/8 for the potentiometer */
+#define GAGE_HYSTERESIS 8            /** Hysteresis around the gauge thresholds */
+#define PERCENT_STEP 10              /** ADC counts per displayed percent */
+#define PERCENT_HYSTERESIS 3         /** Hysteresis around each percent step */
+#define REPORT_DELTA 5               /** Potentiometer change that is printed immediately */
+#define REPORT_HEARTBEAT_MS 2000     /** An unchanged value is printed again after this time */
+#define STATISTICS_PERIOD_MS 10000   /** Period of the reporter statistics (REPORT_STATISTICS) */
+
+// Band limits of convertToGage(), a value above a limit shows one more bar
+static const uint16_t gageThresholds[] = {200, 400, 600, 800};
+
+static uint16_t consoleStatisticsStart = 0; // Start of the statistics printed by "stats"
+
+static void statsCommand(uint8_t argc, char *argv[]);
+static void reportCommand(uint8_t argc, char *argv[]);
+static void calibrateCommand(uint8_t argc, char *argv[]);
+
+// Commands of the serial console, the hashes are printed by tools/console_hash.c
+static const ConsoleCommand consoleCommands[] = {
+    {"stats", 0xF0C4, statsCommand, "- prints and clears the reporter statistics"},
+    {"report", 0x148B, reportCommand, "<delta> <heartbeat ms> - sets the report policy"},
+    {"calibrate", 0x7E02, calibrateCommand, "- starts the chip calibration"}
+};
+
+/**
+ * @brief Prints the calibration instruction for a chip class.
+ *
+ * @param chipClass The chip class to be calibrated next.
+ */
+static void printCalibrationPrompt(uint8_t chipClass)
+{
+    endReportLine();
+    serialPrint("Calibration ");
+    serialPrint((char *)getChipClassName(chipClass));
+    serialPrintln(": set up the chip and hold PB6");
+}
+
+/**
+ * @brief Console command "stats": prints the reporter statistics since the last "stats".
+ *
+ * @param argc Number of words.
+ * @param argv The words, not used.
+ */
+static void statsCommand(uint8_t argc, char *argv[])
+{
+    uint16_t now = getTickCount();
+    uint16_t elapsed = now - consoleStatisticsStart;
+
+    printReportStatistics(elapsed ? elapsed : 1);
+    resetReportStatistics();
+    consoleStatisticsStart = now;
+}
+
+/**
+ * @brief Console command "report": sets the delta and heartbeat of the reporter.
+ *
+ * @param argc Number of words.
+ * @param argv The words; argv[1] is the delta, argv[2] the heartbeat in ms.
+ */
+static void reportCommand(uint8_t argc, char *argv[])
+{
+    int16_t delta;
+    int16_t heartbeat;
+
+    if (argc != 3 || consoleParseInt(argv[1], &delta) != 0 || consoleParseInt(argv[2], &heartbeat) != 0
+        || delta < 0 || heartbeat < 1)
+    {
+        serialPrintln("Usage: report <delta> <heartbeat ms>");
+        return;
+    }
+
+    setReportPolicy(delta, heartbeat);
+}
+
+/**
+ * @brief Console command "calibrate": starts the chip calibration like pressing both buttons.
+ *
+ * @param argc Number of words.
+ * @param argv The words, not used.
+ */
+static void calibrateCommand(uint8_t argc, char *argv[])
+{
+    if (!isChipCalibrationActive())
+    {
+        startChipCalibration();
+    }
+    printCalibrationPrompt(getChipCalibrationClass());
+}
+
+/**
+ * @brief Classifies a finished chip measurement or adds it to the running calibration.
+ *
+ * A classification is only printed when the chip class differs from the last one.
+ *
+ * @param measurement The finished lock-in measurement.
+ * @param lastChipClass Pointer to the last printed chip class, updated on a change.
+ * @return 1 if the button has to be released before the next measurement, 0 otherwise.
+ */
+static uint8_t processChipMeasurement(const LockInResult *measurement, uint8_t *lastChipClass)
+{
+    ChipFeatures features;
+    uint8_t chipClass;
+
+    features.red = measurement->red;
+    features.green = measurement->green;
+
+    if (!isChipCalibrationActive())
+    {
+        chipClass = classifyChip(&features);
+        if (chipClass != *lastChipClass)
+        {
+            printChipValues(features.red, features.green, getChipClassName(chipClass));
+            *lastChipClass = chipClass;
+        }
+        return 0;
+    }
+
+    switch (addChipCalibrationSample(&features))
+    {
+        case CALIBRATION_NEXT_CLASS:
+            printCalibrationPrompt(getChipCalibrationClass());
+            return 1; // Give the user time to change the chip
+        case CALIBRATION_DONE:
+            serialPrintln("Calibration stored");
+            return 1;
+        default:
+            return 0;
+    }
+}
 
 /**
  * @brief Main function of the program.
  *
  * This function initializes the microcontroller, LEDs, ADC, and buttons. It enters an infinite loop
  * where it reads ADC values and processes button presses. Depending on the pressed button, it prints
- * ADC values on the console in different modes.
+ * ADC values on the console in different modes. The potentiometer is watched by two ADC windows and
+ * the reporter refreshes a single console line only when the displayed percentage or gauge changes,
+ * the value moves by more than REPORT_DELTA, the mode changes or the heartbeat period has passed.
+ * Building with REPORT_STATISTICS defined prints the lines and bytes saved every 10 s.
+ * Pressing both buttons starts the chip calibration, which is then fed by holding PB6 once per chip
+ * class.
  *
  * @return This function does not return.
  */
 int main(void)
 {
-    uint16_t adcChannelValues[ADC_CHANNELS];
+    uint16_t adcChannelValues[ADC_CHANNELS] = {0};
+    LockInResult chipMeasurement;
+    uint8_t percentWindow;
+    uint8_t gageWindow;
+    uint8_t events;
+    uint8_t pressedButton;
+    uint8_t lastButton = 0xFF; // No mode yet
+    uint8_t lastChipClass = NUM_CHIP_CLASSES;
+    uint8_t waitForRelease = 0;
+#ifdef REPORT_STATISTICS
+    uint16_t statisticsStart;
+#endif
 
     initMSP();       // Initialize microcontroller
     initLEDs();      // Initialize LEDs
     initADC();       // Initialize ADC
     initButtons();   // Initialize buttons
+    initLockIn();    // Initialize the LED-modulated LDR acquisition
+    initChipClassifier(); // Load the chip centroids
+    initAdcWindow(); // Check every ADC frame in the ADC interrupt
+
+    percentWindow = adcWindowRegisterStep(CHANNEL_7, PERCENT_STEP, PERCENT_HYSTERESIS,
+                                          POTENTIOMETER_FILTER_SHIFT, 0);
+    gageWindow = adcWindowRegister(CHANNEL_7, gageThresholds, sizeof(gageThresholds) / sizeof(gageThresholds[0]),
+                                   GAGE_HYSTERESIS, POTENTIOMETER_FILTER_SHIFT, 0);
+    setReportPolicy(REPORT_DELTA, REPORT_HEARTBEAT_MS);
+    initConsole(consoleCommands, sizeof(consoleCommands) / sizeof(consoleCommands[0]));
+    consoleStatisticsStart = getTickCount();
+#ifdef REPORT_STATISTICS
+    statisticsStart = getTickCount();
+#endif
 
     while (1)
     {
-        readADC(adcChannelValues); // Read ADC values
+        // A typed command starts on a line of its own
+        if (serialAvailable() && !consoleLineActive())
+        {
+            endReportLine();
+        }
+        consolePoll();
+
+        pressedButton = getPressedButton();
 
-        // Process button presses
-        switch (getPressedButton())
+        if (pressedButton == BUTTON_BOTH && !isChipCalibrationActive())
+        {
+            startChipCalibration();
+            printCalibrationPrompt(getChipCalibrationClass());
+            waitForRelease = 1;
+        }
+
+        if (pressedButton != lastButton)
+        {
+            lastButton = pressedButton;
+            lastChipClass = NUM_CHIP_CLASSES;
+        }
+
+        events = adcWindowGetEvents();
+
+#ifdef REPORT_STATISTICS
+        if ((uint16_t)(getTickCount() - statisticsStart) >= STATISTICS_PERIOD_MS)
+        {
+            printReportStatistics(STATISTICS_PERIOD_MS);
+            resetReportStatistics();
+            statisticsStart += STATISTICS_PERIOD_MS;
+        }
+#endif
+
+        if (pressedButton == BUTTON_2 && !waitForRelease)
+        {
+            // The lock-in acquisition owns the ADC and LEDs until it is stopped
+            if (lockInPoll(&chipMeasurement))
+            {
+                waitForRelease = processChipMeasurement(&chipMeasurement, &lastChipClass);
+            }
+            continue;
+        }
+
+        if (pressedButton == BUTTON_NONE)
+        {
+            waitForRelease = 0;
+        }
+
+        lockInStop();
+        readADC(adcChannelValues); // Start the next frame, the windows check it in the ADC interrupt
+
+        // The reporter pauses while a command is typed, so the echo is not overwritten
+        if (consoleLineActive())
+        {
+            continue;
+        }
+
+        // The reporter skips the line unless the displayed value of the active mode changes
+        switch (pressedButton)
         {
-            case BUTTON_2:
-                setLEDState(LED_ON);
-                printAdcValues(MODE_C, adcChannelValues[CHANNEL_6]);
-                setLEDState(LED_OFF);
-                break;
             case BUTTON_1:
-                printAdcValues(MODE_B, adcChannelValues[CHANNEL_7]);
+                reportAdcValues(MODE_B, adcWindowGetValue(gageWindow), events & (1 << gageWindow));
                 break;
             case BUTTON_NONE:
-                printAdcValues(MODE_A, adcChannelValues[CHANNEL_7]);
+                reportAdcValues(MODE_A, adcWindowGetValue(percentWindow), events & (1 << percentWindow));
                 break;
             default:
                 break;
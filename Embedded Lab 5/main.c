@@ -12,7 +12,7 @@
  *   - Connect CON6:I2C_/SPI to CON2:3V3
  *   - Connect CON6:XSDA to CON2:P1.7
  *   - Connect CON6:XSCL to CON2:P1.6
- * Connect X1:Buzzer to CON3:P1.4 on the main board.
+ * Connect X1:Buzzer to CON3:P2.1 on the main board (CON3:P1.4 if NOTE_PLAYER_SOFTWARE_PWM is defined).
  *
  * How to operate:
  * 1. Ensure the connection between the expansion board and the experimentation board is secure.
@@ -21,10 +21,16 @@
  * 4. Follow the on-screen instructions or serial interface prompts to interact with the program.
  * 5. Use the joystick to select tones or navigate through the menu options.
  * 6. Press the joystick button to confirm selections or trigger specific actions.
+ *    Push the joystick up to play the stored melody.
  * 7. Follow any additional prompts or instructions displayed on the serial interface for advanced functionalities.
+ * 8. Type "help" in the terminal for the commands of the serial console, e.g. "play CDEFG", or "stream" followed by a melody in the format of Melody.h.
  * 
  * NOTE:
  * the ADC Needs to be read twice as the value returend is the value of the pervious conversion cycle stored in the register therfo to get an up to date reading the adc needs to be read twice.
+ * The joystick is therefore read in auto-increment mode: one transaction returns the stale value followed by fresh X, Y and Z values.
+ * This read runs in the background every 10 ms. Leave the joystick untouched for a moment after power-on, the first samples calibrate its centre.
+ * While the program waits for the joystick, the console or the end of a melody, the CPU sleeps in LPM0 and wakes once per system tick (Power.h).
+ * Deeper modes are not possible: the system tick and the sound are clocked by SMCLK (tools/power_modes.c).
  *
  * @date    25.05.2024
  * @author  Bjoern Metzger & Daniel Korobow
@@ -33,10 +39,48 @@
 
 
 
+// The USCI_B0 status interrupts share the vector with the UART, see usciRxISR()
+#define NO_TEMPLATE_ISR 1
 #include <templateEMP.h>
 
 #include "./userCode/inc/Notes.h"
+#include "./userCode/inc/SystemClock.h"
+#include "./userCode/inc/TwoWire.h"
 #include "./userCode/inc/UserInterFace.h"
+#include "./userCode/inc/Power.h"
+
+/**
+ * @brief USCI receive and I2C status interrupt service routine.
+ * 
+ * The UART receive interrupt of USCI_A0 and the I2C status interrupts of USCI_B0 share
+ * this vector. I2C status events are passed to the I2C driver, received UART bytes are
+ * stored in the serial buffer of templateEMP.h just like its own ISR does.
+ */
+#pragma vector = USCIAB0RX_VECTOR
+__interrupt void usciRxISR(void)
+{
+    // NACK or arbitration lost on the I2C bus
+    if (UCB0STAT & (UCNACKIFG | UCALIFG))
+    {
+        i2cStatusInterrupt();
+    }
+
+    if (IFG2 & UCA0RXIFG)
+    {
+        // Store the received byte in the serial ring buffer
+        rxBuffer[rxBufferEnd++] = UCA0RXBUF;
+        rxBufferEnd %= RXBUFFERSIZE;
+        // If enabled, print the received data back to user.
+        if (echoBack) {
+            while (!(IFG2&UCA0TXIFG));
+            UCA0TXBUF = UCA0RXBUF;
+        }
+        // Check for an overflow and set the corresponding variable.
+        if (rxBufferStart == rxBufferEnd) {
+            rxBufferError = 1;
+        }
+    }
+}
 
 /**
  * @brief The main function of the program.
@@ -49,8 +93,10 @@
  */
 int main(void)
 {
-    initMSP(); // Initialize microcontroller
-    initUi();  // Initialize user interface
+    initMSP();         // Initialize microcontroller
+    initSystemClock(); // Switch to SMCLK_FREQUENCY_HZ
+    initPower();       // Before the drivers claim their clocks
+    initUi();          // Initialize user interface
 
     while (1)
     {
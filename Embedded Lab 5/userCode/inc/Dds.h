@@ -0,0 +1,132 @@
+/**
+ * @file    Dds.h
+ * @brief   Header file for the wavetable synthesizer.
+ *
+ * This file contains declarations for playing notes by direct digital synthesis (DDS).
+ * Timer1_A runs undivided in up mode with a period of DDS_CARRIER_PERIOD clocks; the
+ * output unit of CCR1 drives P2.1 with a PWM carrier whose duty cycle is the current
+ * sample. The buzzer and the ear filter the carrier away and only the waveform remains.
+ *
+ * At the reset of every carrier period the CCR1 interrupt writes the duty cycle of the
+ * next period, adds the phase increment of the note to a 32-bit phase accumulator, reads
+ * the wavetable at the top eight bits of the phase and scales the sample with the
+ * envelope. The envelope (attack, decay, sustain, release) is advanced by the system
+ * tick every millisecond, so notes start and end without a click.
+ *
+ * Budget: a sample is due every DDS_CARRIER_PERIOD = 256 CPU cycles at any clock. The
+ * interrupt takes about DDS_ISR_CYCLES in the worst case (entry and exit, the dispatch
+ * from the TA1IV vector, the check for a missed compare, the 32-bit phase addition and
+ * the shift-and-add scaling, as the MSP430G2553 has no hardware multiplier), i.e. about
+ * half of the CPU at every clock while a note sounds. The new compare value is written
+ * about DDS_ISR_WRITE_CYCLES after the reset and applies to the next period. Longer
+ * delays by other interrupts (the system tick, I2C) make that period's pulse longer by
+ * the delay instead of a full period high. tools/lab5_dds.c simulates the timer with
+ * these figures, reports the slack of the compare writes and renders a WAV file.
+ *
+ * The sample rate follows the clock:
+ * - 1 MHz: 3906 Hz, notes up to 1953 Hz; the carrier itself is audible and the half of
+ *   the CPU that is left is 0.5 MIPS.
+ * - 8 MHz: 31250 Hz, all notes of the table.
+ * - 16 MHz: 62500 Hz, all notes of the table, the carrier is inaudible.
+ * NOTE_PLAYER_DDS therefore needs SMCLK_FREQUENCY_HZ of at least DDS_MIN_SMCLK_HZ
+ * (SystemClock.h); NotePlayer.c stops the build otherwise. Notes above half the sample
+ * rate are not played.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef DDS_H
+#define DDS_H
+
+#include <stdint.h>
+#include "Notes.h"
+#include "SystemClock.h"
+
+#define DDS_CARRIER_PERIOD 256 /**< Timer clocks per sample, the duty cycle is 8 bits */
+#define DDS_SAMPLE_RATE_HZ (SMCLK_FREQUENCY_HZ / DDS_CARRIER_PERIOD) /**< Samples per second */
+#define DDS_MIN_SMCLK_HZ 8000000UL /**< Lowest clock the note player may use the synthesizer at */
+#define DDS_ISR_CYCLES 125         /**< Worst-case cycles of the sample interrupt */
+#define DDS_ISR_WRITE_CYCLES 50    /**< Cycles from the reset to the write of the compare value */
+
+/**
+ * @brief Waveform of the synthesizer.
+ */
+typedef enum {
+    DDS_WAVE_SINE,     /**< Sine, the softest sound */
+    DDS_WAVE_TRIANGLE, /**< Triangle */
+    DDS_WAVE_SQUARE    /**< Square, like the plain PWM */
+} DDS_WAVE;
+
+/**
+ * @brief Envelope of a note.
+ */
+typedef struct {
+    uint16_t attackMs;    /**< Time from silence to full level */
+    uint16_t decayMs;     /**< Time from full level to the sustain level */
+    uint8_t sustainLevel; /**< Level while the note is held, in percent (0-100) */
+    uint16_t releaseMs;   /**< Time from full level to silence after the note has ended */
+} DdsEnvelope;
+
+/**
+ * @brief Initializes the synthesizer.
+ *
+ * This function selects the timer function of P2.1 and registers the envelope with the
+ * system tick. The default is a sine with a short attack and release. Timer1_A is shared
+ * with the PWM (SoftwarePwm.h) and the voices (Voices.h); only one of them can play at
+ * a time.
+ */
+extern void initDds();
+
+/**
+ * @brief Selects the waveform.
+ *
+ * @param wave The waveform, takes effect immediately.
+ */
+extern void ddsSetWave(DDS_WAVE wave);
+
+/**
+ * @brief Sets the envelope of the following notes.
+ *
+ * @param envelope The envelope; times of 0 change the level at once.
+ */
+extern void ddsSetEnvelope(const DdsEnvelope *envelope);
+
+/**
+ * @brief Starts a note.
+ *
+ * @param note The note; NOTE_REST and notes above half the sample rate end the note
+ *             that is playing.
+ *
+ * The attack starts from the current level, so a new note while the last one is still
+ * sounding continues without a click.
+ */
+extern void ddsNoteOn(NOTE note);
+
+/**
+ * @brief Ends the note; it fades out with the release time of the envelope.
+ */
+extern void ddsNoteOff();
+
+/**
+ * @brief Stops the synthesizer at once and drives P2.1 low.
+ */
+extern void ddsStop();
+
+/**
+ * @brief Checks whether the synthesizer is playing.
+ *
+ * @return Returns 1 while a note or its release sounds, 0 otherwise.
+ */
+extern uint8_t ddsIsPlaying();
+
+/**
+ * @brief Computes the next sample.
+ *
+ * The PWM and the synthesizer share the TIMER1_A1_VECTOR, so this function has to be
+ * called from its service routine for the CCR1 interrupt while the synthesizer plays.
+ */
+extern void ddsInterrupt(void);
+
+#endif /* DDS_H */
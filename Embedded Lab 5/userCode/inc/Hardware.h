@@ -3,6 +3,9 @@
  * @brief Header file for hardware-related functionalities.
  *
  * This file contains enumeration and function declarations related to hardware interactions.
+ * The joystick is sampled periodically in the background: the position is calibrated
+ * (auto-centre at power-on, learned travel per axis, radial dead zone) and turned into
+ * proportional output, a direction with auto-repeat and button edge events.
  *
  * @date    25.05.2024
  * @authors Bjoern Metzger & Daniel Korobow
@@ -12,6 +15,19 @@
 #ifndef HARDWARE_H
 #define HARDWARE_H
 
+#include <stdint.h>
+
+#define JOYSTICK_SAMPLE_PERIOD_MS 10    /**< Period of the background sampling */
+#define JOYSTICK_CENTRE_SAMPLES 16      /**< Samples averaged into the centre at power-on */
+#define JOYSTICK_FULL_SCALE 100         /**< Proportional output at full deflection */
+#define JOYSTICK_DEADZONE_RADIUS 30     /**< Radius of the dead zone in output units */
+#define JOYSTICK_REPEAT_DELAY_MS 400    /**< Time a direction is held before it repeats */
+#define JOYSTICK_REPEAT_START_MS 250    /**< First auto-repeat interval */
+#define JOYSTICK_REPEAT_MIN_MS 50       /**< Shortest auto-repeat interval */
+#define JOYSTICK_REPEAT_STEP_MS 25      /**< Interval reduction per repeat (acceleration) */
+#define JOYSTICK_HOLD_MS 1000           /**< Press duration that raises a held event */
+#define JOYSTICK_EVENT_QUEUE_LENGTH 8   /**< Events buffered for the application */
+
 // Enumeration for joystick direction
 typedef enum {
     JOYSTICK_UP,         /**< Joystick direction: Up */
@@ -29,29 +45,77 @@ typedef enum{
     JOYSTICK_RELEASED    /**< Joystick button state: Released */
 } JOYSTICK_BUTTON;
 
+/**
+ * @brief Enumeration for joystick events.
+ */
+typedef enum {
+    JOYSTICK_EVENT_MOVE,     /**< The stick entered a direction */
+    JOYSTICK_EVENT_REPEAT,   /**< Auto-repeat of a held direction */
+    JOYSTICK_EVENT_PRESSED,  /**< The button was pressed */
+    JOYSTICK_EVENT_RELEASED, /**< The button was released */
+    JOYSTICK_EVENT_HELD      /**< The button has been held for JOYSTICK_HOLD_MS */
+} JOYSTICK_EVENT_TYPE;
+
+/**
+ * @brief One joystick event.
+ */
+typedef struct {
+    uint8_t type;      /**< Kind of event (JOYSTICK_EVENT_TYPE) */
+    uint8_t direction; /**< Direction of move and repeat events (JOYSTICK_DIRECTION) */
+} JoystickEvent;
+
 /**
  * @brief Initializes the joystick hardware.
- * 
- * This function initializes the hardware components required for using the joystick.
+ *
+ * This function initializes the I2C interface and starts the background sampling. The
+ * first JOYSTICK_CENTRE_SAMPLES samples calibrate the centre, so the stick must not be
+ * touched right after power-on.
  */
 extern void initJoystick();
 
+/**
+ * @brief Takes the next joystick event from the queue.
+ *
+ * @param event Pointer to where the event is stored.
+ *
+ * @return Returns 1 if an event was stored, 0 if the queue is empty.
+ */
+extern uint8_t joystickGetEvent(JoystickEvent *event);
+
+/**
+ * @brief Returns the calibrated joystick position.
+ *
+ * @param x Pointer to the horizontal position, -JOYSTICK_FULL_SCALE (left) to
+ *          JOYSTICK_FULL_SCALE (right).
+ * @param y Pointer to the vertical position, -JOYSTICK_FULL_SCALE (down) to
+ *          JOYSTICK_FULL_SCALE (up).
+ *
+ * Both values are 0 inside the dead zone.
+ */
+extern void joystickGetPosition(int8_t *x, int8_t *y);
+
+/**
+ * @brief Checks whether the centre calibration has finished.
+ *
+ * @return Returns 1 once the centre is known, 0 before.
+ */
+extern uint8_t joystickIsCalibrated();
+
 /**
  * @brief Gets the current direction of the joystick.
- * 
+ *
  * @return The current direction of the joystick (JOYSTICK_DIRECTION).
- * 
- * This function reads the joystick input and returns the current direction.
+ *
+ * This function returns the direction of the last sample.
  */
 extern JOYSTICK_DIRECTION getJoystickDirection();
 
 /**
  * @brief Checks if the joystick button is pressed.
- * 
+ *
  * @return The state of the joystick button (JOYSTICK_BUTTON).
- * 
- * This function checks the state of the joystick button and returns whether
- * it is pressed or released.
+ *
+ * This function returns the debounced button state of the last sample.
  */
 extern JOYSTICK_BUTTON isJoystickPressed();
 
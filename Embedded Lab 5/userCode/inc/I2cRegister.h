@@ -0,0 +1,89 @@
+/**
+ * @file    I2cRegister.h
+ * @brief   Header file for register access to I2C devices.
+ *
+ * This file contains function declarations for reading and writing the registers of
+ * I2C devices, the common "register pointer + data" protocol of EEPROMs, sensors and
+ * converters. All functions build transactions for the interrupt-driven driver in
+ * TwoWire.c and block until they have ended.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef I2CREGISTER_H
+#define I2CREGISTER_H
+
+#include <stdint.h>
+#include "TwoWire.h"
+
+#define I2C_REG_MAX_BLOCK 16 /**< Largest block written by i2cWriteBlock() */
+
+/**
+ * @brief Writes one register.
+ * 
+ * @param addr The 7-bit address of the slave device.
+ * @param reg The register (or control byte) to write.
+ * @param value The value to write.
+ * 
+ * @return Returns 0 on success, or a negative error code (I2C_STATUS).
+ */
+extern int16_t i2cWriteReg(const uint8_t addr, const uint8_t reg, const uint8_t value);
+
+/**
+ * @brief Reads one register.
+ * 
+ * @param addr The 7-bit address of the slave device.
+ * @param reg The register (or control byte) to read.
+ * @param value Pointer to where the value is stored.
+ * 
+ * @return Returns 0 on success, or a negative error code (I2C_STATUS).
+ */
+extern int16_t i2cReadReg(const uint8_t addr, const uint8_t reg, uint8_t *value);
+
+/**
+ * @brief Writes consecutive registers in one transaction.
+ * 
+ * @param addr The 7-bit address of the slave device.
+ * @param reg The first register to write.
+ * @param data Pointer to the values to write.
+ * @param count Number of values, at most I2C_REG_MAX_BLOCK.
+ * 
+ * @return Returns 0 on success, or a negative error code (I2C_STATUS); I2C_ERROR_LENGTH
+ *         if the block is too long.
+ * 
+ * The device has to increment its register pointer after every byte.
+ */
+extern int16_t i2cWriteBlock(const uint8_t addr, const uint8_t reg, const uint8_t *data, const uint8_t count);
+
+/**
+ * @brief Reads consecutive registers in one transaction.
+ * 
+ * @param addr The 7-bit address of the slave device.
+ * @param reg The first register to read.
+ * @param data Pointer to the buffer for the values.
+ * @param count Number of values to read.
+ * 
+ * @return Returns 0 on success, or a negative error code (I2C_STATUS).
+ * 
+ * The register is written, then the values are read after a repeated start.
+ */
+extern int16_t i2cReadBlock(const uint8_t addr, const uint8_t reg, uint8_t *data, const uint8_t count);
+
+/**
+ * @brief Runs a list of transactions one after another.
+ * 
+ * @param transactions Pointer to the transactions; the address, buffers and counts must
+ *                     be set, callbacks are kept.
+ * @param count Number of transactions in the list.
+ * 
+ * @return Returns 0 if all transactions succeeded, otherwise the error of the first
+ *         failed transaction. The status of each transaction is kept in the list.
+ * 
+ * The transactions are queued as far as the driver queue allows, so the bus runs
+ * them back to back without waiting for the CPU in between.
+ */
+extern int16_t i2cRunList(I2cTransaction *transactions, const uint8_t count);
+
+#endif /* I2CREGISTER_H */
@@ -0,0 +1,108 @@
+/**
+ * @file    Melody.h
+ * @brief   Header file for the melody format and player.
+ *
+ * This file contains the byte format of melodies and the functions to play them with the
+ * sequencer. Every event is one byte:
+ * - Bits 7-5: duration code (MELODY_DURATION), 0 marks a control byte.
+ * - Bits 4-0: note index, 1 is MELODY_LOWEST_NOTE and 31 is 30 semitones above it;
+ *   0 is a rest. In a control byte the low bits select the control (see below).
+ *
+ * Control bytes:
+ * - MELODY_END: end of the melody.
+ * - MELODY_MARK: start of a section to repeat.
+ * - MELODY_REPEAT(n): plays the section since the last mark n more times (1-29).
+ * - MELODY_START: start of a melody sent over the serial interface.
+ *
+ * A note sounds for 7/8 of its duration and is followed by a rest of 1/8, so repeated
+ * notes stay apart. The player decodes one byte at a time when the previous event ends,
+ * so a melody of any length plays with a few bytes of RAM. It is read either from flash
+ * or from the serial receive buffer as the bytes arrive; repeats need the melody in
+ * flash and are skipped when streaming.
+ *
+ * Streaming uses credits, as the receive buffer of templateEMP.h holds only 31 bytes
+ * and an overflow loses all of them. The host side:
+ * 1. Send "stream" and wait for the prompt line.
+ * 2. Send at most MELODY_STREAM_WINDOW bytes at once, MELODY_START included.
+ * 3. Send one more byte for every MELODY_CREDIT received; other received bytes are text
+ *    and can be ignored.
+ * 4. Stop after MELODY_END.
+ * The player sends a credit for every byte it has taken from the buffer, so no more
+ * than MELODY_STREAM_WINDOW bytes are ever waiting in it.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef MELODY_H
+#define MELODY_H
+
+#include <stdint.h>
+#include "Notes.h"
+#include "Sequencer.h"
+
+#define MELODY_LOWEST_NOTE NOTE_C4 /**< Note of index 1, the highest is NOTE_FS6 */
+
+/**
+ * @brief Duration codes of the events; the length in steps at SEQUENCER_STEPS_PER_BEAT.
+ */
+typedef enum {
+    MELODY_SIXTEENTH = 1,      /**< 1/16 note, 4 steps */
+    MELODY_EIGHTH,             /**< 1/8 note, 8 steps */
+    MELODY_DOTTED_EIGHTH,      /**< Dotted 1/8 note, 12 steps */
+    MELODY_QUARTER,            /**< 1/4 note, 16 steps */
+    MELODY_DOTTED_QUARTER,     /**< Dotted 1/4 note, 24 steps */
+    MELODY_HALF,               /**< 1/2 note, 32 steps */
+    MELODY_WHOLE               /**< Whole note, 64 steps */
+} MELODY_DURATION;
+
+#define MELODY_NOTE(note, duration) \
+    ((uint8_t)(((duration) << 5) | ((note) - MELODY_LOWEST_NOTE + 1))) /**< A note event */
+#define MELODY_REST(duration) ((uint8_t)((duration) << 5)) /**< A rest event */
+
+#define MELODY_END 0x00                          /**< End of the melody */
+#define MELODY_MARK 0x01                         /**< Start of a section to repeat */
+#define MELODY_REPEAT(times) ((uint8_t)((times) + 1)) /**< Repeat the section 1 to 29 times */
+#define MELODY_START 0x1F                        /**< Start of a streamed melody */
+
+#define MELODY_STREAM_WINDOW 16 /**< Bytes the host may send ahead of the credits */
+#define MELODY_CREDIT 0x06      /**< Sent for every streamed byte taken (ASCII ACK) */
+
+/**
+ * @brief "Alle meine Entchen", 27 notes in 25 bytes.
+ */
+extern const uint8_t entchenMelody[];
+
+/**
+ * @brief Starts playing a melody from flash.
+ *
+ * @param melody The melody, terminated by MELODY_END.
+ * @param callback Function called when an event starts and when the melody ends, or 0.
+ *
+ * The melody is played in the background at the tempo of the sequencer.
+ */
+extern void melodyPlay(const uint8_t *melody, SequencerCallback callback);
+
+/**
+ * @brief Starts playing a melody from the serial interface.
+ *
+ * @param callback Function called when an event starts and when the melody ends, or 0.
+ *
+ * The bytes are read from the receive buffer of templateEMP.h while the melody plays,
+ * until MELODY_END arrives; a leading MELODY_START is skipped. If the next byte has not
+ * arrived yet, the player rests for one step and tries again. The application must not
+ * read the serial interface while the melody plays, and has to call melodyStreamPoll()
+ * until it has ended.
+ */
+extern void melodyPlaySerial(SequencerCallback callback);
+
+/**
+ * @brief Sends the credits for the streamed bytes taken since the last call.
+ *
+ * The bytes are taken in the system tick, which must not wait for the UART, so the
+ * credits are sent from the main loop. Nothing is sent when no melody is streamed.
+ */
+extern void melodyStreamPoll(void);
+
+#endif /* MELODY_H */
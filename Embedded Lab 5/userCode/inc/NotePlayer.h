@@ -28,9 +28,10 @@ extern void initNotePlayer();
  * @brief Plays a single note for a specified duration.
  * 
  * @param note The note to be played.
- * @param duration The duration for which the note should be played.
+ * @param duration The duration in seconds for which the note should be played (at most 15).
  * 
- * This function plays a single note with the specified duration.
+ * This function plays a single note with the specified duration and returns when it has
+ * ended. Melodies that must not block are played with the sequencer (Sequencer.h).
  */
 extern void playNote(NOTE note, unsigned int duration);
 
@@ -12,22 +12,95 @@
 #ifndef NOTES_H
 #define NOTES_H
 
+#include <stdint.h>
+
 /**
- * @brief Enumeration for musical notes with their corresponding frequencies in Hz.
+ * @brief Enumeration for musical notes.
  * 
- * This enum defines musical notes with their respective frequencies. The frequencies
- * are represented as integer values.
+ * This enum numbers the equal-tempered chromatic scale from C3 to C8 (A4 = 440 Hz); the
+ * sharps are marked with S, H is the German name of B. A note is an index into the
+ * period table of Notes.c, so a note change is a table lookup. NOTE_C to NOTE_C2 name
+ * the octave of C4 to C5 that the user interface offers.
  */
 typedef enum
 {
-    NOTE_C = 261,  /**< Frequency of note C (261 Hz) */
-    NOTE_D = 294,  /**< Frequency of note D (294 Hz) */
-    NOTE_E = 329,  /**< Frequency of note E (329 Hz) */
-    NOTE_F = 349,  /**< Frequency of note F (349 Hz) */
-    NOTE_G = 391,  /**< Frequency of note G (391 Hz) */
-    NOTE_A = 440,  /**< Frequency of note A (440 Hz) */
-    NOTE_H = 493,  /**< Frequency of note H (493 Hz) */
-    NOTE_C2 = 523  /**< Frequency of note C2 (523 Hz) */
+    NOTE_REST,     /**< No note, silence */
+    NOTE_C3,       /**< 130.81 Hz */
+    NOTE_CS3,      /**< 138.59 Hz */
+    NOTE_D3,       /**< 146.83 Hz */
+    NOTE_DS3,      /**< 155.56 Hz */
+    NOTE_E3,       /**< 164.81 Hz */
+    NOTE_F3,       /**< 174.61 Hz */
+    NOTE_FS3,      /**< 185.00 Hz */
+    NOTE_G3,       /**< 196.00 Hz */
+    NOTE_GS3,      /**< 207.65 Hz */
+    NOTE_A3,       /**< 220.00 Hz */
+    NOTE_AS3,      /**< 233.08 Hz */
+    NOTE_H3,       /**< 246.94 Hz */
+
+    NOTE_C4,       /**< 261.63 Hz */
+    NOTE_CS4,      /**< 277.18 Hz */
+    NOTE_D4,       /**< 293.66 Hz */
+    NOTE_DS4,      /**< 311.13 Hz */
+    NOTE_E4,       /**< 329.63 Hz */
+    NOTE_F4,       /**< 349.23 Hz */
+    NOTE_FS4,      /**< 369.99 Hz */
+    NOTE_G4,       /**< 392.00 Hz */
+    NOTE_GS4,      /**< 415.30 Hz */
+    NOTE_A4,       /**< 440.00 Hz */
+    NOTE_AS4,      /**< 466.16 Hz */
+    NOTE_H4,       /**< 493.88 Hz */
+
+    NOTE_C5,       /**< 523.25 Hz */
+    NOTE_CS5,      /**< 554.37 Hz */
+    NOTE_D5,       /**< 587.33 Hz */
+    NOTE_DS5,      /**< 622.25 Hz */
+    NOTE_E5,       /**< 659.26 Hz */
+    NOTE_F5,       /**< 698.46 Hz */
+    NOTE_FS5,      /**< 739.99 Hz */
+    NOTE_G5,       /**< 783.99 Hz */
+    NOTE_GS5,      /**< 830.61 Hz */
+    NOTE_A5,       /**< 880.00 Hz */
+    NOTE_AS5,      /**< 932.33 Hz */
+    NOTE_H5,       /**< 987.77 Hz */
+
+    NOTE_C6,       /**< 1046.50 Hz */
+    NOTE_CS6,      /**< 1108.73 Hz */
+    NOTE_D6,       /**< 1174.66 Hz */
+    NOTE_DS6,      /**< 1244.51 Hz */
+    NOTE_E6,       /**< 1318.51 Hz */
+    NOTE_F6,       /**< 1396.91 Hz */
+    NOTE_FS6,      /**< 1479.98 Hz */
+    NOTE_G6,       /**< 1567.98 Hz */
+    NOTE_GS6,      /**< 1661.22 Hz */
+    NOTE_A6,       /**< 1760.00 Hz */
+    NOTE_AS6,      /**< 1864.66 Hz */
+    NOTE_H6,       /**< 1975.53 Hz */
+
+    NOTE_C7,       /**< 2093.00 Hz */
+    NOTE_CS7,      /**< 2217.46 Hz */
+    NOTE_D7,       /**< 2349.32 Hz */
+    NOTE_DS7,      /**< 2489.02 Hz */
+    NOTE_E7,       /**< 2637.02 Hz */
+    NOTE_F7,       /**< 2793.83 Hz */
+    NOTE_FS7,      /**< 2959.96 Hz */
+    NOTE_G7,       /**< 3135.96 Hz */
+    NOTE_GS7,      /**< 3322.44 Hz */
+    NOTE_A7,       /**< 3520.00 Hz */
+    NOTE_AS7,      /**< 3729.31 Hz */
+    NOTE_H7,       /**< 3951.07 Hz */
+
+    NOTE_C8,       /**< 4186.01 Hz */
+    NUM_PITCHES,   /**< Number of entries of the period table */
+
+    NOTE_C = NOTE_C4,  /**< Note C (261.63 Hz) */
+    NOTE_D = NOTE_D4,  /**< Note D (293.66 Hz) */
+    NOTE_E = NOTE_E4,  /**< Note E (329.63 Hz) */
+    NOTE_F = NOTE_F4,  /**< Note F (349.23 Hz) */
+    NOTE_G = NOTE_G4,  /**< Note G (392.00 Hz) */
+    NOTE_A = NOTE_A4,  /**< Note A (440.00 Hz) */
+    NOTE_H = NOTE_H4,  /**< Note H (493.88 Hz) */
+    NOTE_C2 = NOTE_C5  /**< Note C2 (523.25 Hz) */
 } NOTE;
 
 /**
@@ -72,4 +145,13 @@ extern const NOTE *getNotes();
  * @return The number of notes.
  */
 extern const int getNumberOfNotes();
+
+/**
+ * @brief Returns the timer period of a note.
+ * 
+ * @param note The note.
+ * 
+ * @return The period in PWM timer clocks (see PWM_CLOCK_HZ), or 0 for NOTE_REST.
+ */
+extern uint16_t getNotePeriod(NOTE note);
 #endif /* NOTES_H */
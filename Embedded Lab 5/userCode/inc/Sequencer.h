@@ -0,0 +1,144 @@
+/**
+ * @file    Sequencer.h
+ * @brief   Header file for the note sequencer.
+ *
+ * This file contains declarations for the non-blocking note sequencer. A melody is an
+ * array of events, each a note followed by a rest. Lengths are given in steps of
+ * 1/SEQUENCER_STEPS_PER_BEAT beat, so the same melody can be played at any tempo. The
+ * sequencer runs from the system tick and switches the PWM at the event boundaries in
+ * interrupt context; the caller only starts the melody and checks its progress. An event
+ * with a harmony note is played as a two-note chord if the voices are initialized, and
+ * as its main note otherwise. Melodies of any length can be streamed event by event from
+ * a source function, e.g. the decoder of Melody.h.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef SEQUENCER_H
+#define SEQUENCER_H
+
+#include <stdint.h>
+#include "Notes.h"
+
+#define SEQUENCER_STEPS_PER_BEAT 16 /**< Steps per beat, a step is a 1/64 note in 4/4 */
+#define SEQUENCER_DEFAULT_BPM 120   /**< Tempo after initSequencer() */
+#define SEQUENCER_MAX_BPM 300       /**< Fastest supported tempo */
+#define SEQUENCER_REST NOTE_REST    /**< Note of an event that only pauses */
+
+#define GONG_BPM 150                /**< Tempo at which gongMelody has its original timing */
+
+/**
+ * @brief One event of a melody.
+ */
+typedef struct {
+    NOTE note;        /**< Note to play, or SEQUENCER_REST */
+    uint8_t duration; /**< Length of the note in steps */
+    uint8_t rest;     /**< Silence after the note in steps */
+    NOTE harmony;     /**< Second voice played with the note, or NOTE_REST (Voices.h) */
+} SequencerEvent;
+
+/**
+ * @brief Function called from interrupt context when an event starts.
+ *
+ * The index is the number of the event; it equals the number of events when the
+ * melody has ended.
+ */
+typedef void (*SequencerCallback)(uint16_t index);
+
+/**
+ * @brief Function called from interrupt context for the next event of a streamed melody.
+ *
+ * The function fills in the event and returns 1, or returns 0 when the melody has ended.
+ */
+typedef uint8_t (*SequencerSource)(SequencerEvent *event);
+
+/**
+ * @brief The "Gong" of Lab 2: g', e' and c', each 900 ms with 100 ms rest at 150 BPM.
+ */
+extern const SequencerEvent gongMelody[];
+
+/**
+ * @brief Number of events of gongMelody.
+ */
+extern const uint16_t gongLength;
+
+/**
+ * @brief Initializes the sequencer.
+ *
+ * This function registers the sequencer with the system tick. The PWM has to be
+ * initialized by the caller.
+ */
+extern void initSequencer();
+
+/**
+ * @brief Sets the tempo.
+ *
+ * @param bpm Beats per minute, 1 to SEQUENCER_MAX_BPM.
+ *
+ * The tempo can be changed while a melody is playing.
+ */
+extern void sequencerSetTempo(uint16_t bpm);
+
+/**
+ * @brief Sets the duty cycle used for the notes.
+ *
+ * @param dutyCycle Duty cycle in percent (0-100); takes effect with the next note.
+ */
+extern void sequencerSetDutyCycle(uint8_t dutyCycle);
+
+/**
+ * @brief Selects the synthesizer or the PWM for the notes.
+ *
+ * @param enable 1 to play the notes with the synthesizer (Dds.h), 0 for the PWM and the
+ *               voices.
+ *
+ * The synthesizer has to be initialized with initDds(). It plays the main note of every
+ * event with its waveform and envelope; the duty cycle and the harmony are not used.
+ */
+extern void sequencerUseDds(uint8_t enable);
+
+/**
+ * @brief Starts playing a melody.
+ *
+ * @param events Pointer to the events; they must stay valid while the melody plays.
+ * @param count Number of events.
+ * @param callback Function called when an event starts and when the melody ends, or 0.
+ *
+ * A melody that is still playing is stopped first. The function returns immediately.
+ */
+extern void sequencerPlay(const SequencerEvent *events, uint16_t count, SequencerCallback callback);
+
+/**
+ * @brief Starts playing a melody supplied event by event.
+ *
+ * @param source Function that returns the next event; called once here and then at the
+ *               end of every event.
+ * @param callback Function called when an event starts and when the melody ends, or 0.
+ *
+ * Only the event that is playing is held in RAM, so the melody can be of any length.
+ * The position counts the events played so far.
+ */
+extern void sequencerPlayStream(SequencerSource source, SequencerCallback callback);
+
+/**
+ * @brief Stops the melody and silences the buzzer.
+ */
+extern void sequencerStop();
+
+/**
+ * @brief Checks whether a melody is playing.
+ *
+ * @return Returns 1 while a melody is playing, 0 otherwise.
+ */
+extern uint8_t sequencerIsPlaying();
+
+/**
+ * @brief Returns the index of the event that is playing.
+ *
+ * @return The event index; the number of events once the melody has ended.
+ */
+extern uint16_t sequencerGetPosition();
+
+#endif /* SEQUENCER_H */
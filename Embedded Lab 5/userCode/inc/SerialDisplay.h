@@ -2,7 +2,9 @@
  * @file    SerialDisplay.h
  * @brief   Header file for the Serial Display library.
  *
- * This file contains function declarations for the Serial Display library.
+ * This file contains function declarations for the Serial Display library. The screen
+ * is kept as a model of two lines; the functions only send the characters that differ
+ * from what the terminal already shows, using cursor addressing and ANSI attributes.
  *
  * @date    25.05.2024
  * @authors Bjoern Metzger & Daniel Korobow
@@ -13,13 +15,12 @@
 #define SERIALDISPLAY_H
 
 /**
- * @brief Displays the notes with the currently selected note indicated by a '#'.
+ * @brief Displays the notes with the currently selected note highlighted.
  * 
  * @param currentNote The currently selected note to be indicated.
  * 
- * This function retrieves the list of notes and their names, and then constructs
- * a string where the currently selected note is indicated by a '#'. The string
- * is then printed to the terminal.
+ * This function retrieves the list of notes and their names and draws them into the
+ * note line; the selected note is shown in inverse video.
  */
 extern void displayNotes(NOTE currentNote);
 
@@ -28,8 +29,7 @@ extern void displayNotes(NOTE currentNote);
  * 
  * @param currentTone The currently selected tone.
  * 
- * This function prints a message to the terminal indicating the currently
- * selected tone number.
+ * This function shows the currently selected tone number in the status line.
  */
 extern void displayToneSelection(TONE currentTone);
 
@@ -38,8 +38,7 @@ extern void displayToneSelection(TONE currentTone);
  * 
  * @param currentTone The tone currently being played.
  * 
- * This function prints a message to the terminal indicating the note number
- * currently being played.
+ * This function shows the note number currently being played in the status line.
  */
 extern void displayPlayingTone(TONE currentTone);
 
@@ -47,8 +46,17 @@ extern void displayPlayingTone(TONE currentTone);
  * @brief Clears the terminal screen.
  * 
  * This function sends an escape sequence to the terminal to clear the screen
- * and move the cursor to the home position.
+ * and move the cursor to the home position. The screen model is cleared as well, so
+ * the next updates draw the whole screen.
  */
 extern void clearScreen();
 
+/**
+ * @brief Moves the cursor below the screen.
+ * 
+ * This function moves the cursor to the line below the screen and clears everything
+ * from there on, so other output such as the console does not overwrite the screen.
+ */
+extern void displayParkCursor();
+
 #endif /* USERINTERFACE_H */
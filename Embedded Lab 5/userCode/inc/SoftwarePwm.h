@@ -2,7 +2,15 @@
  * @file    SoftwarePwm.h
  * @brief   Header file for the Software PWM library.
  *
- * This file contains function declarations for the software PWM library.
+ * This file contains function declarations for the PWM library. Timer1_A generates the
+ * PWM in one of two modes:
+ * - Hardware: the timer drives the TA1.1 output pin (P2.1) itself, no interrupt is used.
+ * - Software: two interrupts per period set and clear an arbitrary port pin.
+ *
+ * CPU load of the software mode at 523 Hz (C5), estimated from the instruction timing of
+ * the interrupt routines (about 30 cycles each including entry and exit): 1046 interrupts
+ * per second, about 31,000 cycles per second, i.e. 3.1 % at 1 MHz and 0.2 % at 16 MHz.
+ * The hardware mode has no CPU load while a tone is playing.
  *
  * @date    25.05.2024
  * @authors Bjoern Metzger & Daniel Korobow
@@ -13,32 +21,66 @@
 #define SOFTWAREPWM_H
 
 #include <stdint.h>
+#include "SystemClock.h"
+
+#define PWM_HARDWARE_PIN BIT1 /**< TA1.1 output on P2.1 */
+
+// The timer clock is divided from 8 MHz on, so the lowest notes still fit in 16 bits
+#if SMCLK_FREQUENCY_HZ >= 8000000UL
+#define PWM_CLOCK_DIVIDER 8          /**< Input divider of Timer1_A */
+#define PWM_CLOCK_DIVIDER_BITS ID_3  /**< TA1CTL bits of the divider */
+#else
+#define PWM_CLOCK_DIVIDER 1          /**< Input divider of Timer1_A */
+#define PWM_CLOCK_DIVIDER_BITS ID_0  /**< TA1CTL bits of the divider */
+#endif
+
+#define PWM_CLOCK_HZ (SMCLK_FREQUENCY_HZ / PWM_CLOCK_DIVIDER) /**< Clock of the PWM timer */
+
+/**
+ * @brief Initializes the hardware PWM on the TA1.1 output pin (P2.1).
+ *
+ * This function selects the timer function of P2.1. The pin is held low while the PWM
+ * is stopped.
+ */
+extern void hardwarePwmInit();
+
 /**
  * @brief Initializes the software PWM.
- * 
- * @param port Pointer to the port register.
+ *
+ * @param port Pointer to the port output register.
  * @param pin The pin number for PWM output.
- * 
- * This function initializes the software PWM by configuring the specified pin
- * on the specified port for PWM output.
+ *
+ * This function initializes the software PWM on the specified pin of the specified port.
+ * Any pin can be used, but every period costs two interrupts. The pin has to be
+ * configured as an output by the caller.
  */
 extern void softwarePwmInit(volatile unsigned char *port, unsigned char pin);
 
 /**
  * @brief Sets the frequency of the software PWM.
- * 
+ *
  * @param freq The desired frequency in Hz.
- * 
- * This function sets the frequency of the software PWM by adjusting the period
- * of the PWM waveform.
+ *
+ * This function sets the frequency of the PWM by adjusting the period of the PWM
+ * waveform. The duty cycle is kept.
  */
 extern void softwarePwmSetFrequency(uint16_t freq);
 
 /**
- * @brief Sets the duty cycle of the software PWM.
+ * @brief Sets the period of the software PWM.
  * 
- * @param dutyCycle The desired duty cycle as a percentage (0-100).
+ * @param period The period in PWM timer clocks (PWM_CLOCK_HZ), at least 2.
  * 
+ * This function sets the period directly, e.g. from the note table, without the division
+ * of softwarePwmSetFrequency(). The duty cycle is kept.
+ */
+extern void softwarePwmSetPeriod(uint16_t period);
+
+/**
+ * @brief Sets the duty cycle of the software PWM.
+ *
+ * @param dutyCycle The desired duty cycle as a percentage (0-100).
+ *
  * This function sets the duty cycle of the software PWM, controlling the ratio
  * of high time to low time in each period of the PWM waveform.
  */
@@ -46,7 +88,7 @@ extern void softwarePwmSetDutyCycle(uint16_t dutyCycle);
 
 /**
  * @brief Starts the software PWM operation.
- * 
+ *
  * This function starts the software PWM, allowing the PWM waveform to generate
  * output on the configured pin.
  */
@@ -54,10 +96,9 @@ extern void softwarePwmStart();
 
 /**
  * @brief Stops the software PWM operation.
- * 
- * This function stops the software PWM, halting the generation of the PWM waveform
- * on the configured pin.
+ *
+ * This function stops the software PWM and drives the configured pin low.
  */
 extern void softwarePwmStop();
- 
+
 #endif /* SOFTWAREPWM_H */
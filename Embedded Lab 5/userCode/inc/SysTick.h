@@ -0,0 +1,49 @@
+/**
+ * @file    SysTick.h
+ * @brief   Header file for the millisecond system tick.
+ *
+ * This file contains function declarations for the 1 ms system tick generated by
+ * Timer0_A. Modules register a tick handler to run periodic work such as timeouts.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef SYSTICK_H
+#define SYSTICK_H
+
+#include <stdint.h>
+
+#define SYSTICK_MAX_HANDLERS 6 /**< Maximum number of registered tick handlers */
+
+/**
+ * @brief Function called from the timer interrupt on every tick.
+ */
+typedef void (*SysTickHandler)(void);
+
+/**
+ * @brief Initializes the system tick.
+ * 
+ * This function starts Timer0_A in up mode from SMCLK with a period of 1 ms and enables
+ * its interrupt. Calling it again has no effect.
+ */
+extern void initSysTick();
+
+/**
+ * @brief Registers a function that is called on every tick.
+ * 
+ * @param handler The function to call; it runs in interrupt context and must be short.
+ * 
+ * @return Returns 0 on success, or -1 if all handler slots are in use.
+ */
+extern int16_t sysTickRegister(SysTickHandler handler);
+
+/**
+ * @brief Returns the number of milliseconds since initSysTick().
+ * 
+ * @return The tick count; it wraps around after 65536 ms.
+ */
+extern uint16_t getSysTicks();
+
+#endif /* SYSTICK_H */
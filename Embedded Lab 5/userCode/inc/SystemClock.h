@@ -0,0 +1,34 @@
+/**
+ * @file    SystemClock.h
+ * @brief   Header file for the system clock configuration.
+ *
+ * This file contains the clock frequency used by all modules and the function that
+ * applies it. The frequency is chosen at build time with SMCLK_FREQUENCY_HZ, e.g. by
+ * adding SMCLK_FREQUENCY_HZ=16000000 to the predefined symbols of the project. The
+ * calibrated DCO settings of the MSP430G2553 allow 1, 8, 12 and 16 MHz.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef SYSTEMCLOCK_H
+#define SYSTEMCLOCK_H
+
+#ifndef SMCLK_FREQUENCY_HZ
+#define SMCLK_FREQUENCY_HZ 1000000UL /**< MCLK = SMCLK = DCO frequency */
+#endif
+
+#define SMCLK_CYCLES_PER_MS (SMCLK_FREQUENCY_HZ / 1000UL)       /**< Cycles per millisecond */
+#define SMCLK_CYCLES_PER_US (SMCLK_FREQUENCY_HZ / 1000000UL)    /**< Cycles per microsecond */
+
+/**
+ * @brief Switches the DCO to SMCLK_FREQUENCY_HZ.
+ * 
+ * This function has to be called right after initMSP(), which starts with 1 MHz. It
+ * loads the matching calibration constants and adapts the UART divider so the serial
+ * connection keeps running at 9600 baud.
+ */
+extern void initSystemClock();
+
+#endif /* SYSTEMCLOCK_H */
@@ -2,7 +2,11 @@
  * @file    TwoWire.h
  * @brief   Header file for I2C communication.
  *
- * This file contains function declarations for I2C communication.
+ * This file contains function declarations for I2C communication. Transfers are run
+ * by an interrupt-driven state machine of the USCI_B0 module: the caller queues a
+ * transaction and is notified by a completion callback, or uses one of the blocking
+ * wrappers. Every transaction ends, either with success, a NACK, an arbitration loss
+ * or a timeout; a stuck bus is recovered by clocking SCL.
  *
  * @date    25.05.2024
  * @authors Bjoern Metzger & Daniel Korobow
@@ -14,23 +18,152 @@
 
 #include <stdint.h>
 
+#define I2C_QUEUE_LENGTH 4 /**< Maximum number of queued transactions */
+#define I2C_TIMEOUT_MS 10  /**< Maximum duration of one transaction */
+
+#define I2C_STANDARD_MODE_HZ 100000UL /**< Standard-mode SCL frequency */
+#define I2C_FAST_MODE_HZ 400000UL     /**< Fast-mode SCL frequency */
+
+#define I2C_MIN_PRESCALER 4 /**< SCL may be at most BRCLK / 4 in master mode */
+
+/**
+ * @brief USCI_B0 prescaler for an SCL frequency, rounded up so the bus never runs faster.
+ */
+#define I2C_PRESCALER(smclkHz, speedHz) \
+    (((smclkHz) + (speedHz) - 1) / (speedHz) < I2C_MIN_PRESCALER ? I2C_MIN_PRESCALER : ((smclkHz) + (speedHz) - 1) / (speedHz))
+
+#ifndef I2C_SPEED_HZ
+#define I2C_SPEED_HZ I2C_STANDARD_MODE_HZ /**< SCL frequency selected by initI2C() */
+#endif
+
+/**
+ * @brief Status codes of an I2C transaction.
+ */
+typedef enum {
+    I2C_PENDING = 1,            /**< Transaction is queued or running */
+    I2C_OK = 0,                 /**< Transaction completed */
+    I2C_ERROR_NACK = -1,        /**< The slave did not acknowledge */
+    I2C_ERROR_ARBITRATION = -2, /**< Another master won the bus */
+    I2C_ERROR_TIMEOUT = -3,     /**< The transaction did not complete in time */
+    I2C_ERROR_QUEUE_FULL = -4,  /**< No free slot in the transaction queue */
+    I2C_ERROR_LENGTH = -5       /**< Transfer longer than the buffer of a helper */
+} I2C_STATUS;
+
+struct I2cTransaction;
+
+/**
+ * @brief Function called from interrupt context when a transaction has ended.
+ */
+typedef void (*I2cCallback)(struct I2cTransaction *transaction);
+
+/**
+ * @brief Description of one I2C transaction.
+ *
+ * A transaction writes `txCount` bytes, then reads `rxCount` bytes after a repeated
+ * start. Either count may be 0 for a plain read or a plain write. The structure and
+ * both buffers are owned by the caller and must stay valid until the status is no
+ * longer I2C_PENDING.
+ */
+typedef struct I2cTransaction {
+    const uint8_t *txData;   /**< Bytes to write */
+    uint8_t *rxData;         /**< Buffer for the bytes read */
+    I2cCallback callback;    /**< Completion callback, or 0 */
+    void *context;           /**< Free for the owner of the transaction */
+    uint8_t address;         /**< 7-bit slave address */
+    uint8_t txCount;         /**< Number of bytes to write */
+    uint8_t rxCount;         /**< Number of bytes to read */
+    volatile int16_t status; /**< Current status (I2C_STATUS) */
+} I2cTransaction;
+
 /**
  * @brief Initializes the I2C interface.
- * 
- * This function initializes the I2C interface for communication.
+ *
+ * This function initializes the I2C interface for communication and starts the system
+ * tick used for the transaction timeouts.
  */
 void initI2C(void);
 
+/**
+ * @brief Selects the SCL frequency.
+ *
+ * @param speedHz The requested frequency, e.g. I2C_STANDARD_MODE_HZ or I2C_FAST_MODE_HZ.
+ *
+ * @return Returns the frequency actually used.
+ *
+ * The prescaler is derived from SMCLK_FREQUENCY_HZ and rounded up, so the bus never
+ * runs faster than requested, and is at least I2C_MIN_PRESCALER. 400 kHz is reached
+ * exactly from 8, 12 and 16 MHz; at 1 MHz the bus runs at 250 kHz. The new frequency
+ * applies from the next transaction; the function waits until the queue is empty.
+ */
+uint32_t i2cSetSpeed(const uint32_t speedHz);
+
+/**
+ * @brief Queues a transaction.
+ *
+ * @param transaction Pointer to the transaction; its status is set to I2C_PENDING.
+ *
+ * @return Returns 0 if the transaction was queued, or I2C_ERROR_QUEUE_FULL.
+ *
+ * The transaction starts as soon as the transactions queued before it have ended.
+ * The function returns immediately; the result is reported through the status and
+ * the callback.
+ */
+int16_t i2cSubmit(I2cTransaction *transaction);
+
+/**
+ * @brief Waits until a transaction has ended.
+ *
+ * @param transaction Pointer to a queued transaction.
+ *
+ * @return Returns the final status of the transaction (I2C_STATUS).
+ */
+int16_t i2cWait(I2cTransaction *transaction);
+
+/**
+ * @brief Checks whether the I2C interface is idle.
+ *
+ * @return Returns 1 if no transaction is queued or running, 0 otherwise.
+ */
+uint8_t i2cIsIdle(void);
+
+/**
+ * @brief Handles the I2C status interrupts (NACK, arbitration lost).
+ *
+ * USCI_B0 shares the status interrupt vector with the UART receive interrupt, so this
+ * function has to be called from the USCIAB0RX_VECTOR service routine.
+ */
+void i2cStatusInterrupt(void);
+
 /**
  * @brief Transfers a byte over I2C.
- * 
+ *
  * @param addr The 7-bit address of the slave device.
  * @param send The byte to be transmitted.
- * 
+ *
  * @return Returns the received byte or an error code.
- * 
+ *
  * This function transfers a byte over I2C to the specified slave device address.
+ * It blocks until the transaction has ended.
  */
 int16_t transferByte(const uint8_t addr, const uint8_t send);
 
+/**
+ * @brief Writes a block of bytes and reads a block back in one transaction.
+ *
+ * @param addr The 7-bit address of the slave device.
+ * @param send Pointer to the bytes to be transmitted.
+ * @param sendCount Number of bytes to transmit.
+ * @param received Pointer to the buffer for the received bytes.
+ * @param receiveCount Number of bytes to receive.
+ *
+ * @return Returns 0 on success, or a negative error code.
+ *
+ * This function sends the start condition, transmits `sendCount` bytes, switches to
+ * receive mode with a repeated start and reads `receiveCount` bytes before the stop
+ * condition. A device with an auto-increment register pointer can thus be read in a
+ * single transaction. It blocks until the transaction has ended.
+ */
+int16_t transferBlock(const uint8_t addr, const uint8_t *send, const uint8_t sendCount,
+                      uint8_t *received, const uint8_t receiveCount);
+
 #endif /* TWOWIRE_H */
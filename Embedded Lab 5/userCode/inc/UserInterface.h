@@ -33,7 +33,9 @@ extern void initUi();
  * 
  * This function allows the user to select tones using the joystick. The selected tones
  * are stored in the provided array. The selection process continues until the user 
- * selects the maximum number of tones specified by maxTones.
+ * selects the maximum number of tones specified by maxTones. Pushing the joystick up
+ * plays the melody stored in flash, and a melody sent over the serial interface
+ * (Melody.h) is played as it arrives; both can be stopped with the joystick button.
  */
 extern void getUserSelectedTones(NOTE *selectedTones, uint16_t maxTones);
 
@@ -42,10 +44,11 @@ extern void getUserSelectedTones(NOTE *selectedTones, uint16_t maxTones);
  * 
  * @param selectedTones Pointer to an array of selected tones to be played.
  * @param numTones The number of tones to play.
- * @param duration The duration each tone should be played for.
+ * @param duration The duration in seconds each tone should be played for (at most 15).
  * 
  * This function plays the user-selected tones in sequence. Each tone is played for
  * the specified duration, and the display is updated to show the currently playing tone.
+ * The notes play in the background; pressing the joystick ends the playback early.
  */
 extern void playUserNotes(NOTE *selectedTones, uint16_t numTones, uint16_t duration);
 
@@ -0,0 +1,92 @@
+/**
+ * @file    Voices.h
+ * @brief   Header file for the two-voice tone engine.
+ *
+ * This file contains declarations for playing two notes at the same time. Timer1_A runs
+ * in continuous mode and every voice owns a capture/compare channel in toggle mode: on
+ * each compare the output unit toggles the pin and the interrupt moves the compare
+ * value on by half a period. The voices thus run independently at any pitch of the
+ * note table.
+ *
+ * Two outputs are possible:
+ * - Separate: voice 1 on TA1.1 (P2.1), voice 2 on TA1.2 (P2.4). Connect both pins to
+ *   the buzzer through a resistor each, or use a second buzzer.
+ * - Mixed: both voices share TA1.1 (P2.1) by time division; the pin alternates between
+ *   them every VOICE_MIX_SLOT_MS, which the ear merges into a chord.
+ *
+ * Two voices at 523 Hz cost 2092 interrupts per second in either mode.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef VOICES_H
+#define VOICES_H
+
+#include <stdint.h>
+#include "Notes.h"
+
+#define VOICE_COUNT 2         /**< Number of voices */
+#define VOICE_MIX_SLOT_MS 4   /**< Time slot of a voice in the mixed output */
+#define VOICE_SECOND_PIN BIT4 /**< TA1.2 output on P2.4 */
+
+/**
+ * @brief Output of the voices.
+ */
+typedef enum {
+    VOICE_OUTPUT_SEPARATE, /**< One pin per voice */
+    VOICE_OUTPUT_MIXED     /**< Time division on P2.1 */
+} VOICE_OUTPUT;
+
+/**
+ * @brief Initializes the voices.
+ *
+ * @param output Whether the voices use a pin each or share P2.1.
+ *
+ * This function selects the timer function of the output pins and registers the
+ * time slot switching with the system tick. Timer1_A is shared with the PWM
+ * (SoftwarePwm.h); only one of them can play at a time.
+ */
+extern void initVoices(VOICE_OUTPUT output);
+
+/**
+ * @brief Sets the note of a voice.
+ *
+ * @param voice The voice, 0 to VOICE_COUNT - 1.
+ * @param note The note, or NOTE_REST to silence the voice.
+ *
+ * The new note takes effect with the next edge of the voice.
+ */
+extern void voicesSetNote(uint8_t voice, NOTE note);
+
+/**
+ * @brief Starts the voices.
+ *
+ * @return Returns 1 if the voices play, or 0 if initVoices() has not been called.
+ */
+extern uint8_t voicesStart();
+
+/**
+ * @brief Stops the voices and drives the outputs low.
+ */
+extern void voicesStop();
+
+/**
+ * @brief Checks whether the voices are playing.
+ *
+ * @return Returns 1 while the voices play, 0 otherwise.
+ */
+extern uint8_t voicesIsPlaying();
+
+/**
+ * @brief Handles the Timer1_A compare interrupts of the voices.
+ *
+ * @param vector The value read from TA1IV.
+ *
+ * The PWM and the voices share the TIMER1_A1_VECTOR, so this function has to be called
+ * from its service routine while the voices play.
+ */
+extern void voicesInterrupt(uint16_t vector);
+
+#endif /* VOICES_H */
@@ -0,0 +1,437 @@
+/**
+ * @file    Dds.c
+ * @brief   Functions for the wavetable synthesizer.
+ *
+ * This file contains the implementation of the synthesizer. The phase increment of a
+ * note is derived from its period in the note table when the note starts, so no second
+ * frequency table is needed. TA1CCR1 is not buffered, so a compare value written after
+ * the counter has passed it is missed and the output stays high for a whole carrier
+ * period. The sample is therefore written in the CCR1 interrupt right after the reset of
+ * the current period and takes effect in the next one; the write is only too late if the
+ * interrupt is delayed past the new compare value of the next period, which the
+ * interrupt detects and resets the output by hand. The wavetables stay within +-112, so
+ * the compare values keep clear of 0 and of the period, where the output modes have no
+ * edge at all.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+#include <msp430.h>
+
+#include "../inc/Notes.h"
+#include "../inc/SysTick.h"
+#include "../inc/SoftwarePwm.h"
+#include "../inc/Dds.h"
+
+#define CARRIER_MIDDLE (DDS_CARRIER_PERIOD / 2) /**< Compare value of a zero sample */
+
+#define LEVEL_SHIFT 8                           /**< Fraction bits of the envelope level */
+#define LEVEL_MAX (15U << LEVEL_SHIFT)          /**< Full level, the sample is scaled by 15/16 */
+
+// The increment is 2^40 / (PWM_CLOCK_DIVIDER * period), computed as (2^32 / period) << shift
+#if PWM_CLOCK_DIVIDER == 8
+#define INCREMENT_SHIFT 5
+#else
+#define INCREMENT_SHIFT 8
+#endif
+
+#define NYQUIST_INCREMENT 0x80000000UL          /**< Increment of half the sample rate */
+
+/**
+ * @brief Stages of the envelope.
+ */
+typedef enum {
+    STAGE_IDLE,    /**< Silent, the timer is stopped */
+    STAGE_ATTACK,  /**< Rising to full level */
+    STAGE_DECAY,   /**< Falling to the sustain level */
+    STAGE_SUSTAIN, /**< Holding the sustain level */
+    STAGE_RELEASE  /**< Falling to silence */
+} STAGE;
+
+// One period of every waveform, 8-bit signed, generated with round(112 * f(i / 256))
+static const int8_t sineTable[256] = {
+       0,    3,    5,    8,   11,   14,   16,   19,   22,   25,   27,   30,   33,   35,   38,   40,
+      43,   45,   48,   50,   53,   55,   58,   60,   62,   64,   67,   69,   71,   73,   75,   77,
+      79,   81,   83,   85,   87,   88,   90,   92,   93,   95,   96,   97,   99,  100,  101,  102,
+     103,  104,  105,  106,  107,  108,  109,  109,  110,  110,  111,  111,  111,  112,  112,  112,
+     112,  112,  112,  112,  111,  111,  111,  110,  110,  109,  109,  108,  107,  106,  105,  104,
+     103,  102,  101,  100,   99,   97,   96,   95,   93,   92,   90,   88,   87,   85,   83,   81,
+      79,   77,   75,   73,   71,   69,   67,   64,   62,   60,   58,   55,   53,   50,   48,   45,
+      43,   40,   38,   35,   33,   30,   27,   25,   22,   19,   16,   14,   11,    8,    5,    3,
+       0,   -3,   -5,   -8,  -11,  -14,  -16,  -19,  -22,  -25,  -27,  -30,  -33,  -35,  -38,  -40,
+     -43,  -45,  -48,  -50,  -53,  -55,  -58,  -60,  -62,  -64,  -67,  -69,  -71,  -73,  -75,  -77,
+     -79,  -81,  -83,  -85,  -87,  -88,  -90,  -92,  -93,  -95,  -96,  -97,  -99, -100, -101, -102,
+    -103, -104, -105, -106, -107, -108, -109, -109, -110, -110, -111, -111, -111, -112, -112, -112,
+    -112, -112, -112, -112, -111, -111, -111, -110, -110, -109, -109, -108, -107, -106, -105, -104,
+    -103, -102, -101, -100,  -99,  -97,  -96,  -95,  -93,  -92,  -90,  -88,  -87,  -85,  -83,  -81,
+     -79,  -77,  -75,  -73,  -71,  -69,  -67,  -64,  -62,  -60,  -58,  -55,  -53,  -50,  -48,  -45,
+     -43,  -40,  -38,  -35,  -33,  -30,  -27,  -25,  -22,  -19,  -16,  -14,  -11,   -8,   -5,   -3
+};
+
+static const int8_t triangleTable[256] = {
+       0,    2,    4,    5,    7,    9,   10,   12,   14,   16,   18,   19,   21,   23,   24,   26,
+      28,   30,   32,   33,   35,   37,   38,   40,   42,   44,   46,   47,   49,   51,   52,   54,
+      56,   58,   60,   61,   63,   65,   66,   68,   70,   72,   74,   75,   77,   79,   80,   82,
+      84,   86,   88,   89,   91,   93,   94,   96,   98,  100,  102,  103,  105,  107,  108,  110,
+     112,  110,  108,  107,  105,  103,  102,  100,   98,   96,   94,   93,   91,   89,   88,   86,
+      84,   82,   80,   79,   77,   75,   74,   72,   70,   68,   66,   65,   63,   61,   60,   58,
+      56,   54,   52,   51,   49,   47,   46,   44,   42,   40,   38,   37,   35,   33,   32,   30,
+      28,   26,   24,   23,   21,   19,   18,   16,   14,   12,   10,    9,    7,    5,    4,    2,
+       0,   -2,   -4,   -5,   -7,   -9,  -10,  -12,  -14,  -16,  -18,  -19,  -21,  -23,  -24,  -26,
+     -28,  -30,  -32,  -33,  -35,  -37,  -38,  -40,  -42,  -44,  -46,  -47,  -49,  -51,  -52,  -54,
+     -56,  -58,  -60,  -61,  -63,  -65,  -66,  -68,  -70,  -72,  -74,  -75,  -77,  -79,  -80,  -82,
+     -84,  -86,  -88,  -89,  -91,  -93,  -94,  -96,  -98, -100, -102, -103, -105, -107, -108, -110,
+    -112, -110, -108, -107, -105, -103, -102, -100,  -98,  -96,  -94,  -93,  -91,  -89,  -88,  -86,
+     -84,  -82,  -80,  -79,  -77,  -75,  -74,  -72,  -70,  -68,  -66,  -65,  -63,  -61,  -60,  -58,
+     -56,  -54,  -52,  -51,  -49,  -47,  -46,  -44,  -42,  -40,  -38,  -37,  -35,  -33,  -32,  -30,
+     -28,  -26,  -24,  -23,  -21,  -19,  -18,  -16,  -14,  -12,  -10,   -9,   -7,   -5,   -4,   -2
+};
+
+static const int8_t squareTable[256] = {
+     112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
+     112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
+     112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
+     112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
+     112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
+     112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
+     112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
+     112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
+    -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112,
+    -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112,
+    -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112,
+    -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112,
+    -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112,
+    -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112,
+    -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112,
+    -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112, -112
+};
+
+void initDds();
+void ddsSetWave(DDS_WAVE wave);
+void ddsSetEnvelope(const DdsEnvelope *envelope);
+void ddsNoteOn(NOTE note);
+void ddsNoteOff();
+void ddsStop();
+uint8_t ddsIsPlaying();
+void ddsInterrupt(void);
+static void ddsTick(void);
+static void stopTimer(void);
+static uint16_t levelStep(uint16_t range, uint16_t ms);
+static int16_t scaleSample(int16_t sample, uint8_t level);
+
+static const int8_t *wavetable = sineTable; /**< Waveform of the notes */
+static uint8_t initialized = 0;             /**< 1 after initDds() */
+static volatile uint8_t playing = 0;        /**< 1 while the timer runs */
+
+static uint32_t phase = 0;                  /**< Phase accumulator, one period is 2^32 */
+static uint32_t phaseIncrement = 0;         /**< Phase step per sample */
+static uint16_t nextCompare = CARRIER_MIDDLE; /**< Sample for the next carrier period */
+static volatile uint8_t outputLevel = 0;    /**< Integer part of the level, read by the ISR */
+
+static volatile uint8_t stage = STAGE_IDLE; /**< Stage of the envelope */
+static uint16_t level = 0;                  /**< Envelope level, 8.8 fixed point */
+static uint16_t attackStep = LEVEL_MAX;     /**< Level change per millisecond */
+static uint16_t decayStep = LEVEL_MAX;      /**< Level change per millisecond */
+static uint16_t releaseStep = LEVEL_MAX;    /**< Level change per millisecond */
+static uint16_t sustainLevel = LEVEL_MAX;   /**< Level of a held note */
+
+/**
+ * @brief Initializes the synthesizer.
+ */
+void initDds()
+{
+    static const DdsEnvelope defaultEnvelope = {10, 100, 70, 150};
+
+    // TA1.1 on P2.1 is set up by hardwarePwmInit() as well, doing it twice is harmless
+    P2DIR |= PWM_HARDWARE_PIN;
+    P2SEL |= PWM_HARDWARE_PIN;
+    P2SEL2 &= ~PWM_HARDWARE_PIN;
+
+    ddsSetEnvelope(&defaultEnvelope);
+
+    if (!initialized)
+    {
+        initSysTick();
+        sysTickRegister(ddsTick);
+        initialized = 1;
+    }
+}
+
+/**
+ * @brief Selects the waveform.
+ *
+ * @param wave The waveform, takes effect immediately.
+ */
+void ddsSetWave(DDS_WAVE wave)
+{
+    switch (wave)
+    {
+    case DDS_WAVE_TRIANGLE:
+        wavetable = triangleTable;
+        break;
+    case DDS_WAVE_SQUARE:
+        wavetable = squareTable;
+        break;
+    default:
+        wavetable = sineTable;
+        break;
+    }
+}
+
+/**
+ * @brief Sets the envelope of the following notes.
+ *
+ * @param envelope The envelope; times of 0 change the level at once.
+ *
+ * The times are converted to level steps per millisecond here, so the tick needs no
+ * division.
+ */
+void ddsSetEnvelope(const DdsEnvelope *envelope)
+{
+    uint8_t percent = envelope->sustainLevel > 100 ? 100 : envelope->sustainLevel;
+    uint16_t interruptState = __get_interrupt_state();
+
+    __disable_interrupt();
+    sustainLevel = (uint16_t)(((uint32_t)LEVEL_MAX * percent) / 100);
+    attackStep = levelStep(LEVEL_MAX, envelope->attackMs);
+    decayStep = levelStep(LEVEL_MAX - sustainLevel, envelope->decayMs);
+    releaseStep = levelStep(LEVEL_MAX, envelope->releaseMs);
+    __set_interrupt_state(interruptState);
+}
+
+/**
+ * @brief Starts a note.
+ *
+ * @param note The note; NOTE_REST and notes above half the sample rate end the note
+ *             that is playing.
+ */
+void ddsNoteOn(NOTE note)
+{
+    uint16_t period = getNotePeriod(note);
+    uint16_t interruptState;
+    uint32_t increment;
+
+    if (!initialized || period == 0)
+    {
+        ddsNoteOff();
+        return;
+    }
+
+    // One 32-bit division per note instead of a second frequency table
+    increment = 0xFFFFFFFFUL / period;
+    if (increment >= (NYQUIST_INCREMENT >> INCREMENT_SHIFT))
+    {
+        ddsNoteOff();
+        return;
+    }
+    increment <<= INCREMENT_SHIFT;
+
+    // Also called by the sequencer from the system tick, so the state is restored
+    interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    phaseIncrement = increment;
+    stage = STAGE_ATTACK;
+
+    if (!playing)
+    {
+        phase = 0;
+        level = 0;
+        outputLevel = 0;
+        nextCompare = CARRIER_MIDDLE;
+
+        // Stop Timer1, undivided clock for the carrier
+        TA1CTL = TASSEL_2 | ID_0 | TACLR;
+        TA1CCR0 = DDS_CARRIER_PERIOD - 1;
+        TA1CCR1 = CARRIER_MIDDLE;
+
+        // Reset at CCR1, set at CCR0; the sample interrupt at CCR1
+        TA1CCTL0 = 0;
+        TA1CCTL1 = OUTMOD_7 | CCIE;
+
+        playing = 1;
+
+        // Start Timer1 in Up Mode
+        TA1CTL |= MC_1;
+    }
+    __set_interrupt_state(interruptState);
+}
+
+/**
+ * @brief Ends the note; it fades out with the release time of the envelope.
+ */
+void ddsNoteOff()
+{
+    if (stage != STAGE_IDLE)
+    {
+        stage = STAGE_RELEASE;
+    }
+}
+
+/**
+ * @brief Stops the synthesizer at once and drives P2.1 low.
+ */
+void ddsStop()
+{
+    uint16_t interruptState;
+
+    if (!initialized)
+    {
+        return;
+    }
+
+    interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    stopTimer();
+    __set_interrupt_state(interruptState);
+}
+
+/**
+ * @brief Checks whether the synthesizer is playing.
+ *
+ * @return Returns 1 while a note or its release sounds, 0 otherwise.
+ */
+uint8_t ddsIsPlaying()
+{
+    return playing;
+}
+
+/**
+ * @brief Writes the sample for the next carrier period and computes the one after it;
+ *        called at the reset of every carrier period.
+ *
+ * The compiler takes the index from the high word of the phase, so the 32-bit shift
+ * costs a byte swap only.
+ */
+void ddsInterrupt(void)
+{
+    uint16_t previous = TA1CCR1;
+    uint16_t counter;
+
+    TA1CCR1 = nextCompare;
+
+    // The interrupt came at TA1R == previous; a smaller counter means it was delayed into
+    // the next period, and past the new value the reset of this period has been missed
+    counter = TA1R;
+    if (counter < previous && counter >= nextCompare)
+    {
+        TA1CCTL1 = OUTMOD_0;        // OUT is 0, the output goes low at once
+        TA1CCTL1 = OUTMOD_7 | CCIE;
+    }
+
+    phase += phaseIncrement;
+    nextCompare = CARRIER_MIDDLE + scaleSample(wavetable[(uint8_t)(phase >> 24)], outputLevel);
+}
+
+/**
+ * @brief Advances the envelope by one millisecond; called from the system tick.
+ */
+static void ddsTick(void)
+{
+    switch (stage)
+    {
+    case STAGE_ATTACK:
+        if (level >= LEVEL_MAX - attackStep)
+        {
+            level = LEVEL_MAX;
+            stage = STAGE_DECAY;
+        }
+        else
+        {
+            level += attackStep;
+        }
+        break;
+    case STAGE_DECAY:
+        if (level <= sustainLevel + decayStep)
+        {
+            level = sustainLevel;
+            stage = STAGE_SUSTAIN;
+        }
+        else
+        {
+            level -= decayStep;
+        }
+        break;
+    case STAGE_RELEASE:
+        if (level <= releaseStep)
+        {
+            stopTimer();
+            return;
+        }
+        level -= releaseStep;
+        break;
+    default:
+        break;
+    }
+
+    outputLevel = level >> LEVEL_SHIFT;
+}
+
+/**
+ * @brief Stops Timer1 and silences the output; interrupts have to be disabled.
+ */
+static void stopTimer(void)
+{
+    TA1CTL &= ~MC_3;
+    TA1CCTL0 = 0;
+    TA1CCTL1 = OUTMOD_0;
+    stage = STAGE_IDLE;
+    level = 0;
+    outputLevel = 0;
+    playing = 0;
+}
+
+/**
+ * @brief Computes the level change per millisecond for a time.
+ *
+ * @param range The level change over the whole time.
+ * @param ms The time in milliseconds.
+ *
+ * @return The step, at least 1; the whole range for a time of 0.
+ */
+static uint16_t levelStep(uint16_t range, uint16_t ms)
+{
+    uint16_t step;
+
+    if (ms == 0)
+    {
+        return LEVEL_MAX;
+    }
+
+    step = (range + ms / 2) / ms;
+    return step ? step : 1;
+}
+
+/**
+ * @brief Scales a sample by level / 16 without a multiplication.
+ *
+ * @param sample The sample from the wavetable.
+ * @param level The envelope level, 0 to 15.
+ *
+ * @return The scaled sample.
+ */
+static int16_t scaleSample(int16_t sample, uint8_t level)
+{
+    int16_t sum = 0;
+
+    if (level & 8)
+    {
+        sum += sample << 3;
+    }
+    if (level & 4)
+    {
+        sum += sample << 2;
+    }
+    if (level & 2)
+    {
+        sum += sample << 1;
+    }
+    if (level & 1)
+    {
+        sum += sample;
+    }
+
+    return sum >> 4;
+}
@@ -3,8 +3,11 @@
  * @brief   Functions for joystick interactions.
  *
  * This file contains implementations of functions related to joystick interactions.
- * It includes functions to initialize the joystick, read ADC values from the joystick,
- * determine joystick direction, and check the joystick button state.
+ * The system tick starts a non-blocking I2C burst read of the converter every
+ * JOYSTICK_SAMPLE_PERIOD_MS. The completion callback runs the whole joystick engine:
+ * centre calibration, travel learning, scaling to proportional output, the radial
+ * dead zone, the direction with accelerating auto-repeat and the button debouncing.
+ * The results are handed to the application as events, so nothing here ever blocks.
  *
  * @date    25.05.2024
  * @authors Bjoern Metzger & Daniel Korobow
@@ -12,112 +15,372 @@
  */
 
 #include <stdint.h>
-#include <math.h>
 
+#include "../inc/SysTick.h"
 #include "../inc/TwoWire.h"
 #include "../inc/Hardware.h"
 
 #define SLAVE_ADDRESS 0b01001000
 
-#define CONTROLL_BYTE_X 0b01000000
-#define CONTROLL_BYTE_Y 0b01000001
-#define CONTROLL_BYTE_Z 0b01000010
+#define CONTROLL_BYTE_AUTO_INCREMENT 0b01000100 // Start at channel 0 (X), then Y, Z, ...
 
 #define NUM_VALUES 3
-#define DEADZONE_THRESHOLD 40 // Define deadzone threshold value
+#define BURST_LENGTH (NUM_VALUES + 1) // The first byte is the previous conversion
+
+#define AXIS_X 0
+#define AXIS_Y 1
+#define NUM_AXES 2
+#define CHANNEL_BUTTON 2
+
+#define INITIAL_TRAVEL 80          // Assumed travel from the centre until more is learned
+#define BUTTON_PRESS_LEVEL 140     // Button channel above this: pressed
+#define BUTTON_RELEASE_LEVEL 110   // Button channel below this: released
+#define BUTTON_DEBOUNCE_SAMPLES 2  // Equal samples needed to accept a button change
+
+#define MS_TO_SAMPLES(ms) ((ms) / JOYSTICK_SAMPLE_PERIOD_MS)
 
 void initJoystick();
+uint8_t joystickGetEvent(JoystickEvent *event);
+void joystickGetPosition(int8_t *x, int8_t *y);
+uint8_t joystickIsCalibrated();
 JOYSTICK_DIRECTION getJoystickDirection();
 JOYSTICK_BUTTON isJoystickPressed();
+static void startSample(void);
+static void processSample(I2cTransaction *transaction);
+static int8_t scaleAxis(const uint8_t axis, const uint8_t raw);
+static void updateDirection(void);
+static void updateButton(const uint8_t raw);
+static void pushEvent(const uint8_t type, const uint8_t direction);
+
+static const uint8_t controlByte = CONTROLL_BYTE_AUTO_INCREMENT; /**< Burst read from channel 0 */
+static uint8_t burst[BURST_LENGTH];                              /**< Target of the burst read */
+static I2cTransaction sampleTransaction;                          /**< The periodic burst read */
+static uint8_t sampleTimer = 0;                                   /**< Ticks since the last sample */
+
+static uint16_t centreSum[NUM_AXES];        /**< Sum of the calibration samples */
+static uint8_t centreSamples = 0;           /**< Number of calibration samples taken */
+static uint8_t centre[NUM_AXES];            /**< Raw value of the resting stick */
+static uint8_t rawMin[NUM_AXES];            /**< Smallest raw value seen */
+static uint8_t rawMax[NUM_AXES];            /**< Largest raw value seen */
+static volatile int8_t position[NUM_AXES];  /**< Calibrated position, +x right, +y up */
+
+static volatile JOYSTICK_DIRECTION direction = JOYSTICK_DEADZONE; /**< Current direction */
+static uint16_t directionSamples = 0;       /**< Samples the direction has been held */
+static uint16_t nextRepeat = 0;             /**< Sample count of the next auto-repeat */
+static uint16_t repeatInterval = 0;         /**< Current auto-repeat interval in samples */
+
+static volatile JOYSTICK_BUTTON button = JOYSTICK_RELEASED; /**< Debounced button state */
+static uint8_t buttonCount = 0;             /**< Samples disagreeing with the state */
+static uint16_t buttonSamples = 0;          /**< Samples the button has been pressed */
+
+static JoystickEvent events[JOYSTICK_EVENT_QUEUE_LENGTH]; /**< Event ring buffer */
+static volatile uint8_t eventHead = 0;      /**< Next event to read */
+static volatile uint8_t eventTail = 0;      /**< Next free slot */
 
 /**
- * @brief Reads the ADC values from the joystick.
- * 
- * @param values Pointer to an array where the ADC values will be stored.
- * 
- * This function reads the ADC values from the joystick for each axis (X, Y, Z)
- * and stores them in the provided array.
+ * @brief Initializes the joystick.
+ *
+ * This function initializes the I2C interface and registers the sampling task with the
+ * system tick. The first samples are used for the centre calibration.
  */
-void getADCValues(uint8_t *values)
+void initJoystick()
 {
-    values[0] = transferByte(SLAVE_ADDRESS, CONTROLL_BYTE_X);
-    values[0] = transferByte(SLAVE_ADDRESS, CONTROLL_BYTE_X);
-    values[1] = transferByte(SLAVE_ADDRESS, CONTROLL_BYTE_Y);
-    values[1] = transferByte(SLAVE_ADDRESS, CONTROLL_BYTE_Y);
-    values[2] = transferByte(SLAVE_ADDRESS, CONTROLL_BYTE_Z);
-    values[2] = transferByte(SLAVE_ADDRESS, CONTROLL_BYTE_Z);
+    initI2C();
+
+    sampleTransaction.address = SLAVE_ADDRESS;
+    sampleTransaction.txData = &controlByte;
+    sampleTransaction.txCount = 1;
+    sampleTransaction.rxData = burst;
+    sampleTransaction.rxCount = BURST_LENGTH;
+    sampleTransaction.callback = processSample;
+    sampleTransaction.context = 0;
+    sampleTransaction.status = I2C_OK;
+
+    sysTickRegister(startSample);
 }
 
 /**
- * @brief Initializes the joystick.
- * 
- * This function initializes the necessary hardware and modules to use the joystick.
+ * @brief Takes the next joystick event from the queue.
+ *
+ * @param event Pointer to where the event is stored.
+ *
+ * @return Returns 1 if an event was stored, 0 if the queue is empty.
  */
-void initJoystick()
+uint8_t joystickGetEvent(JoystickEvent *event)
 {
-    initI2C();
+    if (eventHead == eventTail)
+    {
+        return 0;
+    }
+
+    *event = events[eventHead];
+    eventHead = (eventHead + 1) % JOYSTICK_EVENT_QUEUE_LENGTH;
+
+    return 1;
+}
+
+/**
+ * @brief Returns the calibrated joystick position.
+ *
+ * @param x Pointer to the horizontal position.
+ * @param y Pointer to the vertical position.
+ */
+void joystickGetPosition(int8_t *x, int8_t *y)
+{
+    *x = position[AXIS_X];
+    *y = position[AXIS_Y];
+}
+
+/**
+ * @brief Checks whether the centre calibration has finished.
+ *
+ * @return Returns 1 once the centre is known, 0 before.
+ */
+uint8_t joystickIsCalibrated()
+{
+    return centreSamples >= JOYSTICK_CENTRE_SAMPLES;
 }
 
 /**
  * @brief Determines the direction of the joystick.
- * 
+ *
  * @return The direction of the joystick (JOYSTICK_DIRECTION).
- * 
- * This function reads the ADC values from the joystick and determines the direction
- * based on the differences between the X and Y axis values. It applies a deadzone
- * threshold to filter out noise.
+ *
+ * This function returns the direction of the last sample: the axis with the larger
+ * deflection wins, and nothing is reported inside the dead zone.
  */
 JOYSTICK_DIRECTION getJoystickDirection()
 {
-    uint8_t adcValues[NUM_VALUES];
-    JOYSTICK_DIRECTION currentDirection = JOYSTICK_DEADZONE;
+    return direction;
+}
 
-    getADCValues(adcValues);
+/**
+ * @brief Checks if the joystick button is pressed.
+ *
+ * @return The state of the joystick button (JOYSTICK_BUTTON).
+ *
+ * This function returns the debounced button state of the last sample.
+ */
+JOYSTICK_BUTTON isJoystickPressed() {
+    return button;
+}
 
-    int32_t xDiff = adcValues[0] - 128;
-    int32_t yDiff = adcValues[1] - 128;
+/**
+ * @brief Starts a burst read every JOYSTICK_SAMPLE_PERIOD_MS; called every millisecond.
+ */
+static void startSample(void)
+{
+    if (++sampleTimer < JOYSTICK_SAMPLE_PERIOD_MS)
+    {
+        return;
+    }
 
-    if (abs(xDiff) > abs(yDiff))
+    // Skip this period if the previous read is still running
+    if (sampleTransaction.status != I2C_PENDING)
     {
-        if (xDiff > DEADZONE_THRESHOLD)
+        sampleTimer = 0;
+        i2cSubmit(&sampleTransaction);
+    }
+}
+
+/**
+ * @brief Runs the joystick engine on a completed burst read.
+ *
+ * @param transaction Pointer to the completed transaction.
+ *
+ * This callback runs in interrupt context. The first byte of the burst is the stale
+ * previous conversion and is skipped.
+ */
+static void processSample(I2cTransaction *transaction)
+{
+    uint8_t *values = &transaction->rxData[1];
+    int16_t x;
+    int16_t y;
+    uint8_t axis;
+
+    if (transaction->status != I2C_OK)
+    {
+        return;
+    }
+
+    // Power-on calibration: average the resting position
+    if (centreSamples < JOYSTICK_CENTRE_SAMPLES)
+    {
+        for (axis = 0; axis < NUM_AXES; axis++)
         {
-            currentDirection = JOYSTICK_LEFT;
+            centreSum[axis] += values[axis];
         }
-        else if (xDiff < -DEADZONE_THRESHOLD)
+
+        if (++centreSamples == JOYSTICK_CENTRE_SAMPLES)
         {
-            currentDirection = JOYSTICK_RIGHT;
+            for (axis = 0; axis < NUM_AXES; axis++)
+            {
+                centre[axis] = centreSum[axis] / JOYSTICK_CENTRE_SAMPLES;
+                rawMin[axis] = (centre[axis] > INITIAL_TRAVEL) ? centre[axis] - INITIAL_TRAVEL : 0;
+                rawMax[axis] = (centre[axis] < 255 - INITIAL_TRAVEL) ? centre[axis] + INITIAL_TRAVEL : 255;
+            }
         }
+        return;
     }
-    else
+
+    // A larger raw value means left and down, so both axes are inverted
+    x = -scaleAxis(AXIS_X, values[AXIS_X]);
+    y = -scaleAxis(AXIS_Y, values[AXIS_Y]);
+
+    // Radial dead zone, so diagonals are not favoured
+    if (x * x + y * y < JOYSTICK_DEADZONE_RADIUS * JOYSTICK_DEADZONE_RADIUS)
+    {
+        x = 0;
+        y = 0;
+    }
+
+    position[AXIS_X] = x;
+    position[AXIS_Y] = y;
+
+    updateDirection();
+    updateButton(values[CHANNEL_BUTTON]);
+}
+
+/**
+ * @brief Scales a raw axis value to the proportional output range.
+ *
+ * @param axis The axis (AXIS_X or AXIS_Y).
+ * @param raw The raw converter value.
+ *
+ * @return The deflection from -JOYSTICK_FULL_SCALE to JOYSTICK_FULL_SCALE.
+ *
+ * Each side of the centre is scaled by its own learned travel, so an asymmetric stick
+ * still reaches full scale in both directions.
+ */
+static int8_t scaleAxis(const uint8_t axis, const uint8_t raw)
+{
+    // Learn the travel of the axis
+    if (raw < rawMin[axis])
+    {
+        rawMin[axis] = raw;
+    }
+    if (raw > rawMax[axis])
+    {
+        rawMax[axis] = raw;
+    }
+
+    if (raw >= centre[axis])
     {
-        if (yDiff > DEADZONE_THRESHOLD)
+        return (int16_t)(raw - centre[axis]) * JOYSTICK_FULL_SCALE / (rawMax[axis] - centre[axis] + 1);
+    }
+    return -((int16_t)(centre[axis] - raw) * JOYSTICK_FULL_SCALE / (centre[axis] - rawMin[axis] + 1));
+}
+
+/**
+ * @brief Updates the direction and raises move and auto-repeat events.
+ *
+ * A held direction repeats after JOYSTICK_REPEAT_DELAY_MS, and every repeat shortens
+ * the interval by JOYSTICK_REPEAT_STEP_MS down to JOYSTICK_REPEAT_MIN_MS.
+ */
+static void updateDirection(void)
+{
+    JOYSTICK_DIRECTION newDirection = JOYSTICK_DEADZONE;
+    int8_t x = position[AXIS_X];
+    int8_t y = position[AXIS_Y];
+    uint8_t absX = (x < 0) ? -x : x;
+    uint8_t absY = (y < 0) ? -y : y;
+
+    if (absX > absY)
+    {
+        newDirection = (x > 0) ? JOYSTICK_RIGHT : JOYSTICK_LEFT;
+    }
+    else if (absY > 0)
+    {
+        newDirection = (y > 0) ? JOYSTICK_UP : JOYSTICK_DOWN;
+    }
+
+    if (newDirection != direction)
+    {
+        direction = newDirection;
+        directionSamples = 0;
+        nextRepeat = MS_TO_SAMPLES(JOYSTICK_REPEAT_DELAY_MS);
+        repeatInterval = MS_TO_SAMPLES(JOYSTICK_REPEAT_START_MS);
+
+        if (direction != JOYSTICK_DEADZONE)
         {
-            currentDirection = JOYSTICK_DOWN;
+            pushEvent(JOYSTICK_EVENT_MOVE, direction);
         }
-        else if (yDiff < -DEADZONE_THRESHOLD)
+        return;
+    }
+
+    if (direction == JOYSTICK_DEADZONE)
+    {
+        return;
+    }
+
+    if (++directionSamples >= nextRepeat)
+    {
+        pushEvent(JOYSTICK_EVENT_REPEAT, direction);
+
+        nextRepeat = directionSamples + repeatInterval;
+        if (repeatInterval > MS_TO_SAMPLES(JOYSTICK_REPEAT_MIN_MS) + MS_TO_SAMPLES(JOYSTICK_REPEAT_STEP_MS))
+        {
+            repeatInterval -= MS_TO_SAMPLES(JOYSTICK_REPEAT_STEP_MS);
+        }
+        else
         {
-            currentDirection = JOYSTICK_UP;
+            repeatInterval = MS_TO_SAMPLES(JOYSTICK_REPEAT_MIN_MS);
         }
     }
+}
 
-    return currentDirection;
+/**
+ * @brief Debounces the button and raises pressed, released and held events.
+ *
+ * @param raw The raw value of the button channel.
+ *
+ * The press and release levels form a hysteresis, and a change is only accepted after
+ * BUTTON_DEBOUNCE_SAMPLES samples in a row agree on it.
+ */
+static void updateButton(const uint8_t raw)
+{
+    uint8_t changed;
+
+    if (button == JOYSTICK_RELEASED)
+    {
+        changed = raw > BUTTON_PRESS_LEVEL;
+    }
+    else
+    {
+        changed = raw < BUTTON_RELEASE_LEVEL;
+    }
+
+    buttonCount = changed ? buttonCount + 1 : 0;
+
+    if (buttonCount >= BUTTON_DEBOUNCE_SAMPLES)
+    {
+        buttonCount = 0;
+        buttonSamples = 0;
+        button = (button == JOYSTICK_RELEASED) ? JOYSTICK_PRESSED : JOYSTICK_RELEASED;
+        pushEvent((button == JOYSTICK_PRESSED) ? JOYSTICK_EVENT_PRESSED : JOYSTICK_EVENT_RELEASED, direction);
+    }
+    else if (button == JOYSTICK_PRESSED && ++buttonSamples == MS_TO_SAMPLES(JOYSTICK_HOLD_MS))
+    {
+        pushEvent(JOYSTICK_EVENT_HELD, direction);
+    }
 }
 
 /**
- * @brief Checks if the joystick button is pressed.
- * 
- * @return The state of the joystick button (JOYSTICK_BUTTON).
- * 
- * This function reads the ADC value from the joystick button and determines
- * if it is pressed or released based on a threshold value.
+ * @brief Appends an event to the queue; it is dropped if the queue is full.
+ *
+ * @param type The kind of event (JOYSTICK_EVENT_TYPE).
+ * @param eventDirection The direction the event refers to.
  */
-JOYSTICK_BUTTON isJoystickPressed() {
-    uint8_t adcValues[NUM_VALUES];
-    getADCValues(adcValues);
+static void pushEvent(const uint8_t type, const uint8_t eventDirection)
+{
+    uint8_t next = (eventTail + 1) % JOYSTICK_EVENT_QUEUE_LENGTH;
 
-    if (adcValues[2] < 125) {
-        return JOYSTICK_RELEASED;
-    } else {
-        return JOYSTICK_PRESSED;
+    if (next == eventHead)
+    {
+        return;
     }
+
+    events[eventTail].type = type;
+    events[eventTail].direction = eventDirection;
+    eventTail = next;
 }
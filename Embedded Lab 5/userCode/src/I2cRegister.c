@@ -0,0 +1,177 @@
+/**
+ * @file    I2cRegister.c
+ * @brief   Functions for register access to I2C devices.
+ *
+ * This file contains implementations of the register access functions. Each function
+ * describes its transfer as one or more transactions of the interrupt-driven I2C
+ * driver and waits for them, so device drivers do not touch the USCI themselves. Only
+ * i2cSubmit() and i2cWait() are used, so the layer runs on the host against a fake
+ * slave (tools/lab5_i2c_register.c).
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+#include "../inc/TwoWire.h"
+#include "../inc/I2cRegister.h"
+
+int16_t i2cWriteReg(const uint8_t addr, const uint8_t reg, const uint8_t value);
+int16_t i2cReadReg(const uint8_t addr, const uint8_t reg, uint8_t *value);
+int16_t i2cWriteBlock(const uint8_t addr, const uint8_t reg, const uint8_t *data, const uint8_t count);
+int16_t i2cReadBlock(const uint8_t addr, const uint8_t reg, uint8_t *data, const uint8_t count);
+int16_t i2cRunList(I2cTransaction *transactions, const uint8_t count);
+static int16_t runTransaction(const uint8_t addr, const uint8_t *send, const uint8_t sendCount,
+                              uint8_t *received, const uint8_t receiveCount);
+
+/**
+ * @brief Writes one register.
+ * 
+ * @param addr The 7-bit address of the slave device.
+ * @param reg The register (or control byte) to write.
+ * @param value The value to write.
+ * 
+ * @return Returns 0 on success, or a negative error code (I2C_STATUS).
+ */
+int16_t i2cWriteReg(const uint8_t addr, const uint8_t reg, const uint8_t value)
+{
+    return i2cWriteBlock(addr, reg, &value, 1);
+}
+
+/**
+ * @brief Reads one register.
+ * 
+ * @param addr The 7-bit address of the slave device.
+ * @param reg The register (or control byte) to read.
+ * @param value Pointer to where the value is stored.
+ * 
+ * @return Returns 0 on success, or a negative error code (I2C_STATUS).
+ */
+int16_t i2cReadReg(const uint8_t addr, const uint8_t reg, uint8_t *value)
+{
+    return runTransaction(addr, &reg, 1, value, 1);
+}
+
+/**
+ * @brief Writes consecutive registers in one transaction.
+ * 
+ * @param addr The 7-bit address of the slave device.
+ * @param reg The first register to write.
+ * @param data Pointer to the values to write.
+ * @param count Number of values, at most I2C_REG_MAX_BLOCK.
+ * 
+ * @return Returns 0 on success, or a negative error code (I2C_STATUS).
+ * 
+ * The register and the values have to leave the USCI back to back, so they are
+ * copied into one buffer.
+ */
+int16_t i2cWriteBlock(const uint8_t addr, const uint8_t reg, const uint8_t *data, const uint8_t count)
+{
+    uint8_t buffer[I2C_REG_MAX_BLOCK + 1];
+    uint8_t i = 0;
+
+    if (count > I2C_REG_MAX_BLOCK)
+    {
+        return I2C_ERROR_LENGTH;
+    }
+
+    buffer[0] = reg;
+    for (i = 0; i < count; i++)
+    {
+        buffer[i + 1] = data[i];
+    }
+
+    return runTransaction(addr, buffer, count + 1, 0, 0);
+}
+
+/**
+ * @brief Reads consecutive registers in one transaction.
+ * 
+ * @param addr The 7-bit address of the slave device.
+ * @param reg The first register to read.
+ * @param data Pointer to the buffer for the values.
+ * @param count Number of values to read.
+ * 
+ * @return Returns 0 on success, or a negative error code (I2C_STATUS).
+ */
+int16_t i2cReadBlock(const uint8_t addr, const uint8_t reg, uint8_t *data, const uint8_t count)
+{
+    return runTransaction(addr, &reg, 1, data, count);
+}
+
+/**
+ * @brief Runs a list of transactions one after another.
+ * 
+ * @param transactions Pointer to the transactions.
+ * @param count Number of transactions in the list.
+ * 
+ * @return Returns 0 if all transactions succeeded, otherwise the error of the first
+ *         failed transaction.
+ */
+int16_t i2cRunList(I2cTransaction *transactions, const uint8_t count)
+{
+    int16_t ret = 0;
+    int16_t status = 0;
+    uint8_t submitted = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        // Keep the driver queue filled, wait for the oldest transaction if it is full
+        while (submitted < count && i2cSubmit(&transactions[submitted]) == 0)
+        {
+            submitted++;
+        }
+
+        // Queue the transaction to wait for in any case, other users may hold the queue
+        while (submitted <= i)
+        {
+            if (i2cSubmit(&transactions[submitted]) == 0)
+            {
+                submitted++;
+            }
+        }
+
+        status = i2cWait(&transactions[i]);
+
+        if (ret == 0 && status < 0)
+        {
+            ret = status;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Runs one transaction and waits for it.
+ * 
+ * @param addr The 7-bit address of the slave device.
+ * @param send Pointer to the bytes to be transmitted.
+ * @param sendCount Number of bytes to transmit.
+ * @param received Pointer to the buffer for the received bytes.
+ * @param receiveCount Number of bytes to receive.
+ * 
+ * @return Returns 0 on success, or a negative error code (I2C_STATUS).
+ * 
+ * Unlike transferBlock(), a full driver queue is waited out instead of reported, as
+ * the joystick engine may hold a slot at any time.
+ */
+static int16_t runTransaction(const uint8_t addr, const uint8_t *send, const uint8_t sendCount,
+                              uint8_t *received, const uint8_t receiveCount)
+{
+    I2cTransaction transaction;
+
+    transaction.address = addr;
+    transaction.txData = send;
+    transaction.txCount = sendCount;
+    transaction.rxData = received;
+    transaction.rxCount = receiveCount;
+    transaction.callback = 0;
+    transaction.context = 0;
+
+    while (i2cSubmit(&transaction) != 0);
+
+    return i2cWait(&transaction);
+}
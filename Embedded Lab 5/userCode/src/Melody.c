@@ -0,0 +1,240 @@
+/**
+ * @file    Melody.c
+ * @brief   Functions for the melody format and player.
+ *
+ * This file contains the decoder of the melody format. It is the event source of the
+ * sequencer and runs in interrupt context at the end of every event; control bytes are
+ * handled in a loop until the next note or rest, so the sequencer only ever sees notes
+ * and rests.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+
+#include "../inc/Notes.h"
+#include "../inc/Sequencer.h"
+#include "../inc/Melody.h"
+
+#define DURATION_SHIFT 5
+#define INDEX_MASK 0x1F
+
+#define UNDERRUN_STEPS 1 // Rest while waiting for the next serial byte
+
+// Defined by templateEMP.h in main.c
+extern char serialAvailable(void);
+extern int serialRead(void);
+extern void serialWrite(char tx);
+
+// "Alle meine Entchen", the second line "A A A A G" is repeated
+const uint8_t entchenMelody[] = {
+    MELODY_NOTE(NOTE_C4, MELODY_QUARTER), MELODY_NOTE(NOTE_D4, MELODY_QUARTER),
+    MELODY_NOTE(NOTE_E4, MELODY_QUARTER), MELODY_NOTE(NOTE_F4, MELODY_QUARTER),
+    MELODY_NOTE(NOTE_G4, MELODY_HALF), MELODY_NOTE(NOTE_G4, MELODY_HALF),
+    MELODY_MARK,
+    MELODY_NOTE(NOTE_A4, MELODY_QUARTER), MELODY_NOTE(NOTE_A4, MELODY_QUARTER),
+    MELODY_NOTE(NOTE_A4, MELODY_QUARTER), MELODY_NOTE(NOTE_A4, MELODY_QUARTER),
+    MELODY_NOTE(NOTE_G4, MELODY_WHOLE),
+    MELODY_REPEAT(1),
+    MELODY_NOTE(NOTE_F4, MELODY_QUARTER), MELODY_NOTE(NOTE_F4, MELODY_QUARTER),
+    MELODY_NOTE(NOTE_F4, MELODY_QUARTER), MELODY_NOTE(NOTE_F4, MELODY_QUARTER),
+    MELODY_NOTE(NOTE_E4, MELODY_HALF), MELODY_NOTE(NOTE_E4, MELODY_HALF),
+    MELODY_NOTE(NOTE_D4, MELODY_QUARTER), MELODY_NOTE(NOTE_D4, MELODY_QUARTER),
+    MELODY_NOTE(NOTE_D4, MELODY_QUARTER), MELODY_NOTE(NOTE_D4, MELODY_QUARTER),
+    MELODY_NOTE(NOTE_C4, MELODY_WHOLE),
+    MELODY_END
+};
+
+// Length in steps of every duration code, 0 is the control byte
+static const uint8_t durationSteps[8] = {0, 4, 8, 12, 16, 24, 32, 64};
+
+void melodyPlay(const uint8_t *melody, SequencerCallback callback);
+void melodyPlaySerial(SequencerCallback callback);
+void melodyStreamPoll(void);
+static uint8_t nextFlashEvent(SequencerEvent *event);
+static uint8_t nextSerialEvent(SequencerEvent *event);
+static uint8_t decodeEvent(uint8_t byte, SequencerEvent *event);
+
+static const uint8_t *readPosition; /**< Next byte of a melody in flash */
+static const uint8_t *markPosition; /**< First byte after the last mark */
+static uint8_t repeatsLeft = 0;     /**< Repeats of the section still to play */
+static uint8_t repeating = 0;       /**< 1 while a section is repeated */
+static volatile uint8_t bytesTaken = 0; /**< Streamed bytes taken, written by the tick only */
+static uint8_t creditsSent = 0;         /**< Credits sent, written by the main loop only */
+
+/**
+ * @brief Starts playing a melody from flash.
+ *
+ * @param melody The melody, terminated by MELODY_END.
+ * @param callback Function called when an event starts and when the melody ends, or 0.
+ */
+void melodyPlay(const uint8_t *melody, SequencerCallback callback)
+{
+    sequencerStop();
+
+    readPosition = melody;
+    markPosition = melody;
+    repeatsLeft = 0;
+    repeating = 0;
+
+    sequencerPlayStream(nextFlashEvent, callback);
+}
+
+/**
+ * @brief Starts playing a melody from the serial interface.
+ *
+ * @param callback Function called when an event starts and when the melody ends, or 0.
+ */
+void melodyPlaySerial(SequencerCallback callback)
+{
+    sequencerStop();
+
+    bytesTaken = 0;
+    creditsSent = 0;
+
+    sequencerPlayStream(nextSerialEvent, callback);
+}
+
+/**
+ * @brief Sends the credits for the streamed bytes taken since the last call.
+ */
+void melodyStreamPoll(void)
+{
+    // Each counter has one writer, so no interrupt lock is needed; both wrap alike
+    while (creditsSent != bytesTaken)
+    {
+        serialWrite(MELODY_CREDIT); // About 1 ms at 9600 baud
+        creditsSent++;
+    }
+}
+
+/**
+ * @brief Decodes the next event of a melody in flash; the source of the sequencer.
+ *
+ * @param event The event to fill in.
+ *
+ * @return Returns 1 if there is an event, 0 at the end of the melody.
+ */
+static uint8_t nextFlashEvent(SequencerEvent *event)
+{
+    uint8_t byte;
+
+    while (1)
+    {
+        byte = *readPosition++;
+
+        if (decodeEvent(byte, event))
+        {
+            return 1;
+        }
+
+        switch (byte)
+        {
+        case MELODY_END:
+            readPosition--; // Stay at the end
+            return 0;
+        case MELODY_MARK:
+            markPosition = readPosition;
+            break;
+        case MELODY_START:
+            break;
+        default:
+            // MELODY_REPEAT(n)
+            if (!repeating)
+            {
+                repeating = 1;
+                repeatsLeft = byte - 1;
+            }
+
+            if (repeatsLeft)
+            {
+                repeatsLeft--;
+                readPosition = markPosition;
+            }
+            else
+            {
+                repeating = 0;
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Decodes the next event from the serial receive buffer; the source of the sequencer.
+ *
+ * @param event The event to fill in.
+ *
+ * @return Returns 1 if there is an event, 0 at the end of the melody.
+ */
+static uint8_t nextSerialEvent(SequencerEvent *event)
+{
+    uint8_t received;
+
+    while (1)
+    {
+        // serialRead() returns a char, bytes from 0x80 on would look like -1
+        if (!serialAvailable())
+        {
+            // Wait for the sender with a short rest
+            event->note = NOTE_REST;
+            event->duration = UNDERRUN_STEPS;
+            event->rest = 0;
+            event->harmony = NOTE_REST;
+            return 1;
+        }
+
+        received = (uint8_t)serialRead();
+        bytesTaken++; // The host may send the next byte
+
+        if (decodeEvent(received, event))
+        {
+            return 1;
+        }
+
+        // Marks and repeats cannot be replayed from the stream and are skipped
+        if (received == MELODY_END)
+        {
+            return 0;
+        }
+    }
+}
+
+/**
+ * @brief Decodes a note or rest byte.
+ *
+ * @param byte The byte of the melody.
+ * @param event The event to fill in.
+ *
+ * @return Returns 1 for a note or rest, 0 for a control byte.
+ */
+static uint8_t decodeEvent(uint8_t byte, SequencerEvent *event)
+{
+    uint8_t steps = durationSteps[byte >> DURATION_SHIFT];
+    uint8_t index = byte & INDEX_MASK;
+    uint8_t gap;
+
+    if (steps == 0)
+    {
+        return 0;
+    }
+
+    event->harmony = NOTE_REST;
+
+    if (index == 0)
+    {
+        event->note = NOTE_REST;
+        event->duration = 0;
+        event->rest = steps;
+        return 1;
+    }
+
+    // Articulation: the last eighth of the duration is silent
+    gap = steps >> 3;
+    event->note = (NOTE)(MELODY_LOWEST_NOTE + index - 1);
+    event->duration = steps - gap;
+    event->rest = gap;
+    return 1;
+}
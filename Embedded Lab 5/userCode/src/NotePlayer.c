@@ -16,9 +16,17 @@
 
 #include "../inc/Notes.h"
 #include "../inc/SoftwarePwm.h"
+#include "../inc/Sequencer.h"
+#include "../inc/Voices.h"
+#include "../inc/Dds.h"
+#include "../inc/Power.h"
 
 #include "../inc/NotePlayer.h"
 
+#if defined(NOTE_PLAYER_DDS) && !defined(NOTE_PLAYER_SOFTWARE_PWM) && SMCLK_FREQUENCY_HZ < DDS_MIN_SMCLK_HZ
+#error "NOTE_PLAYER_DDS needs SMCLK_FREQUENCY_HZ of at least DDS_MIN_SMCLK_HZ (Dds.h)"
+#endif
+
 void initNotePlayer();
 void playNote(NOTE note, unsigned int duration);
 void playNotes(NOTE *notes, unsigned int *durations, unsigned int numNotes);
@@ -26,40 +34,67 @@ void playNotes(NOTE *notes, unsigned int *durations, unsigned int numNotes);
 /**
  * @brief Initializes the note player.
  * 
- * This function initializes the note player by configuring the PWM output pin
- * and initializing the software PWM module.
+ * This function initializes the PWM output for the buzzer with a duty cycle of 50 %
+ * and the sequencer that plays the notes.
+ * By default the buzzer is driven by the timer output on P2.1. If NOTE_PLAYER_SOFTWARE_PWM
+ * is defined, the software PWM on P1.4 is used instead. With the timer output the voices
+ * for chords are set up as well: time-multiplexed on P2.1, or on P2.1 and P2.4 if
+ * NOTE_PLAYER_SEPARATE_VOICES is defined. If NOTE_PLAYER_DDS is defined, the notes are
+ * played by the synthesizer on P2.1 instead, with a sine and an envelope.
  */
 void initNotePlayer(){
+#ifdef NOTE_PLAYER_SOFTWARE_PWM
     // Set P1.4 as output
     P1DIR |= BIT4;
 
     // Initialize the PWM on P1.4
     softwarePwmInit(&P1OUT, 4);
+#else
+    // Initialize the PWM on P2.1 (TA1.1)
+    hardwarePwmInit();
+
+    // Chords of the sequencer on the same pin, or on P2.1 and P2.4
+#ifdef NOTE_PLAYER_SEPARATE_VOICES
+    initVoices(VOICE_OUTPUT_SEPARATE);
+#else
+    initVoices(VOICE_OUTPUT_MIXED);
+#endif
+#endif
+
+    softwarePwmSetDutyCycle(50);
+
+    initSequencer();
+
+#if defined(NOTE_PLAYER_DDS) && !defined(NOTE_PLAYER_SOFTWARE_PWM)
+    initDds();
+    sequencerUseDds(1);
+#endif
 };
 
 /**
  * @brief Plays a single note for a specified duration.
  * 
  * @param note The note to be played.
- * @param duration The duration for which the note should be played.
+ * @param duration The duration in seconds for which the note should be played (at most 15).
  * 
- * This function plays a single note by setting its frequency and starting the PWM.
- * It then waits for the specified duration before stopping the PWM.
+ * This function plays a single note with the sequencer at one beat per second and waits
+ * until it has ended. Use the sequencer directly to play notes without waiting.
  */
 void playNote(NOTE note, unsigned int duration){
-    uint16_t i;
-    // Set frequency and start PWM
-    softwarePwmSetFrequency(note);
-    softwarePwmStart();
+    static SequencerEvent event;
 
-    // Loop through each note
-    for (i = 0; i < duration; i++)
+    event.note = note;
+    event.duration = duration * SEQUENCER_STEPS_PER_BEAT;
+    event.rest = 0;
+
+    sequencerSetTempo(60);
+    sequencerPlay(&event, 1, 0);
+
+    while (sequencerIsPlaying())
     {
-        // Play the note
-        __delay_cycles(1000000);
+        // Wait for the note to end, the system tick wakes the CPU every millisecond
+        powerIdle();
     }
-    // Stop PWM
-    softwarePwmStop();
 }
 
 /**
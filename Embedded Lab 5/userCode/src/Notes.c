@@ -9,6 +9,9 @@
  * @version 1.0
  */
 
+#include <stdint.h>
+
+#include "../inc/SoftwarePwm.h"
 #include "../inc/Notes.h"
 
 // Array of note names
@@ -17,9 +20,40 @@ const char *noteNames[] = {"C", "D", "E", "F", "G", "A", "H", "C2"};
 // Array of notes
 const NOTE notes[] = {NOTE_C, NOTE_D, NOTE_E, NOTE_F, NOTE_G, NOTE_A, NOTE_H, NOTE_C2};
 
+// Period of every note in PWM timer clocks, rounded to the nearest count. The frequencies
+// are given in 1/100 Hz, the periods are computed by the compiler for the selected clock.
+#define NOTE_PERIOD(centiHz) ((uint16_t)((PWM_CLOCK_HZ * 100UL + (centiHz) / 2) / (centiHz)))
+
+static const uint16_t notePeriods[NUM_PITCHES] = {
+    0, // NOTE_REST
+    // Octave 3
+    NOTE_PERIOD(13081), NOTE_PERIOD(13859), NOTE_PERIOD(14683), NOTE_PERIOD(15556),
+    NOTE_PERIOD(16481), NOTE_PERIOD(17461), NOTE_PERIOD(18500), NOTE_PERIOD(19600),
+    NOTE_PERIOD(20765), NOTE_PERIOD(22000), NOTE_PERIOD(23308), NOTE_PERIOD(24694),
+    // Octave 4
+    NOTE_PERIOD(26163), NOTE_PERIOD(27718), NOTE_PERIOD(29366), NOTE_PERIOD(31113),
+    NOTE_PERIOD(32963), NOTE_PERIOD(34923), NOTE_PERIOD(36999), NOTE_PERIOD(39200),
+    NOTE_PERIOD(41530), NOTE_PERIOD(44000), NOTE_PERIOD(46616), NOTE_PERIOD(49388),
+    // Octave 5
+    NOTE_PERIOD(52325), NOTE_PERIOD(55437), NOTE_PERIOD(58733), NOTE_PERIOD(62225),
+    NOTE_PERIOD(65926), NOTE_PERIOD(69846), NOTE_PERIOD(73999), NOTE_PERIOD(78399),
+    NOTE_PERIOD(83061), NOTE_PERIOD(88000), NOTE_PERIOD(93233), NOTE_PERIOD(98777),
+    // Octave 6
+    NOTE_PERIOD(104650), NOTE_PERIOD(110873), NOTE_PERIOD(117466), NOTE_PERIOD(124451),
+    NOTE_PERIOD(131851), NOTE_PERIOD(139691), NOTE_PERIOD(147998), NOTE_PERIOD(156798),
+    NOTE_PERIOD(166122), NOTE_PERIOD(176000), NOTE_PERIOD(186466), NOTE_PERIOD(197553),
+    // Octave 7
+    NOTE_PERIOD(209300), NOTE_PERIOD(221746), NOTE_PERIOD(234932), NOTE_PERIOD(248902),
+    NOTE_PERIOD(263702), NOTE_PERIOD(279383), NOTE_PERIOD(295996), NOTE_PERIOD(313596),
+    NOTE_PERIOD(332244), NOTE_PERIOD(352000), NOTE_PERIOD(372931), NOTE_PERIOD(395107),
+    // Octave 8
+    NOTE_PERIOD(418601)
+};
+
 const char **getNoteNames();
 const NOTE *getNotes();
 const int getNumberOfNotes();
+uint16_t getNotePeriod(NOTE note);
 
 /**
  * @brief Returns a pointer to the array of note names.
@@ -53,3 +87,19 @@ const NOTE *getNotes() {
 const int getNumberOfNotes(){
     return sizeof(notes) / sizeof(notes[0]);
 }
+
+/**
+ * @brief Returns the timer period of a note.
+ * 
+ * @param note The note.
+ * 
+ * @return The period in PWM timer clocks, or 0 for NOTE_REST and unknown notes.
+ */
+uint16_t getNotePeriod(NOTE note)
+{
+    if (note >= NUM_PITCHES)
+    {
+        return 0;
+    }
+    return notePeriods[note];
+}
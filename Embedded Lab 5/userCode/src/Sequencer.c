@@ -0,0 +1,352 @@
+/**
+ * @file    Sequencer.c
+ * @brief   Functions for the non-blocking note sequencer.
+ *
+ * This file contains the implementation of the note sequencer. Every millisecond the
+ * system tick adds bpm * SEQUENCER_STEPS_PER_BEAT to an accumulator; a step has passed
+ * when the accumulator reaches one minute. This keeps every tempo exact without a
+ * division. At the end of a note the PWM is stopped for the rest, at the end of the
+ * rest the next note is started. In the synthesizer mode a note is released instead of
+ * stopped, so it fades out during the rest.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+#include <msp430.h>
+
+#include "../inc/Notes.h"
+#include "../inc/SysTick.h"
+#include "../inc/SoftwarePwm.h"
+#include "../inc/Voices.h"
+#include "../inc/Dds.h"
+#include "../inc/Sequencer.h"
+
+#define MS_PER_MINUTE 60000U
+
+#define PHASE_NOTE 0
+#define PHASE_REST 1
+
+// g' (900 ms), e' (900 ms), c' (900 ms) with 100 ms rests: 36 and 4 steps at 150 BPM
+const SequencerEvent gongMelody[] = {
+    {NOTE_G, 36, 4},
+    {NOTE_E, 36, 4},
+    {NOTE_C, 36, 4}
+};
+const uint16_t gongLength = sizeof(gongMelody) / sizeof(gongMelody[0]);
+
+void initSequencer();
+void sequencerSetTempo(uint16_t bpm);
+void sequencerSetDutyCycle(uint8_t dutyCycle);
+void sequencerUseDds(uint8_t enable);
+void sequencerPlay(const SequencerEvent *events, uint16_t count, SequencerCallback callback);
+void sequencerPlayStream(SequencerSource source, SequencerCallback callback);
+void sequencerStop();
+uint8_t sequencerIsPlaying();
+uint16_t sequencerGetPosition();
+static void sequencerTick(void);
+static void startEvent(void);
+static void advance(void);
+static void silence(void);
+static uint8_t nextEvent(void);
+
+static const SequencerEvent *melody;         /**< Events of the melody */
+static uint16_t melodyLength = 0;            /**< Number of events */
+static SequencerCallback melodyCallback = 0; /**< Progress callback, or 0 */
+static SequencerSource melodySource = 0;     /**< Source of a streamed melody, or 0 */
+static SequencerEvent streamEvent;           /**< Current event of a streamed melody */
+static const SequencerEvent *current;        /**< Event that is playing */
+static volatile uint16_t position = 0;       /**< Index of the current event */
+static volatile uint8_t playing = 0;         /**< 1 while a melody is playing */
+static uint8_t phase = PHASE_NOTE;           /**< Note or rest of the current event */
+static uint8_t stepsLeft = 0;                /**< Steps until the end of the phase */
+
+static uint16_t stepIncrement = SEQUENCER_DEFAULT_BPM * SEQUENCER_STEPS_PER_BEAT; /**< Per tick */
+static uint16_t stepAccumulator = 0;         /**< Fraction of the current step */
+static uint8_t noteDutyCycle = 50;           /**< Duty cycle of the notes in percent */
+static uint8_t useDds = 0;                   /**< 1 if the synthesizer plays the notes */
+
+/**
+ * @brief Initializes the sequencer.
+ *
+ * This function registers the sequencer with the system tick.
+ */
+void initSequencer()
+{
+    initSysTick();
+    sysTickRegister(sequencerTick);
+}
+
+/**
+ * @brief Sets the tempo.
+ *
+ * @param bpm Beats per minute, limited to 1 to SEQUENCER_MAX_BPM.
+ */
+void sequencerSetTempo(uint16_t bpm)
+{
+    if (bpm == 0)
+    {
+        bpm = 1;
+    }
+    else if (bpm > SEQUENCER_MAX_BPM)
+    {
+        bpm = SEQUENCER_MAX_BPM;
+    }
+
+    // A single 16-bit store, so the tick never sees half a value
+    stepIncrement = bpm * SEQUENCER_STEPS_PER_BEAT;
+}
+
+/**
+ * @brief Sets the duty cycle used for the notes.
+ *
+ * @param dutyCycle Duty cycle in percent (0-100).
+ */
+void sequencerSetDutyCycle(uint8_t dutyCycle)
+{
+    noteDutyCycle = dutyCycle;
+}
+
+/**
+ * @brief Selects the synthesizer or the PWM for the notes.
+ *
+ * @param enable 1 to play the notes with the synthesizer, 0 for the PWM and the voices.
+ */
+void sequencerUseDds(uint8_t enable)
+{
+    sequencerStop();
+    ddsStop();
+    useDds = enable;
+}
+
+/**
+ * @brief Starts playing a melody.
+ *
+ * @param events Pointer to the events.
+ * @param count Number of events.
+ * @param callback Function called when an event starts and when the melody ends, or 0.
+ */
+void sequencerPlay(const SequencerEvent *events, uint16_t count, SequencerCallback callback)
+{
+    uint16_t interruptState;
+
+    sequencerStop();
+
+    melody = events;
+    melodyLength = count;
+    melodySource = 0;
+    melodyCallback = callback;
+    position = 0;
+    stepAccumulator = 0;
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Start the first note without the tick running in between
+    interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    playing = 1;
+    startEvent();
+    __set_interrupt_state(interruptState);
+}
+
+/**
+ * @brief Starts playing a melody supplied event by event.
+ *
+ * @param source Function that returns the next event.
+ * @param callback Function called when an event starts and when the melody ends, or 0.
+ */
+void sequencerPlayStream(SequencerSource source, SequencerCallback callback)
+{
+    uint16_t interruptState;
+
+    sequencerStop();
+
+    melodySource = source;
+    melodyCallback = callback;
+    position = 0;
+    stepAccumulator = 0;
+
+    if (!source(&streamEvent))
+    {
+        return;
+    }
+
+    // Start the first note without the tick running in between
+    interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    playing = 1;
+    startEvent();
+    __set_interrupt_state(interruptState);
+}
+
+/**
+ * @brief Stops the melody and silences the buzzer.
+ */
+void sequencerStop()
+{
+    uint16_t interruptState = __get_interrupt_state();
+
+    __disable_interrupt();
+    playing = 0;
+    silence();
+    __set_interrupt_state(interruptState);
+}
+
+/**
+ * @brief Checks whether a melody is playing.
+ *
+ * @return Returns 1 while a melody is playing, 0 otherwise.
+ */
+uint8_t sequencerIsPlaying()
+{
+    return playing;
+}
+
+/**
+ * @brief Returns the index of the event that is playing.
+ *
+ * @return The event index; the number of events once the melody has ended.
+ */
+uint16_t sequencerGetPosition()
+{
+    return position;
+}
+
+/**
+ * @brief Advances the melody by one millisecond; called from the system tick.
+ */
+static void sequencerTick(void)
+{
+    if (!playing)
+    {
+        return;
+    }
+
+    stepAccumulator += stepIncrement;
+    if (stepAccumulator < MS_PER_MINUTE)
+    {
+        return;
+    }
+    stepAccumulator -= MS_PER_MINUTE;
+
+    if (stepsLeft > 1)
+    {
+        stepsLeft--;
+        return;
+    }
+
+    advance();
+}
+
+/**
+ * @brief Starts the note of the event at the current position.
+ */
+static void startEvent(void)
+{
+    const SequencerEvent *event = melodySource ? &streamEvent : &melody[position];
+    uint16_t period = getNotePeriod(event->note);
+
+    current = event;
+    phase = PHASE_NOTE;
+    stepsLeft = event->duration;
+
+    silence();
+
+    if (useDds)
+    {
+        // The synthesizer has one voice, the harmony is left out
+        if (period != 0 && event->duration != 0)
+        {
+            ddsNoteOn(event->note);
+        }
+    }
+    else if (period != 0 && event->duration != 0)
+    {
+        // A chord on the voices; without them only the main note is played
+        voicesSetNote(0, event->note);
+        voicesSetNote(1, event->harmony);
+
+        if (event->harmony == NOTE_REST || !voicesStart())
+        {
+            softwarePwmSetPeriod(period);
+            softwarePwmSetDutyCycle(noteDutyCycle);
+            softwarePwmStart();
+        }
+    }
+
+    if (melodyCallback)
+    {
+        melodyCallback(position);
+    }
+
+    // Skip an empty note directly to its rest
+    if (stepsLeft == 0)
+    {
+        advance();
+    }
+}
+
+/**
+ * @brief Moves from a note to its rest, or from a rest to the next event.
+ */
+static void advance(void)
+{
+    if (phase == PHASE_NOTE && current->rest > 0)
+    {
+        phase = PHASE_REST;
+        stepsLeft = current->rest;
+        silence();
+        return;
+    }
+
+    position++;
+
+    if (!nextEvent())
+    {
+        playing = 0;
+        silence();
+
+        if (melodyCallback)
+        {
+            melodyCallback(position);
+        }
+        return;
+    }
+
+    startEvent();
+}
+
+/**
+ * @brief Fetches the event at the new position.
+ *
+ * @return Returns 1 if there is an event, 0 at the end of the melody.
+ */
+static uint8_t nextEvent(void)
+{
+    if (melodySource)
+    {
+        return melodySource(&streamEvent);
+    }
+
+    return position < melodyLength;
+}
+
+/**
+ * @brief Silences the PWM and the voices, or releases the note of the synthesizer.
+ */
+static void silence(void)
+{
+    if (useDds)
+    {
+        ddsNoteOff();
+        return;
+    }
+
+    voicesStop();
+    softwarePwmStop();
+}
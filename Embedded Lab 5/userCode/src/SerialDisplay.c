@@ -5,43 +5,107 @@
  * This file contains implementations of functions related to serial display operations.
  * It includes functions to clear the terminal screen, display notes, tone selection, and playing tone.
  *
+ * The functions draw into a model of the terminal screen that holds what the terminal
+ * shows. Only cells that differ from the model are sent, with a cursor move in front of
+ * every run of changed cells; short gaps between runs are sent again as they are cheaper
+ * than a move. A change of the selection thus costs about 18 bytes instead of the
+ * whole screen.
+ *
  * @date    25.05.2024
  * @authors Bjoern Metzger & Daniel Korobow
  * @version 1.0
  */
 
 
-#include <stdio.h>
 #include <stdint.h>
 
 #include "../inc/Notes.h"
 
 #include "../inc/SerialDisplay.h"
 
+#define SCREEN_ROWS 2      // Status line and note line
+#define SCREEN_COLS 32     // Eight notes of NOTE_CELL_WIDTH columns
+#define NOTE_CELL_WIDTH 4  // Columns of a note name
+#define STATUS_ROW 0
+#define NOTES_ROW 1
+#define CONSOLE_ROW 3      // Below the screen with a blank line in between
+
+#define ATTR_HIGHLIGHT 0x80 // Stored in the top bit of a cell, the characters are ASCII
+#define CHAR_MASK 0x7F
+
+#define POSITION_UNKNOWN 0xFF
+#define CURSOR_MOVE_COST 6  // Bytes of "ESC[r;cH", shorter gaps are sent again instead
+
+// Defined by templateEMP.h in main.c
+extern void serialWrite(char tx);
+extern void serialPrint(char *tx);
+
 void displayNotes(NOTE currentNote);
 void displayToneSelection(TONE currentTone);
 void displayPlayingTone(TONE currentTone);
 void clearScreen();
+void displayParkCursor();
+static void drawText(uint8_t row, uint8_t col, const char *text, uint8_t width, uint8_t attr);
+static void drawStatus(const char *text, TONE tone);
+static void putCell(uint8_t row, uint8_t col, uint8_t cell);
+static void moveCursor(uint8_t row, uint8_t col);
+static void writeNumber(uint8_t number);
+
+static uint8_t screen[SCREEN_ROWS][SCREEN_COLS]; /**< Cells shown by the terminal */
+static uint8_t cursorRow = POSITION_UNKNOWN;     /**< Row of the terminal cursor */
+static uint8_t cursorCol = POSITION_UNKNOWN;     /**< Column of the terminal cursor */
+static uint8_t currentAttr = 0;                  /**< Attribute the terminal writes with */
 
 /**
  * @brief Clears the terminal screen.
- * 
+ *
  * This function sends an escape sequence to the terminal to clear the screen
- * and move the cursor to the home position.
+ * and move the cursor to the home position. The screen model is cleared with it; this
+ * is only needed once, later updates send the changed cells only.
  */
 void clearScreen()
 {
-    serialPrintln("\033[2J\033[H");
+    uint8_t row;
+    uint8_t col;
+
+    serialPrint("\033[0m\033[2J\033[H");
+
+    for (row = 0; row < SCREEN_ROWS; row++)
+    {
+        for (col = 0; col < SCREEN_COLS; col++)
+        {
+            screen[row][col] = ' ';
+        }
+    }
+
+    cursorRow = 0;
+    cursorCol = 0;
+    currentAttr = 0;
+}
+
+/**
+ * @brief Moves the cursor below the screen and clears the rest of the terminal.
+ *
+ * Other output, e.g. of the console, then appears below the screen. The cursor position
+ * is unknown afterwards, so the next update starts with a cursor move.
+ */
+void displayParkCursor()
+{
+    moveCursor(CONSOLE_ROW, 0);
+    serialPrint("\033[0m\033[J");
+
+    cursorRow = POSITION_UNKNOWN;
+    cursorCol = POSITION_UNKNOWN;
+    currentAttr = 0;
 }
 
 /**
- * @brief Displays the notes with the currently selected note indicated by a '#'.
- * 
+ * @brief Displays the notes with the currently selected note highlighted.
+ *
  * @param currentNote The currently selected note to be indicated.
- * 
- * This function retrieves the list of notes and their names, and then constructs
- * a string where the currently selected note is indicated by a '#'. The string
- * is then printed to the terminal.
+ *
+ * This function draws every note name into a cell of NOTE_CELL_WIDTH columns in one
+ * pass; the cell of the selected note is shown in inverse video.
  */
 void displayNotes(NOTE currentNote)
 {
@@ -50,51 +114,171 @@ void displayNotes(NOTE currentNote)
     const NOTE *notes = getNotes();
     uint16_t numNotes = getNumberOfNotes();
 
-    char buffer[128] = ""; // Increase size if necessary
-    char temp[16];
+    for (i = 0; i < numNotes && (i + 1) * NOTE_CELL_WIDTH <= SCREEN_COLS; i++)
+    {
+        drawText(NOTES_ROW, i * NOTE_CELL_WIDTH, noteNames[i], NOTE_CELL_WIDTH,
+                 notes[i] == currentNote ? ATTR_HIGHLIGHT : 0);
+    }
+}
+
+/**
+ * @brief Displays the currently selected tone.
+ *
+ * @param currentTone The currently selected tone.
+ *
+ * This function shows the number of the tone being selected in the status line.
+ */
+void displayToneSelection(TONE currentTone)
+{
+    drawStatus("Auswahl von Ton # ", currentTone);
+}
+
+/**
+ * @brief Displays a message indicating the playing note.
+ *
+ * @param currentTone The tone currently being played.
+ *
+ * This function shows the number of the note being played in the status line.
+ */
+void displayPlayingTone(TONE currentTone)
+{
+    drawStatus("Playing Note # ", currentTone);
+}
+
+/**
+ * @brief Draws a text into a row, padded with spaces.
+ *
+ * @param row The row.
+ * @param col The first column.
+ * @param text The text, cut off at the width.
+ * @param width The number of columns to fill.
+ * @param attr ATTR_HIGHLIGHT or 0.
+ */
+static void drawText(uint8_t row, uint8_t col, const char *text, uint8_t width, uint8_t attr)
+{
+    uint8_t i;
 
-    for (i = 0; i < numNotes; i++)
+    for (i = 0; i < width && col < SCREEN_COLS; i++, col++)
     {
-        if (notes[i] == currentNote)
+        if (*text)
         {
-            snprintf(temp, sizeof(temp), "# ");
+            putCell(row, col, (*text++ & CHAR_MASK) | attr);
         }
         else
         {
-            snprintf(temp, sizeof(temp), "%s ", noteNames[i]);
+            putCell(row, col, ' ' | attr);
         }
-        strncat(buffer, temp, sizeof(buffer) - strlen(buffer) - 1);
     }
+}
+
+/**
+ * @brief Draws the status line: a text followed by the 1-based tone number.
+ *
+ * @param text The text in front of the number.
+ * @param tone The tone, shown as tone + 1.
+ */
+static void drawStatus(const char *text, TONE tone)
+{
+    char number[4];
+    uint8_t col = 0;
+    uint8_t value = tone + 1;
 
-    serialPrintln(buffer);
+    while (*text && col < SCREEN_COLS)
+    {
+        putCell(STATUS_ROW, col++, *text++ & CHAR_MASK);
+    }
+
+    // At most two digits, NUM_TONES is small
+    if (value >= 10)
+    {
+        number[0] = '0' + value / 10;
+        number[1] = '0' + value % 10;
+        number[2] = '\0';
+    }
+    else
+    {
+        number[0] = '0' + value;
+        number[1] = '\0';
+    }
+
+    drawText(STATUS_ROW, col, number, SCREEN_COLS - col, 0);
 }
 
 /**
- * @brief Displays the currently selected tone.
- * 
- * @param currentTone The currently selected tone.
- * 
- * This function prints a message to the terminal indicating the currently
- * selected tone number.
+ * @brief Sets a cell and sends it if the terminal shows something else.
+ *
+ * @param row The row.
+ * @param col The column.
+ * @param cell The character with its attribute in the top bit.
  */
-void displayToneSelection(TONE currentTone)
+static void putCell(uint8_t row, uint8_t col, uint8_t cell)
+{
+    uint8_t attr = cell & ATTR_HIGHLIGHT;
+
+    if (screen[row][col] == cell)
+    {
+        return;
+    }
+
+    // Sending a few unchanged cells again is cheaper than a cursor move
+    if (row == cursorRow && col > cursorCol && col - cursorCol < CURSOR_MOVE_COST)
+    {
+        while (cursorCol < col && (screen[row][cursorCol] & ATTR_HIGHLIGHT) == currentAttr)
+        {
+            serialWrite(screen[row][cursorCol++] & CHAR_MASK);
+        }
+    }
+
+    if (row != cursorRow || col != cursorCol)
+    {
+        moveCursor(row, col);
+    }
+
+    if (attr != currentAttr)
+    {
+        serialPrint(attr ? "\033[7m" : "\033[0m");
+        currentAttr = attr;
+    }
+
+    serialWrite(cell & CHAR_MASK);
+    screen[row][col] = cell;
+
+    // The terminal moves on by one column
+    cursorCol = col + 1;
+}
+
+/**
+ * @brief Moves the terminal cursor.
+ *
+ * @param row The row, 0-based.
+ * @param col The column, 0-based.
+ */
+static void moveCursor(uint8_t row, uint8_t col)
 {
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "Auswahl von Ton # %d", currentTone + 1);
-    serialPrintln(buffer);
+    serialPrint("\033[");
+    writeNumber(row + 1);
+    serialWrite(';');
+    writeNumber(col + 1);
+    serialWrite('H');
+
+    cursorRow = row;
+    cursorCol = col;
 }
 
 /**
- * @brief Displays a message indicating the playing note.
- * 
- * @param currentTone The tone currently being played.
- * 
- * This function prints a message to the terminal indicating the note number
- * currently being played.
+ * @brief Sends a number of up to three digits without a buffer.
+ *
+ * @param number The number.
  */
-void displayPlayingTone(TONE currentTone)
+static void writeNumber(uint8_t number)
 {
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "Playing Note # %d", currentTone + 1);
-    serialPrintln(buffer);
+    if (number >= 100)
+    {
+        serialWrite('0' + number / 100);
+    }
+    if (number >= 10)
+    {
+        serialWrite('0' + (number / 10) % 10);
+    }
+    serialWrite('0' + number % 10);
 }
@@ -2,8 +2,10 @@
  * @file    SoftwarePwm.c
  * @brief   Functions for software-based PWM generation.
  *
- * This file contains implementations of functions related to software-based PWM generation.
- * It includes functions to initialize the PWM, set frequency and duty cycle, start and stop PWM.
+ * This file contains implementations of functions related to PWM generation with Timer1_A
+ * in up mode. TA1CCR0 holds the period and TA1CCR1 the high time. In hardware mode the
+ * output unit of CCR1 runs in Reset/Set mode and drives P2.1 without any interrupt. In
+ * software mode the CCR0 interrupt sets the pin and the CCR1 interrupt clears it.
  *
  * @date    25.05.2024
  * @authors Bjoern Metzger & Daniel Korobow
@@ -12,48 +14,73 @@
 
 #include <stdint.h>
 #include <msp430.h>
+#include "../inc/SystemClock.h"
 #include "../inc/SoftwarePwm.h"
+#include "../inc/Voices.h"
+#include "../inc/Dds.h"
 
-// Global variables to store port and pin
-volatile unsigned char *pwmPort;
-unsigned char pwmPin;
+#define DEFAULT_DUTY_CYCLE 50
 
+#define DUTY_CYCLE_ONE 256 // Fixed-point 100 %, so the high time needs no division
+
+// Output of the software mode; no port selects the hardware mode
+static volatile unsigned char *pwmPort = 0;
+static unsigned char pwmMask = 0;             /**< Pin mask, so the ISR needs no shift */
+static uint16_t pwmDutyFraction = DEFAULT_DUTY_CYCLE * DUTY_CYCLE_ONE / 100; /**< Duty cycle in 1/256 */
+
+void hardwarePwmInit();
 void softwarePwmInit(volatile unsigned char *port, unsigned char pin);
 void softwarePwmSetFrequency(uint16_t freq);
+void softwarePwmSetPeriod(uint16_t period);
 void softwarePwmSetDutyCycle(uint16_t dutyCycle);
 void softwarePwmStart();
 void softwarePwmStop();
+static void updateHighTime(void);
 
 /**
- * @brief Initializes Timer1 for PWM operation.
- * 
- * @param port Pointer to the port register.
+ * @brief Initializes Timer1 for hardware PWM on P2.1.
+ *
+ * This function routes the TA1.1 output to P2.1. The output unit is kept in output mode
+ * with the output low until the PWM is started.
+ */
+void hardwarePwmInit()
+{
+    pwmPort = 0;
+
+    // Stop Timer1
+    TA1CTL = TASSEL_2 | PWM_CLOCK_DIVIDER_BITS | TACLR;
+
+    // Output low while stopped
+    TA1CCTL1 = OUTMOD_0;
+
+    // Select the TA1.1 function of P2.1
+    P2DIR |= PWM_HARDWARE_PIN;
+    P2SEL |= PWM_HARDWARE_PIN;
+    P2SEL2 &= ~PWM_HARDWARE_PIN;
+}
+
+/**
+ * @brief Initializes Timer1 for software PWM operation.
+ *
+ * @param port Pointer to the port output register.
  * @param pin The pin number for PWM output.
- * 
- * This function initializes Timer1 for PWM operation. It configures the specified pin
- * on the specified port as an output and sets Timer1 to Up Mode with Capture/Compare
- * interrupt enabled.
+ *
+ * This function initializes Timer1 for software PWM operation on the specified pin
+ * of the specified port. The interrupts are enabled when the PWM is started.
  */
 void softwarePwmInit(volatile unsigned char *port, unsigned char pin)
 {
     // Save port and pin information
     pwmPort = port;
-    pwmPin = pin;
-
-    // Set pin as output
-    *port |= (1 << pin);
+    pwmMask = 1 << pin;
 
     // Stop Timer1
-    TA1CTL = 0;
-
-    // Set Timer1 to Up Mode
-    TA1CTL |= TASSEL_2 | MC_1;
+    TA1CTL = TASSEL_2 | PWM_CLOCK_DIVIDER_BITS | TACLR;
+    TA1CCTL0 = 0;
+    TA1CCTL1 = 0;
 
-    // Set the output mode to Reset/Set
-    TA1CCTL1 |= OUTMOD_7;
-
-    // Enable Timer1 Capture/Compare interrupt
-    TA1CCTL1 |= CCIE;
+    // Start with the pin low
+    *pwmPort &= ~pwmMask;
 }
 
 /**
@@ -62,68 +89,135 @@ void softwarePwmInit(volatile unsigned char *port, unsigned char pin)
  * @param freq The desired frequency in Hz.
  * 
  * This function sets the PWM frequency by calculating the period based on the
- * desired frequency and setting the Timer1 Capture/Compare register accordingly.
+ * desired frequency. Notes should use softwarePwmSetPeriod() with the note table,
+ * which avoids the division.
  */
 void softwarePwmSetFrequency(uint16_t freq)
 {
-    // Calculate the period based on frequency
-    uint16_t period = 1000000 / freq; // 1 MHz clock source
+    softwarePwmSetPeriod(PWM_CLOCK_HZ / freq);
+}
 
+/**
+ * @brief Sets the PWM period.
+ * 
+ * @param period The period in PWM timer clocks.
+ * 
+ * This function sets the Timer1 Capture/Compare registers for the given period.
+ */
+void softwarePwmSetPeriod(uint16_t period)
+{
     // Set the period
     TA1CCR0 = period - 1;
+    updateHighTime();
 }
 
 /**
  * @brief Sets the PWM duty cycle.
- * 
+ *
  * @param dutyCycle The desired duty cycle as a percentage (0-100).
- * 
- * This function sets the PWM duty cycle by calculating the duty cycle value
- * and setting the Timer1 Capture/Compare register accordingly.
+ *
+ * This function stores the duty cycle as a fraction of 256 and sets the Timer1
+ * Capture/Compare register accordingly.
  */
 void softwarePwmSetDutyCycle(uint16_t dutyCycle)
 {
-    // Calculate the duty cycle value
-    uint16_t dutyValue = (TA1CCR0 + 1) * dutyCycle / 100;
-
-    // Set the duty cycle
-    TA1CCR1 = dutyValue;
+    pwmDutyFraction = (dutyCycle * DUTY_CYCLE_ONE + 50) / 100;
+    updateHighTime();
 }
 
 /**
  * @brief Starts the PWM operation.
- * 
- * This function starts Timer1 for PWM operation.
+ *
+ * This function starts Timer1 from the beginning of a period.
  */
 void softwarePwmStart()
 {
-    // Start Timer1
-    TA1CTL |= MC_1;
+    if (pwmPort)
+    {
+        // Set the pin at CCR0 and clear it at CCR1
+        TA1CCTL0 = CCIE;
+        TA1CCTL1 = CCIE;
+    }
+    else
+    {
+        // Reset at CCR1, set at CCR0
+        TA1CCTL1 = OUTMOD_7;
+    }
+
+    // Start Timer1 in Up Mode
+    TA1CTL = TASSEL_2 | PWM_CLOCK_DIVIDER_BITS | MC_1 | TACLR;
 }
 
 /**
  * @brief Stops the PWM operation.
- * 
- * This function stops Timer1 to halt PWM operation.
+ *
+ * This function stops Timer1 and drives the output low, so the buzzer is not left
+ * with a DC level.
  */
 void softwarePwmStop()
 {
     // Stop Timer1
     TA1CTL &= ~MC_3;
+
+    if (pwmPort)
+    {
+        TA1CCTL0 = 0;
+        TA1CCTL1 = 0;
+        *pwmPort &= ~pwmMask;
+    }
+    else
+    {
+        TA1CCTL1 = OUTMOD_0;
+    }
 }
 
 /**
- * @brief Timer1 Capture/Compare interrupt service routine.
- * 
- * This ISR toggles the specified pin on the specified port when Timer1 Capture/Compare
- * interrupt occurs.
+ * @brief Sets the high time from the period and the stored duty cycle.
  */
-#pragma vector = TIMER1_A1_VECTOR
-__interrupt void timer1ISR(void)
+static void updateHighTime(void)
+{
+    TA1CCR1 = ((uint32_t)(TA1CCR0 + 1) * pwmDutyFraction) >> 8;
+}
+
+/**
+ * @brief Timer1 CCR0 interrupt service routine, start of a software PWM period.
+ */
+#pragma vector = TIMER1_A0_VECTOR
+__interrupt void pwmPeriodISR(void)
 {
-    // Toggle specified pin on specified port
-    *pwmPort ^= (1 << pwmPin);
+    *pwmPort |= pwmMask;
+}
 
-    // Clear the interrupt flag
-    TA1CCTL1 &= ~CCIFG;
+/**
+ * @brief Timer1 CCR1/CCR2 interrupt service routine, end of the high time.
+ *
+ * Reading TA1IV clears the interrupt flag. The voices (Voices.h) and the synthesizer
+ * (Dds.h) share this vector, their compare events are passed on while they play. The
+ * synthesizer is checked first, as its compare value is due within the carrier period.
+ */
+#pragma vector = TIMER1_A1_VECTOR
+__interrupt void pwmHighTimeISR(void)
+{
+    uint16_t vector = TA1IV;
+
+    if (ddsIsPlaying())
+    {
+        ddsInterrupt();
+        return;
+    }
+
+    if (voicesIsPlaying())
+    {
+        voicesInterrupt(vector);
+        return;
+    }
+
+    switch (vector)
+    {
+    case TA1IV_TACCR1:
+        *pwmPort &= ~pwmMask;
+        break;
+    default:
+        break;
+    }
 }
@@ -0,0 +1,104 @@
+/**
+ * @file    SysTick.c
+ * @brief   Functions for the millisecond system tick.
+ *
+ * This file contains the implementation of the 1 ms system tick. Timer0_A counts SMCLK
+ * in up mode and its CCR0 interrupt increments the tick count and calls all registered
+ * tick handlers. Timer1_A stays free for the buzzer PWM.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+#include <msp430.h>
+#include "../inc/SystemClock.h"
+#include "../inc/SysTick.h"
+#include "../inc/Power.h"
+
+void initSysTick();
+int16_t sysTickRegister(SysTickHandler handler);
+uint16_t getSysTicks();
+
+static volatile uint16_t sysTicks = 0;                  /**< Milliseconds since initSysTick() */
+static SysTickHandler handlers[SYSTICK_MAX_HANDLERS];   /**< Registered tick handlers */
+static uint8_t numHandlers = 0;                         /**< Number of registered handlers */
+
+/**
+ * @brief Initializes the system tick.
+ * 
+ * This function starts Timer0_A in up mode from SMCLK with a period of 1 ms and enables
+ * the CCR0 interrupt. Global interrupts are enabled as well.
+ */
+void initSysTick()
+{
+    // Already running
+    if (TA0CTL & MC_1)
+    {
+        return;
+    }
+
+    TA0CCR0 = SMCLK_CYCLES_PER_MS - 1;
+    TA0CCTL0 = CCIE;
+    TA0CTL = TASSEL_2 | MC_1 | TACLR;
+
+    // The tick runs for good, so the CPU sleeps no deeper than LPM0
+    powerRequire(POWER_SMCLK);
+
+    __enable_interrupt();
+}
+
+/**
+ * @brief Registers a function that is called on every tick.
+ * 
+ * @param handler The function to call.
+ * 
+ * @return Returns 0 on success, or -1 if all handler slots are in use.
+ */
+int16_t sysTickRegister(SysTickHandler handler)
+{
+    if (numHandlers >= SYSTICK_MAX_HANDLERS)
+    {
+        return -1;
+    }
+
+    handlers[numHandlers] = handler;
+
+    // Publish the handler only after it is stored, the interrupt may already run
+    numHandlers++;
+
+    return 0;
+}
+
+/**
+ * @brief Returns the number of milliseconds since initSysTick().
+ * 
+ * @return The tick count.
+ */
+uint16_t getSysTicks()
+{
+    return sysTicks;
+}
+
+/**
+ * @brief Timer0 CCR0 interrupt service routine.
+ * 
+ * This ISR is triggered every millisecond. It increments the tick count and calls all
+ * registered tick handlers.
+ */
+#pragma vector = TIMER0_A0_VECTOR
+__interrupt void sysTickISR(void)
+{
+    uint8_t i;
+
+    sysTicks++;
+
+    for (i = 0; i < numHandlers; i++)
+    {
+        handlers[i]();
+    }
+
+    // The handlers raise the events of the main loop, it checks them once per tick
+    POWER_WAKE_ON_EXIT();
+}
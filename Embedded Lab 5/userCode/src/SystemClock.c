@@ -0,0 +1,75 @@
+/**
+ * @file    SystemClock.c
+ * @brief   Functions for the system clock configuration.
+ *
+ * This file contains the implementation of the system clock selection. The DCO is set
+ * from the factory calibration constants for SMCLK_FREQUENCY_HZ and the UART divider
+ * is recalculated for 9600 baud (values from the USCI baud rate table, UCOS16 = 0).
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <msp430g2553.h>
+#include <stdint.h>
+#include "../inc/SystemClock.h"
+
+#if SMCLK_FREQUENCY_HZ == 1000000UL
+#define CALBC1_VALUE CALBC1_1MHZ
+#define CALDCO_VALUE CALDCO_1MHZ
+#define UART_DIVIDER 104
+#define UART_MODULATION UCBRS_1
+#elif SMCLK_FREQUENCY_HZ == 8000000UL
+#define CALBC1_VALUE CALBC1_8MHZ
+#define CALDCO_VALUE CALDCO_8MHZ
+#define UART_DIVIDER 833
+#define UART_MODULATION UCBRS_2
+#elif SMCLK_FREQUENCY_HZ == 12000000UL
+#define CALBC1_VALUE CALBC1_12MHZ
+#define CALDCO_VALUE CALDCO_12MHZ
+#define UART_DIVIDER 1250
+#define UART_MODULATION UCBRS_0
+#elif SMCLK_FREQUENCY_HZ == 16000000UL
+#define CALBC1_VALUE CALBC1_16MHZ
+#define CALDCO_VALUE CALDCO_16MHZ
+#define UART_DIVIDER 1666
+#define UART_MODULATION UCBRS_6
+#else
+#error "SMCLK_FREQUENCY_HZ must be 1000000UL, 8000000UL, 12000000UL or 16000000UL"
+#endif
+
+void initSystemClock();
+
+/**
+ * @brief Switches the DCO to SMCLK_FREQUENCY_HZ.
+ * 
+ * This function loads the calibration constants of the selected frequency and adapts
+ * the UART divider. Like initMSP(), it stops if the constants were erased.
+ */
+void initSystemClock()
+{
+    // If the calibration constants were erased, stop here.
+    if (CALBC1_VALUE == 0xFF || CALDCO_VALUE == 0xFF)
+    {
+        while (1);
+    }
+
+    // Let the UART finish the byte it is sending
+    while (UCA0STAT & UCBUSY);
+
+    // Lowest DCO setting first, so the range change never overshoots
+    DCOCTL = 0;
+    BCSCTL1 = CALBC1_VALUE;
+    DCOCTL = CALDCO_VALUE;
+
+    // 9600 baud from the new SMCLK
+    UCA0CTL1 |= UCSWRST;
+    UCA0BR0 = UART_DIVIDER & 0xFF;
+    UCA0BR1 = UART_DIVIDER >> 8;
+    UCA0MCTL = UART_MODULATION;
+    UCA0CTL1 &= ~UCSWRST;
+
+    // The reset has disabled the receive interrupt
+    IE2 |= UCA0RXIE;
+}
@@ -3,8 +3,11 @@
  * @brief   Functions for I2C communication.
  *
  * This file contains implementations of functions related to I2C communication.
- * It includes functions to initialize the I2C interface, transfer bytes over I2C,
- * and handle I2C communication errors.
+ * The USCI_B0 module is driven by an interrupt-driven state machine that works through
+ * a queue of transactions. The data interrupts (TX/RX) run the transfer, the status
+ * interrupts report a NACK or a lost arbitration, and the system tick aborts a
+ * transaction that does not end within I2C_TIMEOUT_MS. After a timeout the bus is
+ * recovered by clocking SCL until the slave releases SDA.
  *
  * @date    25.05.2024
  * @authors Bjoern Metzger & Daniel Korobow
@@ -12,180 +15,474 @@
  */
 
 #include <msp430g2553.h>
-#include <stdlib.h>
 #include <stdint.h>
+#include "../inc/SystemClock.h"
+#include "../inc/SysTick.h"
 #include "../inc/TwoWire.h"
 
+#define SCL_PIN BIT6 // P1.6
+#define SDA_PIN BIT7 // P1.7
+
+#define RECOVERY_CLOCKS 9                              // A slave holding SDA releases it after at most 9 clocks
+#define RECOVERY_HALF_PERIOD (5 * SMCLK_CYCLES_PER_US) // Half SCL period of 5 us, 100 kHz
+#define WAIT_LIMIT 1000                                // Upper bound for the short busy waits on the USCI
+
 // Function prototypes
 void initI2C(void);
+uint32_t i2cSetSpeed(const uint32_t speedHz);
+int16_t i2cSubmit(I2cTransaction *transaction);
+int16_t i2cWait(I2cTransaction *transaction);
+uint8_t i2cIsIdle(void);
+void i2cStatusInterrupt(void);
 int16_t transferByte(const uint8_t addr, const uint8_t send);
-static int16_t transmit(const uint8_t addr, const uint8_t send);
-static int16_t receive(const uint8_t addr);
-static int16_t checkAck(void);
+int16_t transferBlock(const uint8_t addr, const uint8_t *send, const uint8_t sendCount,
+                      uint8_t *received, const uint8_t receiveCount);
+static void configureUsci(void);
+static void recoverBus(void);
+static void waitWhileSet(const uint8_t bits);
+static void startNext(void);
+static void startReceive(I2cTransaction *transaction);
+static void finish(const int16_t status);
+static void i2cTick(void);
+
+static I2cTransaction *queue[I2C_QUEUE_LENGTH]; /**< Queued transactions, the head is running */
+static volatile uint8_t queueHead = 0;          /**< Index of the oldest queued transaction */
+static volatile uint8_t queueCount = 0;         /**< Number of queued transactions */
+static volatile uint8_t active = 0;             /**< 1 while the head transaction runs */
+static volatile uint8_t elapsedMs = 0;          /**< Run time of the active transaction */
+static uint8_t txIndex = 0;                     /**< Next byte to write */
+static uint8_t rxIndex = 0;                     /**< Next byte to read */
+static uint16_t prescaler = 0;                  /**< SMCLK cycles per SCL period */
 
 /**
  * @brief Initializes the I2C interface.
- * 
- * This function configures the specified pins for I2C communication and initializes
- * the USCI_B0 module for I2C master mode operation.
+ *
+ * This function configures the specified pins for I2C communication, initializes
+ * the USCI_B0 module for interrupt-driven I2C master mode operation and registers
+ * the timeout handler with the system tick.
  */
 void initI2C(void)
 {
-    // Configure P1.6 and P1.7 for I2C
-    P1SEL  |= BIT6 + BIT7;
-    P1SEL2 |= BIT6 + BIT7;
-    
-    // Ensure USCI_B0 is in reset before configuring
-    UCB0CTL1 = UCSWRST;
+    i2cSetSpeed(I2C_SPEED_HZ);
 
-    // Set USCI_B0 to master mode I2C mode
-    UCB0CTL0 = UCMST | UCMODE_3 | UCSYNC;
+    initSysTick();
+    sysTickRegister(i2cTick);
+}
+
+/**
+ * @brief Selects the SCL frequency.
+ *
+ * @param speedHz The requested frequency.
+ *
+ * @return Returns the frequency actually used.
+ *
+ * This function derives the prescaler from SMCLK_FREQUENCY_HZ, rounded up so the bus
+ * never runs faster than requested and the USCI gets at least I2C_MIN_PRESCALER, and
+ * reconfigures the USCI.
+ */
+uint32_t i2cSetSpeed(const uint32_t speedHz)
+{
+    // Do not change the clock in the middle of a transaction
+    while (!i2cIsIdle());
 
-    // Configure the baud rate registers for 100kHz when sourcing from SMCLK (SMCLK = 1MHz)
-    UCB0BR0 = 10;
-    UCB0BR1 = 0;
+    prescaler = I2C_PRESCALER(SMCLK_FREQUENCY_HZ, speedHz);
 
-    // Take USCI_B0 out of reset and source clock from SMCLK
-    UCB0CTL1 = UCSSEL_2;
+    configureUsci();
+
+    return SMCLK_FREQUENCY_HZ / prescaler;
+}
+
+/**
+ * @brief Queues a transaction.
+ *
+ * @param transaction Pointer to the transaction.
+ *
+ * @return Returns 0 if the transaction was queued, or I2C_ERROR_QUEUE_FULL.
+ */
+int16_t i2cSubmit(I2cTransaction *transaction)
+{
+    uint16_t interruptState = __get_interrupt_state();
+
+    __disable_interrupt();
+
+    if (queueCount >= I2C_QUEUE_LENGTH)
+    {
+        __set_interrupt_state(interruptState);
+        return I2C_ERROR_QUEUE_FULL;
+    }
+
+    transaction->status = I2C_PENDING;
+    queue[(queueHead + queueCount) % I2C_QUEUE_LENGTH] = transaction;
+    queueCount++;
+
+    if (!active)
+    {
+        startNext();
+    }
+
+    __set_interrupt_state(interruptState);
+
+    return I2C_OK;
+}
+
+/**
+ * @brief Waits until a transaction has ended.
+ *
+ * @param transaction Pointer to a queued transaction.
+ *
+ * @return Returns the final status of the transaction (I2C_STATUS).
+ *
+ * The wait always ends because the system tick aborts a transaction after
+ * I2C_TIMEOUT_MS.
+ */
+int16_t i2cWait(I2cTransaction *transaction)
+{
+    while (transaction->status == I2C_PENDING);
+
+    return transaction->status;
+}
+
+/**
+ * @brief Checks whether the I2C interface is idle.
+ *
+ * @return Returns 1 if no transaction is queued or running, 0 otherwise.
+ */
+uint8_t i2cIsIdle(void)
+{
+    return queueCount == 0;
 }
 
 /**
  * @brief Transfers a byte over I2C.
- * 
+ *
  * @param addr The 7-bit address of the slave device.
  * @param send The byte to be transmitted.
- * 
+ *
  * @return Returns the received byte or an error code.
- * 
+ *
  * This function transfers a byte over I2C to the specified slave device address.
  */
 int16_t transferByte(const uint8_t addr, const uint8_t send)
 {
+    uint8_t received = 0;
     int16_t ret = 0;
 
-    // Set the slave device address
-    UCB0I2CSA = addr;
-
-    // Transmit data if there is any
-    ret = transmit(addr, send);
+    ret = transferBlock(addr, &send, 1, &received, 1);
 
-    // Receive data if no error
+    // Return the received byte if no error
     if (ret == 0)
     {
-        ret = receive(addr);
-    }
-    else
-    {
-        // No bytes to receive, send the stop condition
-        UCB0CTL1 |= UCTXSTP;
+        ret = received;
     }
 
     return ret;
 }
 
 /**
- * @brief Transmits a byte over I2C.
- * 
+ * @brief Writes a block of bytes and reads a block back in one transaction.
+ *
  * @param addr The 7-bit address of the slave device.
- * @param send The byte to be transmitted.
- * 
+ * @param send Pointer to the bytes to be transmitted.
+ * @param sendCount Number of bytes to transmit.
+ * @param received Pointer to the buffer for the received bytes.
+ * @param receiveCount Number of bytes to receive.
+ *
  * @return Returns 0 on success, or a negative error code.
- * 
- * This function transmits a byte over I2C to the specified slave device address.
+ *
+ * This function queues the transaction and waits for it to end.
  */
-static int16_t transmit(const uint8_t addr, const uint8_t send)
+int16_t transferBlock(const uint8_t addr, const uint8_t *send, const uint8_t sendCount,
+                      uint8_t *received, const uint8_t receiveCount)
 {
-    int16_t err = 0;
+    I2cTransaction transaction;
+    int16_t ret = 0;
 
-    // Send the start condition
-    UCB0CTL1 |= UCTR | UCTXSTT;
+    transaction.address = addr;
+    transaction.txData = send;
+    transaction.txCount = sendCount;
+    transaction.rxData = received;
+    transaction.rxCount = receiveCount;
+    transaction.callback = 0;
+    transaction.context = 0;
 
-    // Wait for the start condition to be sent and ready to transmit interrupt
-    while ((UCB0CTL1 & UCTXSTT) && ((IFG2 & UCB0TXIFG) == 0));
+    ret = i2cSubmit(&transaction);
 
-    // Check for ACK
-    err = checkAck();
+    if (ret == 0)
+    {
+        ret = i2cWait(&transaction);
+    }
+
+    return ret;
+}
 
-    // If no error and bytes left to send, transmit the data
-    if (err == 0) 
+/**
+ * @brief Handles the I2C status interrupts (NACK, arbitration lost).
+ *
+ * A NACK ends the transaction with a stop condition. After a lost arbitration the
+ * USCI has switched to slave mode, so master mode is selected again.
+ */
+void i2cStatusInterrupt(void)
+{
+    if (UCB0STAT & UCNACKIFG)
     {
-        UCB0TXBUF = send;
-        while ((IFG2 & UCB0TXIFG) == 0) 
+        // Stop the I2C transmission
+        UCB0CTL1 |= UCTXSTP;
+
+        // Clear the interrupt flag
+        UCB0STAT &= ~UCNACKIFG;
+
+        if (active)
         {
-            err = checkAck();
-            if (err < 0) {
-                break;
-            }
+            finish(I2C_ERROR_NACK);
         }
     }
 
-    return err;
+    if (UCB0STAT & UCALIFG)
+    {
+        UCB0STAT &= ~UCALIFG;
+
+        // Become master again for the next transaction
+        UCB0CTL0 |= UCMST;
+
+        if (active)
+        {
+            finish(I2C_ERROR_ARBITRATION);
+        }
+    }
 }
 
 /**
- * @brief Receives a byte over I2C.
- * 
- * @param addr The 7-bit address of the slave device.
- * 
- * @return Returns the received byte or an error code.
- * 
- * This function receives a byte over I2C from the specified slave device address.
+ * @brief Configures USCI_B0 for I2C master mode.
+ */
+static void configureUsci(void)
+{
+    // Configure P1.6 and P1.7 for I2C
+    P1SEL  |= SCL_PIN + SDA_PIN;
+    P1SEL2 |= SCL_PIN + SDA_PIN;
+
+    // Ensure USCI_B0 is in reset before configuring
+    UCB0CTL1 = UCSWRST;
+
+    // Set USCI_B0 to master mode I2C mode
+    UCB0CTL0 = UCMST | UCMODE_3 | UCSYNC;
+
+    // Configure the baud rate registers for the selected SCL frequency
+    UCB0BR0 = prescaler & 0xFF;
+    UCB0BR1 = prescaler >> 8;
+
+    // Take USCI_B0 out of reset and source clock from SMCLK
+    UCB0CTL1 = UCSSEL_2;
+
+    // Enable the status and data interrupts, they are cleared by the reset
+    UCB0I2CIE = UCNACKIE | UCALIE;
+    IE2 |= UCB0TXIE | UCB0RXIE;
+}
+
+/**
+ * @brief Frees a bus that is held by a slave.
+ *
+ * A slave that was interrupted in the middle of a byte may hold SDA low. The USCI is
+ * put into reset, SCL is clocked as GPIO until SDA is released and a stop condition
+ * is generated by hand. Both lines are open-drain: they are driven low through the
+ * direction register and released to the external pull-ups.
+ */
+static void recoverBus(void)
+{
+    uint8_t i = 0;
+
+    UCB0CTL1 |= UCSWRST;
+
+    // Take both pins from the USCI, released (inputs) with the output latch low
+    P1SEL  &= ~(SCL_PIN + SDA_PIN);
+    P1SEL2 &= ~(SCL_PIN + SDA_PIN);
+    P1OUT  &= ~(SCL_PIN + SDA_PIN);
+    P1DIR  &= ~(SCL_PIN + SDA_PIN);
+
+    // Clock SCL until the slave releases SDA
+    for (i = 0; i < RECOVERY_CLOCKS && (P1IN & SDA_PIN) == 0; i++)
+    {
+        P1DIR |= SCL_PIN;
+        __delay_cycles(RECOVERY_HALF_PERIOD);
+        P1DIR &= ~SCL_PIN;
+        __delay_cycles(RECOVERY_HALF_PERIOD);
+    }
+
+    // Stop condition: SDA rises while SCL is high
+    P1DIR |= SDA_PIN;
+    __delay_cycles(RECOVERY_HALF_PERIOD);
+    P1DIR &= ~SDA_PIN;
+    __delay_cycles(RECOVERY_HALF_PERIOD);
+
+    configureUsci();
+}
+
+/**
+ * @brief Waits a bounded time until control bits of the USCI are cleared.
+ *
+ * @param bits The UCB0CTL1 bits to wait for.
+ */
+static void waitWhileSet(const uint8_t bits)
+{
+    uint16_t i = 0;
+
+    while ((UCB0CTL1 & bits) && i < WAIT_LIMIT)
+    {
+        i++;
+    }
+}
+
+/**
+ * @brief Starts the transaction at the head of the queue.
+ *
+ * Must be called with interrupts disabled or from an interrupt.
  */
-static int16_t receive(const uint8_t addr)
+static void startNext(void)
 {
-    int16_t rec = 0;
-    uint8_t receive = 0;
+    I2cTransaction *transaction = queue[queueHead];
+
+    active = 1;
+    elapsedMs = 0;
+    txIndex = 0;
+    rxIndex = 0;
+
+    // The stop condition of the previous transaction may still be on the bus
+    waitWhileSet(UCTXSTP);
+
+    // A NACK of the previous last byte must not be reported for this transaction
+    UCB0STAT &= ~UCNACKIFG;
+
+    // Set the slave device address
+    UCB0I2CSA = transaction->address;
 
+    if (transaction->txCount > 0 || transaction->rxCount == 0)
+    {
+        // Send the start condition, the TX interrupt then requests the data
+        UCB0CTL1 |= UCTR | UCTXSTT;
+    }
+    else
+    {
+        startReceive(transaction);
+    }
+}
+
+/**
+ * @brief Sends a (repeated) start condition in receive mode.
+ *
+ * @param transaction Pointer to the running transaction.
+ */
+static void startReceive(I2cTransaction *transaction)
+{
     // Send the start condition and switch to receive mode
     UCB0CTL1 &= ~UCTR;
     UCB0CTL1 |= UCTXSTT;
 
-    // Wait for the start condition to be sent
-    while (UCB0CTL1 & UCTXSTT);
+    // If there is only one byte to receive, the stop bit has to be set right after
+    // the address has been sent
+    if (transaction->rxCount == 1)
+    {
+        waitWhileSet(UCTXSTT);
+        UCB0CTL1 |= UCTXSTP;
+    }
+}
+
+/**
+ * @brief Ends the running transaction and starts the next one.
+ *
+ * @param status The final status of the transaction (I2C_STATUS).
+ */
+static void finish(const int16_t status)
+{
+    I2cTransaction *transaction = queue[queueHead];
 
-    // If there is only one byte to receive, set the stop bit
-    UCB0CTL1 |= UCTXSTP;
+    active = 0;
+    queueHead = (queueHead + 1) % I2C_QUEUE_LENGTH;
+    queueCount--;
 
-    // Check for ACK
-    rec = checkAck();
+    transaction->status = status;
 
-    // If no error and bytes left to receive, receive the data
-    if (rec == 0)
+    if (transaction->callback)
     {
-        // Wait for the data
-        while ((IFG2 & UCB0RXIFG) == 0);
+        // The callback may queue the next transaction itself
+        transaction->callback(transaction);
+    }
 
-        receive = UCB0RXBUF;
-        rec = receive;
+    if (!active && queueCount > 0)
+    {
+        startNext();
     }
+}
 
-    return rec;
+/**
+ * @brief Aborts a transaction that runs too long; called every millisecond.
+ */
+static void i2cTick(void)
+{
+    if (active && ++elapsedMs >= I2C_TIMEOUT_MS)
+    {
+        recoverBus();
+        finish(I2C_ERROR_TIMEOUT);
+    }
 }
 
 /**
- * @brief Checks for acknowledgment (ACK) from the slave device.
- * 
- * @return Returns 0 on success, or a negative error code.
- * 
- * This function checks for acknowledgment (ACK) from the slave device after
- * transmitting or receiving data over I2C.
+ * @brief USCI_B0 data interrupt service routine.
+ *
+ * This ISR moves the data of the running transaction: it writes the next byte on
+ * UCB0TXIFG, switches to receive mode with a repeated start after the last byte has
+ * been written, reads a byte on UCB0RXIFG and sets the stop bit while the last byte
+ * is received.
  */
-static int16_t checkAck(void)
+#pragma vector = USCIAB0TX_VECTOR
+__interrupt void i2cDataISR(void)
 {
-    int16_t err = 0;
+    I2cTransaction *transaction = queue[queueHead];
 
-    // Check for ACK
-    if (UCB0STAT & UCNACKIFG)
+    if (IFG2 & UCB0RXIFG)
     {
-        // Stop the I2C transmission
-        UCB0CTL1 |= UCTXSTP;
+        if (!active)
+        {
+            // Late byte without a transaction, reading clears the flag
+            (void)UCB0RXBUF;
+            return;
+        }
 
-        // Clear the interrupt flag
-        UCB0STAT &= ~UCNACKIFG;
+        // The next byte is the last one, stop after it
+        if (transaction->rxCount - rxIndex == 2)
+        {
+            UCB0CTL1 |= UCTXSTP;
+        }
 
-        // Set the error code
-        err = -1;
+        transaction->rxData[rxIndex++] = UCB0RXBUF;
+
+        if (rxIndex >= transaction->rxCount)
+        {
+            finish(I2C_OK);
+        }
     }
+    else if (IFG2 & UCB0TXIFG)
+    {
+        if (!active)
+        {
+            IFG2 &= ~UCB0TXIFG;
+        }
+        else if (txIndex < transaction->txCount)
+        {
+            UCB0TXBUF = transaction->txData[txIndex++];
+        }
+        else
+        {
+            IFG2 &= ~UCB0TXIFG;
 
-    return err;
-}
\ No newline at end of file
+            if (transaction->rxCount > 0)
+            {
+                startReceive(transaction);
+            }
+            else
+            {
+                // No bytes to receive, send the stop condition
+                UCB0CTL1 |= UCTXSTP;
+                finish(I2C_OK);
+            }
+        }
+    }
+}
@@ -14,73 +14,106 @@
 #include <stdint.h>
 
 #include "../inc/Notes.h"
+#include "../inc/SystemClock.h"
 #include "../inc/Hardware.h"
 #include "../inc/NotePlayer.h"
+#include "../inc/Sequencer.h"
+#include "../inc/Melody.h"
 #include "../inc/SerialDisplay.h"
+#include "../inc/Console.h"
+#include "../inc/SysTick.h"
+#include "../inc/Power.h"
 
 #include "../inc/Userinterface.h"
 
-#define DELAY_ONE_SEC 100000
-#define DELAY_HALF_SEC 50000
+#define SELECTION_PAUSE_MS 100 // Pause after the last selection before the playback
 
-#define DEBOUNCE_DELAY DELAY_HALF_SEC // Adjust as necessary for your hardware
+#define PLAYBACK_BPM 60        // One beat per second
+#define PLAYBACK_REST_STEPS 2  // About 0.1 s between the notes
+#define MELODY_BPM 120         // Default tempo of the stored and streamed melodies
+#define PREVIEW_STEPS 4        // 250 ms preview of a selected note at PLAYBACK_BPM
+
+// Defined by templateEMP.h in main.c
+extern void serialPrintln(char *tx);
+extern void serialFlush(void);
+
+static void waitForPlayback(uint16_t numTones);
+static void playCommand(uint8_t argc, char *argv[]);
+static void melodyCommand(uint8_t argc, char *argv[]);
+static void streamCommand(uint8_t argc, char *argv[]);
+static void tempoCommand(uint8_t argc, char *argv[]);
+
+// Commands of the serial console, the hashes are printed by tools/console_hash.c
+static const ConsoleCommand uiCommands[] = {
+    {"play", 0xDE21, playCommand, "<notes> - plays e.g. CDEFG, lower case one octave up"},
+    {"melody", 0x7EB3, melodyCommand, "- plays the stored melody"},
+    {"stream", 0xD459, streamCommand, "- plays a melody sent in the format of Melody.h"},
+    {"tempo", 0xEF66, tempoCommand, "<bpm> - tempo of play, melody and stream"}
+};
+
+// Semitones above C of the note letters a to h, H is the German B
+static const uint8_t letterSemitones[] = {9, 11, 0, 2, 4, 5, 7, 11};
+
+static uint16_t melodyBpm = MELODY_BPM; /**< Tempo of the console and stored melodies */
 
 /**
  * @brief Initializes the user interface components.
  * 
  * This function initializes the note player and joystick hardware components
- * necessary for the user interface.
+ * necessary for the user interface, then starts the gong as start-up sound. The gong
+ * plays in the background while the joystick calibrates. The terminal is cleared once;
+ * afterwards the display only sends the cells that change. The serial console is shown
+ * below the display.
  */
 void initUi()
 {
     initNotePlayer();
     initJoystick();
+    clearScreen();
+    displayParkCursor();
+    initConsole(uiCommands, sizeof(uiCommands) / sizeof(uiCommands[0]));
+
+    sequencerSetTempo(GONG_BPM);
+    sequencerPlay(gongMelody, gongLength, 0);
 }
 
 /**
- * @brief Updates the current note based on joystick direction.
+ * @brief Moves the note selection based on joystick direction.
  * 
- * @param currentNote Pointer to the current note to be updated.
+ * @param noteIndex Pointer to the index of the selected note in the note list.
  * @param direction The direction of the joystick (JOYSTICK_LEFT or JOYSTICK_RIGHT).
  * 
- * This function updates the current note based on the direction of the joystick.
- * It changes the note to the next or previous note in the note list and updates
- * the display to reflect the new note.
+ * This function moves the selection to the next or previous note in the note list,
+ * wrapping around at both ends, and updates the display to reflect the new note. The
+ * selected note is previewed in the background.
  */
-void updateNoteSelection(NOTE *currentNote, JOYSTICK_DIRECTION direction)
+void updateNoteSelection(uint16_t *noteIndex, JOYSTICK_DIRECTION direction)
 {
-    uint16_t i = 0;
+    static SequencerEvent preview;
     const NOTE *notes = getNotes();
     uint16_t numNotes = getNumberOfNotes();
 
-    // Update the current note based on joystick direction
+    // Update the index based on joystick direction
     if (direction == JOYSTICK_RIGHT)
     {
         // Move to the next note
-        for (i = 0; i < numNotes; i++)
-        {
-            if (notes[i] == *currentNote)
-            {
-                *currentNote = notes[(i + 1) % numNotes];
-                break;
-            }
-        }
+        *noteIndex = (*noteIndex + 1 < numNotes) ? *noteIndex + 1 : 0;
     }
     else if (direction == JOYSTICK_LEFT)
     {
         // Move to the previous note
-        for (i = 0; i < numNotes; i++)
-        {
-            if (notes[i] == *currentNote)
-            {
-                *currentNote = notes[(i - 1 + numNotes) % numNotes];
-                break;
-            }
-        }
+        *noteIndex = (*noteIndex > 0) ? *noteIndex - 1 : numNotes - 1;
     }
 
     // Refresh the display with the updated note
-    displayNotes(*currentNote);
+    displayNotes(notes[*noteIndex]);
+
+    // Play the note briefly; a further move restarts the preview with the new note
+    preview.note = notes[*noteIndex];
+    preview.duration = PREVIEW_STEPS;
+    preview.rest = 0;
+    sequencerSetTempo(PLAYBACK_BPM);
+    sequencerPlay(&preview, 1, 0);
 }
 
 /**
@@ -91,68 +124,81 @@ void updateNoteSelection(NOTE *currentNote, JOYSTICK_DIRECTION direction)
  * 
  * This function allows the user to select tones using the joystick. The selected tones
  * are stored in the provided array. The selection process continues until the user 
- * selects the maximum number of tones specified by maxTones.
+ * selects the maximum number of tones specified by maxTones. A held direction steps
+ * through the notes with accelerating auto-repeat. The selection is kept as an index
+ * into the note list and the loop only reacts to the events of the joystick queue.
  */
 void getUserSelectedTones(NOTE *selectedTones, uint16_t maxTones)
 {
-    NOTE currentNote = NOTE_C;  // Start with the first note
-    NOTE previousNote = NOTE_C; // Keep track of the previous note to detect changes
+    const NOTE *notes = getNotes();
+    uint16_t noteIndex = 0;         // Start with the first note
+    uint16_t previousNoteIndex = 0; // Keep track of the previous note to detect changes
     uint16_t toneIndex = 0;
     uint16_t previousToneIndex = -1; // Track previous tone index to detect changes
+    uint16_t start;
+    JoystickEvent event;
 
-    displayToneSelection(0);
-    displayNotes(currentNote);
+    // Discard the events raised while the previous melody was playing
+    while (joystickGetEvent(&event))
+    {
+    }
 
     while (toneIndex < maxTones)
     {
-        // Display tone selection only if the tone index has changed
-        if (toneIndex != previousToneIndex || currentNote != previousNote)
+        // Display tone selection only if the tone index has changed; only changed cells are sent
+        if (toneIndex != previousToneIndex || noteIndex != previousNoteIndex)
         {
-            clearScreen(); // Clear the screen if there's any change
             displayToneSelection(toneIndex);
-            displayNotes(currentNote);
+            displayNotes(notes[noteIndex]);
             previousToneIndex = toneIndex;
-            previousNote = currentNote;
+            previousNoteIndex = noteIndex;
+
+            // Return to the console line below the display
+            displayParkCursor();
+            consoleRedrawLine();
         }
 
-        JOYSTICK_DIRECTION currentDirection = getJoystickDirection();
+        // Commands typed on the serial console
+        consolePoll();
 
-        switch (currentDirection)
+        // Wait for the next joystick event; debouncing and auto-repeat are done in the background
+        if (!joystickGetEvent(&event))
         {
-        case JOYSTICK_LEFT:
-        case JOYSTICK_RIGHT:
-            __delay_cycles(DEBOUNCE_DELAY); // Debounce delay
-            // Check direction again to confirm change
-            if (getJoystickDirection() == currentDirection)
-            {
-                updateNoteSelection(&currentNote, currentDirection);
-            }
-            break;
-        default:
-            break;
+            // Sleep until the next system tick, it also brings the received bytes
+            powerIdle();
+            continue;
         }
 
-        if (isJoystickPressed() == JOYSTICK_PRESSED)
+        switch (event.type)
         {
-            __delay_cycles(DEBOUNCE_DELAY); // Debounce delay
-            // Check if joystick is still pressed
-            if (isJoystickPressed() == JOYSTICK_PRESSED)
+        case JOYSTICK_EVENT_MOVE:
+            if (event.direction == JOYSTICK_UP)
+            {
+                // Play the stored melody
+                melodyCommand(1, 0);
+                break;
+            }
+            // No break, a move is handled like its repeat
+        case JOYSTICK_EVENT_REPEAT:
+            if (event.direction == JOYSTICK_LEFT || event.direction == JOYSTICK_RIGHT)
             {
-                selectedTones[toneIndex++] = currentNote;
-                //playNote(currentNote, 1); // NOT TO shure if the note needs to be played after selection therfor i uncommented it here.
-                clearScreen(); // Clear the screen after selecting a tone
-                if (toneIndex < maxTones)
-                {
-                    displayToneSelection(toneIndex);
-                    displayNotes(currentNote);
-                }
+                updateNoteSelection(&noteIndex, (JOYSTICK_DIRECTION)event.direction);
             }
+            break;
+        case JOYSTICK_EVENT_PRESSED:
+            selectedTones[toneIndex++] = notes[noteIndex];
+            //playNote(notes[noteIndex], 1); // NOT TO shure if the note needs to be played after selection therfor i uncommented it here.
+            break;
+        default:
+            break;
         }
+    }
 
-        // Small delay to avoid bouncing issues
-        __delay_cycles(DELAY_HALF_SEC);
+    start = getSysTicks();
+    while ((uint16_t)(getSysTicks() - start) < SELECTION_PAUSE_MS)
+    {
+        powerIdle();
     }
-    __delay_cycles(DELAY_ONE_SEC);
 }
 
 /**
@@ -160,18 +206,158 @@ void getUserSelectedTones(NOTE *selectedTones, uint16_t maxTones)
  * 
  * @param selectedTones Pointer to an array of selected tones to be played.
  * @param numTones The number of tones to play.
- * @param duration The duration each tone should be played for.
+ * @param duration The duration in seconds each tone should be played for (at most 15).
  * 
- * This function plays the user-selected tones in sequence. Each tone is played for
- * the specified duration, and the display is updated to show the currently playing tone.
+ * This function plays the user-selected tones in sequence, each followed by a short
+ * pause. The sequencer plays the notes in the background while this function updates the
+ * display to show the currently playing tone. Pressing the joystick ends the playback.
  */
 void playUserNotes(NOTE *selectedTones, uint16_t numTones, uint16_t duration)
 {
+    static SequencerEvent melody[NUM_TONES];
     uint16_t i = 0;
+
+    if (numTones > NUM_TONES)
+    {
+        numTones = NUM_TONES;
+    }
+
     for (i = 0; i < numTones; i++)
     {
-        __delay_cycles(DELAY_ONE_SEC);
-        displayPlayingTone(i);
-        playNote(selectedTones[i], duration);
+        melody[i].note = selectedTones[i];
+        melody[i].duration = duration * SEQUENCER_STEPS_PER_BEAT;
+        melody[i].rest = PLAYBACK_REST_STEPS;
     }
+
+    sequencerSetTempo(PLAYBACK_BPM);
+    sequencerPlay(melody, numTones, 0);
+
+    waitForPlayback(numTones);
+}
+
+/**
+ * @brief Waits until the sequencer has finished or the joystick has been pressed.
+ *
+ * @param numTones The number of tones whose playback is displayed, 0 for none.
+ */
+static void waitForPlayback(uint16_t numTones)
+{
+    uint16_t i = 0;
+    uint16_t displayedTone = numTones;
+    JoystickEvent event;
+
+    while (sequencerIsPlaying())
+    {
+        i = sequencerGetPosition();
+        if (i != displayedTone && i < numTones)
+        {
+            displayPlayingTone(i);
+            displayedTone = i;
+        }
+
+        if (joystickGetEvent(&event) && event.type == JOYSTICK_EVENT_PRESSED)
+        {
+            sequencerStop();
+        }
+
+        // Lets the host of a streamed melody send its next bytes
+        melodyStreamPoll();
+
+        powerIdle();
+    }
+}
+
+/**
+ * @brief Console command "play": plays the notes given as letters.
+ *
+ * @param argc Number of words.
+ * @param argv The words; argv[1] holds the note letters.
+ */
+static void playCommand(uint8_t argc, char *argv[])
+{
+    static uint8_t melody[CONSOLE_LINE_LENGTH + 1];
+    const char *letter;
+    uint8_t length = 0;
+    NOTE note;
+
+    if (argc != 2)
+    {
+        serialPrintln("Usage: play <notes>");
+        return;
+    }
+
+    // One melody byte per letter, in the format of Melody.h
+    for (letter = argv[1]; *letter; letter++)
+    {
+        if (*letter >= 'A' && *letter <= 'H')
+        {
+            note = (NOTE)(NOTE_C4 + letterSemitones[*letter - 'A']);
+        }
+        else if (*letter >= 'a' && *letter <= 'h')
+        {
+            note = (NOTE)(NOTE_C5 + letterSemitones[*letter - 'a']);
+        }
+        else
+        {
+            serialPrintln("Notes are A to H, or a to h one octave up");
+            return;
+        }
+
+        melody[length++] = MELODY_NOTE(note, MELODY_QUARTER);
+    }
+    melody[length] = MELODY_END;
+
+    sequencerSetTempo(melodyBpm);
+    melodyPlay(melody, 0);
+    waitForPlayback(0);
+}
+
+/**
+ * @brief Console command "melody": plays the stored melody.
+ *
+ * @param argc Number of words.
+ * @param argv The words, not used.
+ */
+static void melodyCommand(uint8_t argc, char *argv[])
+{
+    sequencerSetTempo(melodyBpm);
+    melodyPlay(entchenMelody, 0);
+    waitForPlayback(0);
+}
+
+/**
+ * @brief Console command "stream": plays the melody that follows on the serial interface.
+ *
+ * @param argc Number of words.
+ * @param argv The words, not used.
+ */
+static void streamCommand(uint8_t argc, char *argv[])
+{
+    serialPrintln("Send the melody, it ends with MELODY_END; one more byte per ACK");
+
+    sequencerSetTempo(melodyBpm);
+    melodyPlaySerial(0);
+    waitForPlayback(0);
+
+    // The rest of a stopped melody must not reach the console
+    serialFlush();
+}
+
+/**
+ * @brief Console command "tempo": sets the tempo of the melodies.
+ *
+ * @param argc Number of words.
+ * @param argv The words; argv[1] is the tempo in BPM.
+ */
+static void tempoCommand(uint8_t argc, char *argv[])
+{
+    int16_t bpm;
+
+    if (argc != 2 || consoleParseInt(argv[1], &bpm) != 0 || bpm < 1 || bpm > SEQUENCER_MAX_BPM)
+    {
+        serialPrintln("Usage: tempo <1-300>");
+        return;
+    }
+
+    melodyBpm = bpm;
 }
@@ -0,0 +1,222 @@
+/**
+ * @file    Voices.c
+ * @brief   Functions for the two-voice tone engine.
+ *
+ * This file contains the implementation of the voices. The half periods come from the
+ * note table, so a note change is a lookup and a shift. In the mixed output the system
+ * tick hands TA1.1 to the next sounding voice at the end of every time slot.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+#include <msp430.h>
+
+#include "../inc/Notes.h"
+#include "../inc/SysTick.h"
+#include "../inc/SoftwarePwm.h"
+#include "../inc/Voices.h"
+
+void initVoices(VOICE_OUTPUT output);
+void voicesSetNote(uint8_t voice, NOTE note);
+uint8_t voicesStart();
+void voicesStop();
+uint8_t voicesIsPlaying();
+void voicesInterrupt(uint16_t vector);
+static void voicesTick(void);
+static uint8_t nextVoice(uint8_t voice);
+
+static uint16_t halfPeriod[VOICE_COUNT];  /**< Half period of every voice, 0 if silent */
+static uint8_t voiceOutput = VOICE_OUTPUT_MIXED; /**< Selected output */
+static uint8_t initialized = 0;           /**< 1 after initVoices() */
+static volatile uint8_t playing = 0;      /**< 1 while the voices play */
+static volatile uint8_t activeVoice = 0;  /**< Voice on TA1.1 in the mixed output */
+static uint8_t slotTicks = 0;             /**< Milliseconds of the current time slot */
+
+/**
+ * @brief Initializes the voices.
+ *
+ * @param output Whether the voices use a pin each or share P2.1.
+ */
+void initVoices(VOICE_OUTPUT output)
+{
+    voiceOutput = output;
+
+    // TA1.1 on P2.1 is set up by hardwarePwmInit() as well, doing it twice is harmless
+    P2DIR |= PWM_HARDWARE_PIN;
+    P2SEL |= PWM_HARDWARE_PIN;
+    P2SEL2 &= ~PWM_HARDWARE_PIN;
+
+    if (output == VOICE_OUTPUT_SEPARATE)
+    {
+        P2DIR |= VOICE_SECOND_PIN;
+        P2SEL |= VOICE_SECOND_PIN;
+        P2SEL2 &= ~VOICE_SECOND_PIN;
+    }
+
+    if (!initialized)
+    {
+        initSysTick();
+        sysTickRegister(voicesTick);
+        initialized = 1;
+    }
+}
+
+/**
+ * @brief Sets the note of a voice.
+ *
+ * @param voice The voice, 0 to VOICE_COUNT - 1.
+ * @param note The note, or NOTE_REST to silence the voice.
+ */
+void voicesSetNote(uint8_t voice, NOTE note)
+{
+    if (voice < VOICE_COUNT)
+    {
+        halfPeriod[voice] = getNotePeriod(note) >> 1;
+    }
+}
+
+/**
+ * @brief Starts the voices.
+ *
+ * @return Returns 1 if the voices play, or 0 if initVoices() has not been called.
+ */
+uint8_t voicesStart()
+{
+    if (!initialized)
+    {
+        return 0;
+    }
+
+    TA1CTL = TASSEL_2 | PWM_CLOCK_DIVIDER_BITS | TACLR;
+    TA1CCTL0 = 0;
+    TA1CCTL1 = OUTMOD_0;
+    TA1CCTL2 = OUTMOD_0;
+
+    if (voiceOutput == VOICE_OUTPUT_MIXED)
+    {
+        activeVoice = nextVoice(VOICE_COUNT - 1);
+        slotTicks = 0;
+
+        if (halfPeriod[activeVoice])
+        {
+            TA1CCR1 = halfPeriod[activeVoice];
+            TA1CCTL1 = OUTMOD_4 | CCIE;
+        }
+    }
+    else
+    {
+        if (halfPeriod[0])
+        {
+            TA1CCR1 = halfPeriod[0];
+            TA1CCTL1 = OUTMOD_4 | CCIE;
+        }
+        if (halfPeriod[1])
+        {
+            TA1CCR2 = halfPeriod[1];
+            TA1CCTL2 = OUTMOD_4 | CCIE;
+        }
+    }
+
+    playing = 1;
+
+    // Start Timer1 in Continuous Mode
+    TA1CTL |= MC_2;
+
+    return 1;
+}
+
+/**
+ * @brief Stops the voices and drives the outputs low.
+ */
+void voicesStop()
+{
+    if (!initialized)
+    {
+        return;
+    }
+
+    TA1CTL &= ~MC_3;
+    TA1CCTL1 = OUTMOD_0;
+    TA1CCTL2 = OUTMOD_0;
+    playing = 0;
+}
+
+/**
+ * @brief Checks whether the voices are playing.
+ *
+ * @return Returns 1 while the voices play, 0 otherwise.
+ */
+uint8_t voicesIsPlaying()
+{
+    return playing;
+}
+
+/**
+ * @brief Handles the Timer1_A compare interrupts of the voices.
+ *
+ * @param vector The value read from TA1IV.
+ *
+ * The output unit has already toggled the pin; only the next edge is scheduled.
+ */
+void voicesInterrupt(uint16_t vector)
+{
+    switch (vector)
+    {
+    case TA1IV_TACCR1:
+        TA1CCR1 += halfPeriod[activeVoice];
+        break;
+    case TA1IV_TACCR2:
+        TA1CCR2 += halfPeriod[1];
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Switches the voice of the mixed output; called every millisecond.
+ */
+static void voicesTick(void)
+{
+    if (!playing || voiceOutput != VOICE_OUTPUT_MIXED)
+    {
+        return;
+    }
+
+    if (++slotTicks < VOICE_MIX_SLOT_MS)
+    {
+        return;
+    }
+    slotTicks = 0;
+
+    // The new half period is used from the next edge on
+    activeVoice = nextVoice(activeVoice);
+}
+
+/**
+ * @brief Finds the next voice that is not silent.
+ *
+ * @param voice The current voice.
+ *
+ * @return The next sounding voice after the given one, or the given one if no other
+ *         voice sounds.
+ */
+static uint8_t nextVoice(uint8_t voice)
+{
+    uint8_t i;
+    uint8_t candidate = voice;
+
+    for (i = 0; i < VOICE_COUNT; i++)
+    {
+        candidate = (candidate + 1) % VOICE_COUNT;
+        if (halfPeriod[candidate])
+        {
+            return candidate;
+        }
+    }
+
+    return voice;
+}
@@ -7,12 +7,38 @@
  * @version 1.0
  */
 
+#include <string.h>
+#define NO_TEMPLATE_ISR 1
 #include <templateEMP.h>
 
 #include "./userCode/inc/Scheduler.h"
 #include "./userCode/inc/Hardware.h"
 #include "./userCode/inc/Clock.h"
 #include "./userCode/inc/StringDisplay.h"
+#include "./userCode/inc/AdcFilter.h"
+#include "./userCode/inc/Lcd.h"
+#include "./userCode/inc/Console.h"
+#include "./userCode/inc/Protocol.h"
+#include "./userCode/inc/Trace.h"
+#include "./userCode/inc/Power.h"
+
+/** Exponential smoothing alpha of 1/4 for the ADC display. */
+#define ADC_FILTER_SHIFT 2
+
+/** Full scale of the oversampled ADC reading. */
+#define ADC_OVERSAMPLED_MAX (1023UL << ADC_EXTRA_BITS)
+
+/** Default interval of the ADC display task in ms. */
+#define ADC_DEFAULT_INTERVAL 300
+
+/** Interval of the console task in ms, 20 bytes arrive in this time at 9600 baud. */
+#define CONSOLE_INTERVAL 20
+
+/** Default interval of the ADC frames in binary mode in ms. */
+#define TELEMETRY_DEFAULT_INTERVAL 100
+
+/** Interval of the scheduler statistics in binary mode in ms. */
+#define STATS_INTERVAL 1000
 
 /** Global variable to store the voltage value. */
 float voltageValue = 0.0;
@@ -20,6 +46,59 @@ float voltageValue = 0.0;
 /** Global variable to store the ADC values. */
 uint16_t adcValues = 0;
 
+/** Last unfiltered ADC reading. */
+static uint16_t adcRawValue = 0;
+
+/** Last oversampled ADC reading with ADC_EXTRA_BITS more bits. */
+static uint16_t adcOversampled = 0;
+
+/** 1 while the serial interface is used by the binary protocol instead of the console. */
+static uint8_t binaryMode = 0;
+
+/** Interval of the ADC frames in ms, 0 if they are off. */
+static uint16_t telemetryInterval = TELEMETRY_DEFAULT_INTERVAL;
+
+/** Milliseconds until the next ADC frame and the next statistics. */
+static uint16_t telemetryCountdown = 0;
+static uint16_t statsCountdown = 0;
+
+/** Smoothing filter applied to the raw ADC readings. */
+static ExponentialFilter adcFilter;
+
+/**
+ * @brief USCI receive interrupt service routine.
+ *
+ * In binary mode the received bytes are decoded right away, otherwise they are stored
+ * in the serial buffer of templateEMP.h for the console just like its own ISR does.
+ */
+#pragma vector = USCIAB0RX_VECTOR
+__interrupt void usciRxISR(void)
+{
+    TRACE(TRACE_ISR_ENTER, TRACE_ISR_UART_RX);
+
+    if (protocolIsActive())
+    {
+        protocolReceiveByte(UCA0RXBUF);
+        TRACE(TRACE_ISR_EXIT, TRACE_ISR_UART_RX);
+        return;
+    }
+
+    // Store the received byte in the serial ring buffer
+    rxBuffer[rxBufferEnd++] = UCA0RXBUF;
+    rxBufferEnd %= RXBUFFERSIZE;
+    // If enabled, print the received data back to user.
+    if (echoBack) {
+        while (!(IFG2&UCA0TXIFG));
+        UCA0TXBUF = UCA0RXBUF;
+    }
+    // Check for an overflow and set the corresponding variable.
+    if (rxBufferStart == rxBufferEnd) {
+        rxBufferError = 1;
+    }
+
+    TRACE(TRACE_ISR_EXIT, TRACE_ISR_UART_RX);
+}
+
 /**
  * @brief Task function to toggle LED1.
  */
@@ -39,6 +118,17 @@ void userInputTask(void)
 {
     // Determine which button is pressed
     BUTTON pressedButton = getPressedButton();
+    uint8_t event = pressedButton;
+
+    if (pressedButton != BUTTON_NONE)
+    {
+        TRACE(TRACE_BUTTON, event);
+
+        if (binaryMode)
+        {
+            protocolSend(MSG_BUTTON_EVENT, &event, sizeof(event));
+        }
+    }
 
     // Button 1 behavior
     if (pressedButton == BUTTON_1)
@@ -76,7 +166,9 @@ void UpadteSecondDisplay(void)
  */
 void UpadteADCDisplay(void)
 {
-    adcValues = readADC();
+    adcOversampled = readADCOversampled();
+    adcRawValue = adcOversampled >> ADC_EXTRA_BITS;
+    adcValues = expFilterUpdate(&adcFilter, adcRawValue);
     printAdcDisplay(adcValues);
 }
 
@@ -90,6 +182,267 @@ void UpdateVoltageDisplay(void)
     printGageDisplay(adcValues);
 }
 
+/**
+ * @brief Console command "adc": sets the interval of the ADC display.
+ */
+static void adcCommand(uint8_t argc, char *argv[])
+{
+    int16_t interval;
+
+    if (argc != 3 || strcmp(argv[1], "rate") != 0 || consoleParseInt(argv[2], &interval) != 0
+        || interval < 1 || setTaskInterval(UpadteADCDisplay, interval) != 0)
+    {
+        serialPrintln("Usage: adc rate <ms>");
+    }
+}
+
+/**
+ * @brief Console command "lcd": clears the LCD, the tasks redraw it.
+ */
+static void lcdCommand(uint8_t argc, char *argv[])
+{
+    if (argc != 2 || strcmp(argv[1], "clear") != 0)
+    {
+        serialPrintln("Usage: lcd clear");
+        return;
+    }
+
+    lcdClear();
+}
+
+/**
+ * @brief Console command "sw": controls the stopwatch like the buttons.
+ */
+static void stopwatchCommand(uint8_t argc, char *argv[])
+{
+    if (argc == 2 && strcmp(argv[1], "start") == 0)
+    {
+        startStopwatch();
+        button1State = BUTTON_1;
+    }
+    else if (argc == 2 && strcmp(argv[1], "stop") == 0)
+    {
+        stopStopwatch();
+        button1State = BUTTON_NONE;
+    }
+    else if (argc == 2 && strcmp(argv[1], "reset") == 0)
+    {
+        resetStopwatch();
+        button1State = BUTTON_NONE;
+    }
+    else
+    {
+        serialPrintln("Usage: sw start|stop|reset");
+    }
+}
+
+/**
+ * @brief Console command "stats": prints the stopwatch time and the ADC values.
+ */
+static void statsCommand(uint8_t argc, char *argv[])
+{
+    Time time = getStopwatchTime();
+
+    serialPrint("Stopwatch ");
+    serialPrintInt(time.hours);
+    serialPrint(":");
+    serialPrintInt(time.minutes);
+    serialPrint(":");
+    serialPrintInt(time.seconds);
+    serialPrint("  ADC ");
+    serialPrintInt(adcValues);
+    serialPrint("  ");
+    serialPrintInt((int)(((uint32_t)adcOversampled * 3300) / ADC_OVERSAMPLED_MAX)); // 0.8 mV steps
+    serialPrintln(" mV");
+}
+
+/**
+ * @brief Console command "binary": hands the serial interface to the binary protocol.
+ */
+static void binaryCommand(uint8_t argc, char *argv[])
+{
+    serialPrintln("Binary mode, CONFIG_CONSOLE returns");
+
+    telemetryInterval = TELEMETRY_DEFAULT_INTERVAL;
+    telemetryCountdown = 0;
+    statsCountdown = 0;
+    binaryMode = 1;
+    protocolStart();
+}
+
+/**
+ * @brief Console command "trace": prints the event trace or selects the events.
+ */
+static void traceCommand(uint8_t argc, char *argv[])
+{
+    int16_t mask;
+
+    if (argc == 1)
+    {
+        traceDump();
+    }
+    else if (argc == 3 && strcmp(argv[1], "mask") == 0 && consoleParseInt(argv[2], &mask) == 0
+             && mask >= 0)
+    {
+        traceMask = mask;
+    }
+    else
+    {
+        serialPrintln("Usage: trace [mask <bits>]");
+    }
+}
+
+/** Commands of the serial console, the hashes are printed by tools/console_hash.c. */
+static const ConsoleCommand consoleCommands[] = {
+    {"adc", 0x3243, adcCommand, "rate <ms> - interval of the ADC display"},
+    {"lcd", 0x3FAE, lcdCommand, "clear - clears the LCD"},
+    {"sw", 0x70E1, stopwatchCommand, "start|stop|reset - controls the stopwatch"},
+    {"stats", 0xF0C4, statsCommand, "- prints the stopwatch time and the ADC value"},
+    {"binary", 0x8F4A, binaryCommand, "- switches to the binary protocol"},
+    {"trace", 0x43A4, traceCommand, "[mask <bits>] - prints the event trace or selects the events"}
+};
+
+/**
+ * @brief Applies a configuration write of the host.
+ *
+ * @param frame The MSG_CONFIG_WRITE frame.
+ *
+ * @return 0 if the setting has been applied, 1 otherwise.
+ */
+static uint8_t applyConfig(const ProtocolFrame *frame)
+{
+    int16_t value;
+
+    if (frame->length != 3)
+    {
+        return 1;
+    }
+
+    // Little endian, the payload may not be aligned
+    value = (int16_t)(frame->payload[1] | (frame->payload[2] << 8));
+
+    switch (frame->payload[0])
+    {
+    case CONFIG_ADC_INTERVAL:
+        return value < 1 || setTaskInterval(UpadteADCDisplay, value) != 0;
+    case CONFIG_TELEMETRY_INTERVAL:
+        if (value < 0)
+        {
+            return 1;
+        }
+        telemetryInterval = value;
+        telemetryCountdown = 0;
+        return 0;
+    case CONFIG_STOPWATCH:
+        if (value == 0)
+        {
+            resetStopwatch();
+            button1State = BUTTON_NONE;
+        }
+        else if (value == 1)
+        {
+            startStopwatch();
+            button1State = BUTTON_1;
+        }
+        else if (value == 2)
+        {
+            stopStopwatch();
+            button1State = BUTTON_NONE;
+        }
+        else
+        {
+            return 1;
+        }
+        return 0;
+    case CONFIG_CONSOLE:
+        // After the acknowledgement has been sent
+        return 0;
+    default:
+        return 1;
+    }
+}
+
+/**
+ * @brief Serves the binary protocol: answers the host and sends the telemetry.
+ */
+static void protocolTask(void)
+{
+    ProtocolFrame frame;
+    ProtocolStatistics statistics;
+    uint8_t payload[4 + 1 + sizeof(ProtocolStatistics)];
+    uint32_t ticks;
+
+    if (protocolReceive(&frame))
+    {
+        payload[0] = frame.type;
+        payload[1] = frame.sequence;
+        payload[2] = frame.type == MSG_CONFIG_WRITE ? applyConfig(&frame) : 1;
+        protocolSend(MSG_ACK, payload, 3);
+
+        if (frame.type == MSG_CONFIG_WRITE && frame.length == 3
+            && frame.payload[0] == CONFIG_CONSOLE)
+        {
+            protocolStop();
+            return;
+        }
+    }
+
+    if (telemetryInterval != 0)
+    {
+        if (telemetryCountdown <= CONSOLE_INTERVAL)
+        {
+            // Raw and filtered value, both little endian like in memory
+            memcpy(&payload[0], &adcRawValue, 2);
+            memcpy(&payload[2], &adcValues, 2);
+            protocolSend(MSG_ADC_FRAME, payload, 4);
+            telemetryCountdown = telemetryInterval;
+        }
+        else
+        {
+            telemetryCountdown -= CONSOLE_INTERVAL;
+        }
+    }
+
+    if (statsCountdown <= CONSOLE_INTERVAL)
+    {
+        // The host divides the byte counters by the ticks to get the rate of the link
+        ticks = getSchedulerTicks();
+        protocolGetStatistics(&statistics);
+        memcpy(&payload[0], &ticks, 4);
+        payload[4] = getTaskCount();
+        memcpy(&payload[5], &statistics, sizeof(statistics));
+        protocolSend(MSG_SCHEDULER_STATS, payload, sizeof(payload));
+        statsCountdown = STATS_INTERVAL;
+    }
+    else
+    {
+        statsCountdown -= CONSOLE_INTERVAL;
+    }
+}
+
+/**
+ * @brief Task function to serve the serial interface, either the console or the binary
+ *        protocol.
+ */
+void consoleTask(void)
+{
+    if (!binaryMode)
+    {
+        consolePoll();
+    }
+    else if (protocolIsActive())
+    {
+        protocolTask();
+    }
+    else
+    {
+        // The last frame has been sent, the console takes over again
+        binaryMode = 0;
+        serialPrintln("");
+        consoleRedrawLine();
+    }
+}
+
 /**
  * @brief Main function initializing hardware and scheduler, and adding tasks to the scheduler.
  * 
@@ -98,16 +451,29 @@ void UpdateVoltageDisplay(void)
 int main(void)
 {
     initMSP(); // Initialize MSP
+    initTrace(); // Before the other modules, they record events
+    initPower();
 
     initHardware();
     initStringDisplay();
+    // Start from the first reading, so the display does not ramp up from 0 V
+    adcOversampled = readADCOversampled();
+    adcRawValue = adcOversampled >> ADC_EXTRA_BITS;
+    adcValues = adcRawValue;
+    expFilterInit(&adcFilter, ADC_FILTER_SHIFT, adcRawValue);
+    if (traceHasPostMortem())
+    {
+        serialPrintln("Watchdog reset, \"trace\" prints the events before it");
+    }
+    initConsole(consoleCommands, sizeof(consoleCommands) / sizeof(consoleCommands[0]));
 
     initScheduler();
     addTaskToScheduler(userInputTask, 100);         // Add Task1 to run every 200 ms
     addTaskToScheduler(LedBlinkTask, 200);          // Add Task2 to run every 200 ms
-    addTaskToScheduler(UpadteADCDisplay, 300);      // Add Task3 to run every 300 ms
+    addTaskToScheduler(UpadteADCDisplay, ADC_DEFAULT_INTERVAL); // Add Task3 to run every 300 ms
     addTaskToScheduler(UpdateVoltageDisplay, 500);  // Add Task4 to run every 500 ms
     addTaskToScheduler(UpadteSecondDisplay, 1000);  // Add Task5 to run every 1000 ms
+    addTaskToScheduler(consoleTask, CONSOLE_INTERVAL); // Add Task6 to read the console every 20 ms
 
     runScheduler();
 
@@ -0,0 +1,107 @@
+/**
+ * @file    Console.h
+ * @brief   Header file for the serial command console.
+ *
+ * This file contains declarations for a line-oriented command console on top of the
+ * serial functions of templateEMP.h. The application passes a constant table of
+ * commands and calls consolePoll() from its main loop or a scheduler task. consolePoll()
+ * takes the received bytes without waiting, echoes them and runs the command when a line
+ * is complete. The line is split into words in place, the handlers get pointers into
+ * the line buffer. Commands are found by a hash of their name, so a line costs one
+ * name comparison. The hashes are part of the constant table and take no RAM; they are
+ * printed by tools/console_hash.c, and initConsole() reports an entry whose hash does
+ * not match its name. The command "help" is built in and lists the table.
+ *
+ * The console reads the receive buffer of templateEMP.h; the application must not read
+ * it otherwise while the console is in use.
+ *
+ * @date    25.05.2024
+ * @authors Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <stdint.h>
+
+#define CONSOLE_LINE_LENGTH 32  /**< Characters of a command line, without the terminator */
+#define CONSOLE_MAX_ARGS 4      /**< Words of a command line, including the command */
+#define CONSOLE_MAX_COMMANDS 8  /**< Entries of a command table */
+
+/**
+ * @brief Function that runs a command.
+ *
+ * @param argc Number of words, at least 1.
+ * @param argv The words; argv[0] is the command. They point into the line buffer and
+ *             are valid until the handler returns.
+ */
+typedef void (*ConsoleHandler)(uint8_t argc, char *argv[]);
+
+/**
+ * @brief One command of the console.
+ */
+typedef struct {
+    const char *name;       /**< Command as typed, lower case */
+    uint16_t hash;          /**< consoleHash() of the name */
+    ConsoleHandler handler; /**< Function that runs the command */
+    const char *help;       /**< Arguments and description shown by "help" */
+} ConsoleCommand;
+
+/**
+ * @brief Initializes the console.
+ *
+ * @param commands The command table; it has to stay valid, usually a const array.
+ * @param count Number of commands, at most CONSOLE_MAX_COMMANDS.
+ *
+ * This function checks the hashes of the table, prints "Wrong hash" with the name of
+ * every entry that does not match and prints the prompt.
+ */
+extern void initConsole(const ConsoleCommand *commands, uint8_t count);
+
+/**
+ * @brief Processes the received bytes.
+ *
+ * This function returns at once when no byte has been received. Backspace removes the
+ * last character, carriage return or line feed ends the line and runs the command.
+ */
+extern void consolePoll(void);
+
+/**
+ * @brief Checks whether a command is being typed.
+ *
+ * @return Returns 1 while the line holds characters, 0 otherwise.
+ *
+ * Applications that refresh a line of the terminal in place can pause while a command
+ * is typed, so the echo is not overwritten.
+ */
+extern uint8_t consoleLineActive(void);
+
+/**
+ * @brief Prints the prompt and the line typed so far again.
+ *
+ * Used by applications that have moved the cursor, e.g. to redraw a screen.
+ */
+extern void consoleRedrawLine(void);
+
+/**
+ * @brief Hashes a command name (djb2 with XOR).
+ *
+ * @param name The name.
+ *
+ * @return The hash, the value of the hash field of the command table.
+ */
+extern uint16_t consoleHash(const char *name);
+
+/**
+ * @brief Parses a decimal integer argument.
+ *
+ * @param text The argument, with an optional leading '-'.
+ * @param value Pointer to the result; not changed on an error.
+ *
+ * @return Returns 0 on success, or -1 if the text is no number or does not fit in
+ *         16 bits.
+ */
+extern int8_t consoleParseInt(const char *text, int16_t *value);
+
+#endif /* CONSOLE_H */
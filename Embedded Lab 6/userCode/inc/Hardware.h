@@ -3,6 +3,8 @@
 
 #include <stdint.h>
 
+#define ADC_EXTRA_BITS 2 /** Extra bits of the oversampled ADC reading, 16 conversions give 12 bits */
+
 // Enumeration for GPIO pins
 typedef enum {
     PIN_0,
@@ -49,5 +51,6 @@ extern void initButtons();
 extern BUTTON getPressedButton();
 extern void initADC();
 extern uint16_t readADC();
+extern uint16_t readADCOversampled();
 
 #endif // HARDWARE_H
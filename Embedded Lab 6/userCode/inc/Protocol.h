@@ -0,0 +1,155 @@
+/**
+ * @file    Protocol.h
+ * @brief   Header file for the binary frame protocol on the serial interface.
+ *
+ * This file contains declarations for exchanging binary messages with a host over
+ * USCI_A0. A message is sent as a frame:
+ *
+ *     COBS( type | sequence | payload (0-PROTOCOL_MAX_PAYLOAD bytes) | CRC16 ) | 0x00
+ *
+ * - type: a PROTOCOL_MESSAGE.
+ * - sequence: counts the frames of each direction, so the host sees lost frames.
+ * - CRC16: CRC-16/CCITT-FALSE (polynomial 0x1021, start value 0xFFFF) over type,
+ *   sequence and payload, low byte first.
+ * - COBS (consistent overhead byte stuffing) removes every 0x00 from the frame for one
+ *   byte of overhead, so 0x00 only marks the end of a frame. A receiver that starts in
+ *   the middle of a frame or sees a corrupt byte is in step again at the next 0x00.
+ *
+ * Multi-byte values in the payload are little endian, like in the memory of the MSP430.
+ * A frame carries PROTOCOL_OVERHEAD bytes besides the payload; an ADC frame of 4 payload
+ * bytes takes 10 bytes on the line, the same values as text ("ADC 512 1650 mV\r\n") take
+ * 17. At 9600 baud (960 bytes/s) ADC frames every 20 ms use 500 bytes/s of the line.
+ *
+ * Received bytes are passed to protocolReceiveByte() by the receive interrupt; the
+ * frame is decoded as the bytes arrive, there is no buffer of undecoded bytes. Frames
+ * are sent from a ring buffer by the transmit interrupt, so protocolSend() does not wait
+ * for the line.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h>
+
+#define PROTOCOL_MAX_PAYLOAD 24  /**< Payload bytes of a frame */
+#define PROTOCOL_TX_BUFFER 64    /**< Bytes of the transmit ring, must be a power of two */
+#define PROTOCOL_OVERHEAD 6      /**< Line bytes of a frame besides the payload */
+
+/**
+ * @brief Message types and their payloads.
+ */
+typedef enum {
+    MSG_ADC_FRAME = 1,    /**< Device: uint16 raw value, uint16 filtered value */
+    MSG_SCHEDULER_STATS,  /**< Device: uint32 ticks, uint8 tasks, then ProtocolStatistics */
+    MSG_BUTTON_EVENT,     /**< Device: uint8 BUTTON that was pressed */
+    MSG_CONFIG_WRITE,     /**< Host: uint8 PROTOCOL_CONFIG key, int16 value */
+    MSG_ACK               /**< Device: uint8 type, uint8 sequence, uint8 status (0 = done) */
+} PROTOCOL_MESSAGE;
+
+/**
+ * @brief Settings the host can write with MSG_CONFIG_WRITE.
+ */
+typedef enum {
+    CONFIG_ADC_INTERVAL = 1,   /**< Interval of the ADC task in ms */
+    CONFIG_TELEMETRY_INTERVAL, /**< Interval of the ADC frames in ms, 0 stops them */
+    CONFIG_STOPWATCH,          /**< 0 reset, 1 start, 2 stop */
+    CONFIG_CONSOLE             /**< Ends the binary mode, the text console takes over */
+} PROTOCOL_CONFIG;
+
+/**
+ * @brief A decoded frame.
+ */
+typedef struct {
+    uint8_t type;                          /**< PROTOCOL_MESSAGE */
+    uint8_t sequence;                      /**< Sequence number of the sender */
+    uint8_t length;                        /**< Bytes of the payload */
+    uint8_t payload[PROTOCOL_MAX_PAYLOAD]; /**< The payload */
+} ProtocolFrame;
+
+/**
+ * @brief Counters of the link.
+ */
+typedef struct {
+    uint16_t framesSent;       /**< Frames put into the transmit ring */
+    uint16_t framesDropped;    /**< Frames not sent as the ring was full */
+    uint16_t framesReceived;   /**< Frames received with a valid CRC */
+    uint16_t framesRejected;   /**< Frames with a wrong CRC, length or COBS coding */
+    uint32_t payloadBytesSent; /**< Payload bytes of the sent frames */
+    uint32_t lineBytesSent;    /**< Bytes of the sent frames on the line */
+} ProtocolStatistics;
+
+/**
+ * @brief Starts the binary mode.
+ *
+ * This function resets the decoder and the counters and enables the transmit interrupt
+ * of USCI_A0. From now on the receive interrupt has to pass the bytes to
+ * protocolReceiveByte() and the serial functions of templateEMP.h must not be used.
+ */
+extern void protocolStart(void);
+
+/**
+ * @brief Ends the binary mode once the transmit ring is empty.
+ */
+extern void protocolStop(void);
+
+/**
+ * @brief Checks whether the binary mode is active.
+ *
+ * @return Returns 1 in binary mode, 0 otherwise.
+ */
+extern uint8_t protocolIsActive(void);
+
+/**
+ * @brief Sends a message.
+ *
+ * @param type The PROTOCOL_MESSAGE.
+ * @param payload The payload, may be 0 if the length is 0.
+ * @param length Bytes of the payload, at most PROTOCOL_MAX_PAYLOAD.
+ *
+ * @return Returns 0 if the frame has been queued, or -1 if the payload is too long or
+ *         the transmit ring has no room for the frame; nothing is sent then.
+ */
+extern int8_t protocolSend(uint8_t type, const void *payload, uint8_t length);
+
+/**
+ * @brief Decodes a received byte.
+ *
+ * @param byte The byte.
+ *
+ * Called by the receive interrupt. A complete frame with a valid CRC is kept until
+ * protocolReceive() fetches it; a further frame received before is rejected.
+ */
+extern void protocolReceiveByte(uint8_t byte);
+
+/**
+ * @brief Fetches a received frame.
+ *
+ * @param frame Pointer to the frame to fill.
+ *
+ * @return Returns 1 if a frame has been received, 0 otherwise.
+ */
+extern uint8_t protocolReceive(ProtocolFrame *frame);
+
+/**
+ * @brief Reads the counters of the link.
+ *
+ * @param statistics Pointer to the counters to fill.
+ */
+extern void protocolGetStatistics(ProtocolStatistics *statistics);
+
+/**
+ * @brief Computes the CRC-16/CCITT-FALSE of a block.
+ *
+ * @param crc The start value, 0xFFFF, or the CRC of the previous block to continue.
+ * @param data The data.
+ * @param length Bytes of the data.
+ *
+ * @return The CRC.
+ */
+extern uint16_t protocolCrc16(uint16_t crc, const uint8_t *data, uint8_t length);
+
+#endif /* PROTOCOL_H */
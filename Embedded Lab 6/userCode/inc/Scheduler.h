@@ -3,7 +3,7 @@
 
 #include <stdint.h>
 
-#define MaxTasks 5
+#define MaxTasks 6
 
 
 
@@ -17,6 +17,9 @@ typedef struct {
 
 extern void initScheduler(void);
 extern void addTaskToScheduler(TaskFunction function, uint16_t interval);
+extern int8_t setTaskInterval(TaskFunction function, uint16_t interval);
 extern void runScheduler(void);
+extern uint32_t getSchedulerTicks(void);
+extern uint8_t getTaskCount(void);
 
 #endif /* SCHEDULER_H */
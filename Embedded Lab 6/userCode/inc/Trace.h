@@ -0,0 +1,120 @@
+/**
+ * @file    Trace.h
+ * @brief   Header file for the event trace.
+ *
+ * This file contains declarations for recording events in a ring in RAM. Every event
+ * takes four bytes: the time read from Timer0_A (TA0R, 1 us per count at 1 MHz), the
+ * event and an argument. Recording an event costs about 40 cycles; an event whose
+ * class is off in traceMask costs a single bit test, as TRACE() checks the mask before
+ * the call. Nothing is sent on the serial interface while recording, so the timing of
+ * the program stays the same and the trace can stay on.
+ *
+ * The ring holds the last TRACE_LENGTH events. Timer0_A wraps every 65.5 ms; the
+ * console task runs every 20 ms, so with the default mask there is always an event in
+ * between and the time differences in the dump are exact.
+ *
+ * The ring is not initialized at a reset. After a reset by the watchdog of the scheduler
+ * it still holds the events before the fault; recording then stays off until the ring
+ * has been printed with traceDump().
+ *
+ * tools/lab6_trace_json.c turns the printed dump into a Chrome trace for a timeline view.
+ * I2C transactions are not traced: Lab 6 has no I2C bus, and Lab 5, whose TwoWire.c and
+ * SysTick.c run the bus and the tick, has no trace, as its Timer0_A counts the 1 ms tick
+ * in up mode and is no free-running time base.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1     /**< 0 removes every TRACE() from the program */
+#endif
+
+#define TRACE_LENGTH 16     /**< Events in the ring, a power of two */
+
+/**
+ * @brief Events; the argument is given in brackets.
+ */
+typedef enum {
+    TRACE_BOOT,         /**< Start of the program (0) */
+    TRACE_ISR_ENTER,    /**< Start of an interrupt (TRACE_ISR) */
+    TRACE_ISR_EXIT,     /**< End of an interrupt (TRACE_ISR) */
+    TRACE_TASK_START,   /**< Scheduler runs a task (index of the task) */
+    TRACE_TASK_END,     /**< Task has returned (index of the task) */
+    TRACE_LCD_COMMAND,  /**< Command sent to the LCD (command byte) */
+    TRACE_ADC,          /**< ADC conversion read (value / 4) */
+    TRACE_BUTTON,       /**< Button pressed (BUTTON) */
+    TRACE_FRAME,        /**< Protocol frame received (message type) */
+    TRACE_EVENTS
+} TRACE_EVENT;
+
+/**
+ * @brief Interrupts named by TRACE_ISR_ENTER and TRACE_ISR_EXIT.
+ */
+typedef enum {
+    TRACE_ISR_SCHEDULER, /**< Timer1_A CCR0, the 1 ms tick */
+    TRACE_ISR_UART_RX,   /**< USCI_A0 receive */
+    TRACE_ISR_UART_TX    /**< USCI_A0 transmit */
+} TRACE_ISR;
+
+#define TRACE_MASK(event) (1u << (event)) /**< Bit of an event in traceMask */
+
+/** Recorded events after the start: all but the interrupts, which fill the ring fast */
+#define TRACE_DEFAULT_MASK \
+    (((1u << TRACE_EVENTS) - 1) & ~(TRACE_MASK(TRACE_ISR_ENTER) | TRACE_MASK(TRACE_ISR_EXIT)))
+
+/**
+ * @brief Events that are recorded, one bit per TRACE_EVENT; 0 while a post-mortem
+ *        trace waits to be printed.
+ */
+extern volatile uint16_t traceMask;
+
+#if TRACE_ENABLED
+#define TRACE(event, arg) \
+    do { if (traceMask & TRACE_MASK(event)) traceEvent((event), (arg)); } while (0)
+#else
+#define TRACE(event, arg) ((void)0)
+#endif
+
+/**
+ * @brief Initializes the trace.
+ *
+ * This function starts Timer0_A in continuous mode on SMCLK. After a watchdog reset the
+ * ring is kept for traceDump(), otherwise it is cleared and TRACE_BOOT is recorded.
+ * Has to be called before any other initialization that records events.
+ */
+extern void initTrace(void);
+
+/**
+ * @brief Records an event; use TRACE() instead, which checks traceMask first.
+ *
+ * @param event The TRACE_EVENT.
+ * @param arg The argument.
+ *
+ * May be called from interrupts.
+ */
+extern void traceEvent(uint8_t event, uint8_t arg);
+
+/**
+ * @brief Checks whether the ring holds the events before a watchdog reset.
+ *
+ * @return Returns 1 until traceDump() has printed them, 0 otherwise.
+ */
+extern uint8_t traceHasPostMortem(void);
+
+/**
+ * @brief Prints the ring, oldest event first, with the functions of templateEMP.h.
+ *
+ * Every line holds the time since the previous event in us, the event and its argument.
+ * Recording is paused while printing. A post-mortem trace is cleared afterwards and
+ * recording starts again with TRACE_DEFAULT_MASK.
+ */
+extern void traceDump(void);
+
+#endif /* TRACE_H */
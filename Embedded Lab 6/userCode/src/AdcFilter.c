@@ -0,0 +1,165 @@
+/**
+ * @file    AdcFilter.c
+ * @brief   Integer filters for smoothing ADC10 readings.
+ *
+ * This file contains implementations of a moving average, an exponential smoothing filter
+ * and an oversample-and-decimate stage. All filters work on plain 16-bit integers with
+ * shifts instead of divisions, so they are cheap enough to run on every DTC frame without
+ * the floating point library.
+ *
+ * @date    25.05.2024
+ * @authors 
+ * - Bjoern Metzger
+ * - Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+
+#include "../inc/AdcFilter.h"
+
+/**
+ * @brief Initializes a moving average filter.
+ *
+ * @param filter Pointer to the filter to initialize.
+ * @param initialValue Value the window is filled with.
+ */
+void movingAverageInit(MovingAverageFilter *filter, uint16_t initialValue)
+{
+    uint8_t i;
+
+    for (i = 0; i < MOVING_AVERAGE_LENGTH; i++)
+    {
+        filter->samples[i] = initialValue;
+    }
+    filter->sum = initialValue << MOVING_AVERAGE_SHIFT;
+    filter->index = 0;
+}
+
+/**
+ * @brief Adds a sample to a moving average filter.
+ *
+ * The running sum is updated by replacing the oldest sample, so the cost is independent
+ * of the window length.
+ *
+ * @param filter Pointer to the filter.
+ * @param sample The new 10-bit ADC sample.
+ * @return The average over the last MOVING_AVERAGE_LENGTH samples.
+ */
+uint16_t movingAverageUpdate(MovingAverageFilter *filter, uint16_t sample)
+{
+    filter->sum -= filter->samples[filter->index];
+    filter->sum += sample;
+    filter->samples[filter->index] = sample;
+    filter->index = (filter->index + 1) & (MOVING_AVERAGE_LENGTH - 1);
+
+    return filter->sum >> MOVING_AVERAGE_SHIFT;
+}
+
+/**
+ * @brief Initializes an exponential smoothing filter.
+ *
+ * @param filter Pointer to the filter to initialize.
+ * @param shift Alpha as a power of two (alpha = 1 / 2^shift).
+ * @param initialValue Initial output of the filter.
+ */
+void expFilterInit(ExponentialFilter *filter, uint8_t shift, uint16_t initialValue)
+{
+    if (shift > EXP_FILTER_MAX_SHIFT)
+    {
+        shift = EXP_FILTER_MAX_SHIFT;
+    }
+    filter->shift = shift;
+    filter->state = initialValue << shift;
+}
+
+/**
+ * @brief Adds a sample to an exponential smoothing filter.
+ *
+ * Computes state = state - state / 2^shift + sample, which keeps the output (state >> shift)
+ * free of the truncation drift a plain y += (x - y) >> shift would have.
+ *
+ * @param filter Pointer to the filter.
+ * @param sample The new 10-bit ADC sample.
+ * @return The smoothed value.
+ */
+uint16_t expFilterUpdate(ExponentialFilter *filter, uint16_t sample)
+{
+    filter->state = filter->state - (filter->state >> filter->shift) + sample;
+
+    return filter->state >> filter->shift;
+}
+
+/**
+ * @brief Initializes an oversample-and-decimate stage.
+ *
+ * @param decimator Pointer to the decimator to initialize.
+ * @param extraBits Bits of resolution to gain.
+ */
+void decimatorInit(Decimator *decimator, uint8_t extraBits)
+{
+    if (extraBits > DECIMATOR_MAX_EXTRA_BITS)
+    {
+        extraBits = DECIMATOR_MAX_EXTRA_BITS;
+    }
+    decimator->extraBits = extraBits;
+    decimator->accumulator = 0;
+    decimator->count = 0;
+    decimator->result = 0;
+}
+
+/**
+ * @brief Adds a sample to an oversample-and-decimate stage.
+ *
+ * Every 4^extraBits samples the sum is shifted right by extraBits, which yields a result
+ * with extraBits more bits than the converter. The ADC noise of about one LSB acts as the
+ * dither that makes the extra bits meaningful.
+ *
+ * @param decimator Pointer to the decimator.
+ * @param sample The new 10-bit ADC sample.
+ * @return 1 if a new result is available in decimator->result, 0 otherwise.
+ */
+uint8_t decimatorUpdate(Decimator *decimator, uint16_t sample)
+{
+    decimator->accumulator += sample;
+    decimator->count++;
+
+    // 4^extraBits == 1 << (2 * extraBits)
+    if (decimator->count < (1 << (decimator->extraBits << 1)))
+    {
+        return 0;
+    }
+
+    decimator->result = decimator->accumulator >> decimator->extraBits;
+    decimator->accumulator = 0;
+    decimator->count = 0;
+
+    return 1;
+}
+
+/**
+ * @brief Oversamples and decimates a block of DTC frames in one go.
+ *
+ * @param samples Pointer to the first sample of the channel in the DTC buffer.
+ * @param stride Distance in words between two samples of the same channel.
+ * @param extraBits Bits of resolution to gain; the buffer must hold 4^extraBits frames.
+ * @return The (10 + extraBits)-bit decimated value.
+ */
+uint16_t decimateFrames(const uint16_t *samples, uint8_t stride, uint8_t extraBits)
+{
+    uint16_t accumulator = 0;
+    uint8_t count;
+
+    if (extraBits > DECIMATOR_MAX_EXTRA_BITS)
+    {
+        extraBits = DECIMATOR_MAX_EXTRA_BITS;
+    }
+
+    for (count = 1 << (extraBits << 1); count > 0; count--)
+    {
+        accumulator += *samples;
+        samples += stride;
+    }
+
+    return accumulator >> extraBits;
+}
@@ -15,6 +15,16 @@
 #include <stdint.h>
 #include <msp430g2553.h>
 #include "../inc/Hardware.h"
+#include "../inc/AdcFilter.h"
+#include "../inc/Trace.h"
+
+#define ADC_BLOCK_LENGTH (1 << (ADC_EXTRA_BITS << 1)) /**< Conversions per decimated value */
+#define ADC_NO_RESULT 0xFFFF                           /**< No block has completed yet */
+
+static uint16_t adcBlock[ADC_BLOCK_LENGTH];  /**< DTC target of the running block */
+static volatile uint16_t adcOversampled;     /**< Decimated value of the last completed block */
+
+static void startADCBlock(void);
 
 /**
  * @brief Initializes all hardware components including buttons, LEDs, and ADC.
@@ -115,28 +125,80 @@ BUTTON getPressedButton()
  * This function configures the ADC settings to enable analog input conversion.
  * It sets up the ADC channels, reference voltage, sample-and-hold time, and ADC conversion
  * sequence. Additionally, it enables the ADC and sets up the data transfer control for the ADC.
+ * The DTC writes ADC_BLOCK_LENGTH conversions per block and the ADC interrupt fires once a
+ * block is complete.
  */
 void initADC()
 {
-    ADC10CTL1 = INCH_6 + ADC10DIV_0 + CONSEQ_2 + SHS_0; // Select channel 6
-    ADC10CTL0 = SREF_0 + ADC10SHT_2 + MSC + ADC10ON;    // Power ADC on; use 16 clocks as sample & hold time
-    ADC10AE0 = BIT6;                                    // Enable P1.6 as AD-input
-    ADC10DTC1 = 2;                                      // Enable 1 conversion
+    ADC10CTL1 = INCH_6 + ADC10DIV_0 + CONSEQ_2 + SHS_0;          // Select channel 6, repeat single channel
+    ADC10CTL0 = SREF_0 + ADC10SHT_2 + MSC + ADC10ON + ADC10IE;   // Power ADC on; use 16 clocks as sample & hold time
+    ADC10AE0 = BIT6;                                             // Enable P1.6 as AD-input
+    ADC10DTC1 = ADC_BLOCK_LENGTH;                                // Conversions per DTC block
+    adcOversampled = ADC_NO_RESULT;
+    startADCBlock(); // The first readADC() waits for this block
 }
 
 /**
  * @brief Reads an analog value from the ADC channel.
  *
- * This function reads the analog value stored in memory by the DMA controller.
- *
- * @return The analog value read from the ADC channel.
+ * @return The 10-bit value of the last completed block.
  */
 uint16_t readADC()
+{
+    return readADCOversampled() >> ADC_EXTRA_BITS;
+}
+
+/**
+ * @brief Reads the ADC channel with more bits than the converter has.
+ *
+ * This function returns the decimated value of the last block the DTC has completed and
+ * starts the next block, so the caller never waits for the conversions. The value is
+ * converted right after the previous call and therefore lags by one call interval. Only
+ * the first call after initADC() waits for its block, about 100 us.
+ *
+ * @return The (10 + ADC_EXTRA_BITS)-bit value.
+ */
+uint16_t readADCOversampled()
+{
+    uint16_t value;
+
+    while (adcOversampled == ADC_NO_RESULT)
+        ;
+    value = adcOversampled;
+
+    // The interrupt clears ENC once the block is complete
+    if (!(ADC10CTL0 & ENC))
+    {
+        startADCBlock();
+    }
+
+    TRACE(TRACE_ADC, value >> (ADC_EXTRA_BITS + 2));
+
+    return value;
+}
+
+/**
+ * @brief Starts the conversion of one block into adcBlock.
+ */
+static void startADCBlock(void)
 {
     ADC10CTL0 &= ~ENC; // Disable ADC conversion
     while (ADC10CTL1 & BUSY)
-        ;                        // Wait until ADC is finished with the conversion
-    ADC10CTL0 |= ENC + ADC10SC; // Start ADC conversion
+        ;                          // Wait until ADC is finished with the conversion
+    ADC10SA = (uint16_t)adcBlock;  // Arm the DTC for one block
+    ADC10CTL0 |= ENC + ADC10SC;    // Start ADC conversion
+}
 
-    return ADC10MEM;
+/**
+ * @brief ADC10 interrupt service routine.
+ *
+ * This ISR is triggered when the DTC has written the last value of a block. It stops the
+ * repeated conversions and decimates the block in place, which costs about one add per
+ * sample instead of a conversion wait per sample in the caller.
+ */
+#pragma vector = ADC10_VECTOR
+__interrupt void adc10ISR(void)
+{
+    ADC10CTL0 &= ~ENC; // Stop after the current conversion, the DTC is already done
+    adcOversampled = decimateFrames(adcBlock, 1, ADC_EXTRA_BITS);
 }
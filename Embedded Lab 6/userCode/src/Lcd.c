@@ -14,6 +14,7 @@
 #include <msp430g2553.h>
 #include <stdint.h>
 #include "../inc/Lcd.h"
+#include "../inc/Trace.h"
 
 #define LCD_NUM_COLS      16
 
@@ -127,6 +128,12 @@ static void sendCmd(char rs, uint8_t data)
 {
     while (read8Bit(0) & LCD_STATUS_BUSY);
 
+    // Characters are not traced, a line of text would fill the ring
+    if (rs == 0)
+    {
+        TRACE(TRACE_LCD_COMMAND, data);
+    }
+
     write8Bit(rs, 0, data);
 }
 
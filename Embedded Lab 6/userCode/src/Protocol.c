@@ -0,0 +1,380 @@
+/**
+ * @file    Protocol.c
+ * @brief   Binary frame protocol on the serial interface.
+ *
+ * This file contains the COBS coding, the CRC and the transmit ring of the frame
+ * protocol. A frame is encoded straight into the transmit ring; the USCI_A0 transmit
+ * interrupt sends one byte of the ring per interrupt and disables itself when the ring
+ * is empty. The decoder keeps the state of the COBS block being received, so every byte
+ * is decoded in a few cycles inside the receive interrupt.
+ *
+ * @date    25.05.2024
+ * @authors
+ * - Bjoern Metzger
+ * - Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <msp430g2553.h>
+
+#include "../inc/Protocol.h"
+#include "../inc/Trace.h"
+
+#define FRAME_HEADER 2                                  // Type and sequence
+#define FRAME_CRC 2                                     // CRC16, low byte first
+#define FRAME_MAX (FRAME_HEADER + PROTOCOL_MAX_PAYLOAD + FRAME_CRC)
+#define TX_MASK (PROTOCOL_TX_BUFFER - 1)
+
+#define COBS_DELIMITER 0x00
+#define COBS_MAX_BLOCK 0xFF                             // Code of a block without a zero
+
+// CRC of four bits at a time, 32 bytes of flash instead of 512 for a byte table
+static const uint16_t crcTable[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+static volatile uint8_t active = 0;          // 1 in binary mode
+static volatile uint8_t stopping = 0;        // 1 until the ring is empty after protocolStop()
+static uint8_t txSequence = 0;               // Sequence number of the next frame
+static uint8_t txBuffer[PROTOCOL_TX_BUFFER]; // Ring of encoded bytes
+static volatile uint8_t txHead = 0;          // Next byte to write, changed by protocolSend()
+static volatile uint8_t txTail = 0;          // Next byte to send, changed by the interrupt
+
+static uint8_t rxData[FRAME_MAX];            // Decoded bytes of the frame being received
+static uint8_t rxLength = 0;                 // Decoded bytes so far
+static uint8_t rxBlockLeft = 0;              // Bytes left in the current COBS block
+static uint8_t rxZeroPending = 0;            // 1 if the current block ends with a zero
+static uint8_t rxError = 0;                  // 1 if the frame is dropped at the delimiter
+static ProtocolFrame received;               // Frame waiting for protocolReceive()
+static volatile uint8_t receivedReady = 0;   // 1 if received holds a frame
+
+static ProtocolStatistics statistics;
+
+static void resetDecoder(void);
+static void finishFrame(void);
+static void putByte(uint8_t byte);
+
+/**
+ * @brief Starts the binary mode.
+ */
+void protocolStart(void)
+{
+    txHead = 0;
+    txTail = 0;
+    txSequence = 0;
+    resetDecoder();
+    receivedReady = 0;
+    memset(&statistics, 0, sizeof(statistics));
+
+    stopping = 0;
+    active = 1;
+}
+
+/**
+ * @brief Ends the binary mode once the transmit ring is empty.
+ */
+void protocolStop(void)
+{
+    uint16_t state = __get_interrupt_state();
+    __disable_interrupt();
+
+    if (txHead == txTail)
+    {
+        active = 0;
+    }
+    else
+    {
+        // The transmit interrupt ends the mode after the last byte
+        stopping = 1;
+    }
+
+    __set_interrupt_state(state);
+}
+
+/**
+ * @brief Checks whether the binary mode is active.
+ *
+ * @return Returns 1 in binary mode, 0 otherwise.
+ */
+uint8_t protocolIsActive(void)
+{
+    return active;
+}
+
+/**
+ * @brief Sends a message.
+ *
+ * @param type The PROTOCOL_MESSAGE.
+ * @param payload The payload, may be 0 if the length is 0.
+ * @param length Bytes of the payload, at most PROTOCOL_MAX_PAYLOAD.
+ *
+ * @return Returns 0 if the frame has been queued, or -1 otherwise.
+ */
+int8_t protocolSend(uint8_t type, const void *payload, uint8_t length)
+{
+    uint8_t frame[FRAME_MAX];
+    uint8_t frameLength = FRAME_HEADER + length + FRAME_CRC;
+    uint8_t free;
+    uint16_t crc;
+    uint8_t start = 0;
+    uint8_t end;
+
+    if (!active || stopping || length > PROTOCOL_MAX_PAYLOAD)
+    {
+        return -1;
+    }
+
+    // A frame shorter than 254 bytes needs one code byte plus the delimiter
+    free = (uint8_t)(TX_MASK - ((txHead - txTail) & TX_MASK));
+    if (free < frameLength + 2)
+    {
+        statistics.framesDropped++;
+        return -1;
+    }
+
+    frame[0] = type;
+    frame[1] = txSequence;
+    memcpy(&frame[FRAME_HEADER], payload, length);
+    crc = protocolCrc16(0xFFFF, frame, FRAME_HEADER + length);
+    frame[FRAME_HEADER + length] = (uint8_t)crc;
+    frame[FRAME_HEADER + length + 1] = (uint8_t)(crc >> 8);
+
+    // Every block is a code byte with the distance to the next zero, then the bytes
+    while (1)
+    {
+        end = start;
+        while (end < frameLength && frame[end] != 0)
+        {
+            end++;
+        }
+
+        putByte(end - start + 1);
+        while (start < end)
+        {
+            putByte(frame[start++]);
+        }
+
+        if (end >= frameLength)
+        {
+            break;
+        }
+        start = end + 1; // Skip the zero, the code byte stands for it
+    }
+    putByte(COBS_DELIMITER);
+
+    txSequence++;
+    statistics.framesSent++;
+    statistics.payloadBytesSent += length;
+    statistics.lineBytesSent += frameLength + 2;
+
+    // The interrupt is pending at once if the transmit buffer is empty
+    IE2 |= UCA0TXIE;
+
+    return 0;
+}
+
+/**
+ * @brief Decodes a received byte.
+ *
+ * @param byte The byte.
+ */
+void protocolReceiveByte(uint8_t byte)
+{
+    if (!active)
+    {
+        return;
+    }
+
+    if (byte == COBS_DELIMITER)
+    {
+        finishFrame();
+        resetDecoder();
+        return;
+    }
+
+    if (rxError)
+    {
+        return;
+    }
+
+    if (rxBlockLeft == 0)
+    {
+        // Code byte: the zero of the previous block comes first
+        if (rxZeroPending)
+        {
+            if (rxLength >= FRAME_MAX)
+            {
+                rxError = 1;
+                return;
+            }
+            rxData[rxLength++] = 0;
+        }
+        rxBlockLeft = byte - 1;
+        rxZeroPending = (byte != COBS_MAX_BLOCK);
+    }
+    else
+    {
+        if (rxLength >= FRAME_MAX)
+        {
+            rxError = 1;
+            return;
+        }
+        rxData[rxLength++] = byte;
+        rxBlockLeft--;
+    }
+}
+
+/**
+ * @brief Fetches a received frame.
+ *
+ * @param frame Pointer to the frame to fill.
+ *
+ * @return Returns 1 if a frame has been received, 0 otherwise.
+ */
+uint8_t protocolReceive(ProtocolFrame *frame)
+{
+    uint16_t state;
+
+    if (!receivedReady)
+    {
+        return 0;
+    }
+
+    state = __get_interrupt_state();
+    __disable_interrupt();
+
+    memcpy(frame, &received, sizeof(received));
+    receivedReady = 0;
+
+    __set_interrupt_state(state);
+
+    return 1;
+}
+
+/**
+ * @brief Reads the counters of the link.
+ *
+ * @param statisticsOut Pointer to the counters to fill.
+ */
+void protocolGetStatistics(ProtocolStatistics *statisticsOut)
+{
+    uint16_t state = __get_interrupt_state();
+    __disable_interrupt();
+
+    memcpy(statisticsOut, &statistics, sizeof(statistics));
+
+    __set_interrupt_state(state);
+}
+
+/**
+ * @brief Computes the CRC-16/CCITT-FALSE of a block.
+ *
+ * @param crc The start value, 0xFFFF, or the CRC of the previous block to continue.
+ * @param data The data.
+ * @param length Bytes of the data.
+ *
+ * @return The CRC.
+ */
+uint16_t protocolCrc16(uint16_t crc, const uint8_t *data, uint8_t length)
+{
+    while (length--)
+    {
+        crc = (crc << 4) ^ crcTable[(crc >> 12) ^ (*data >> 4)];
+        crc = (crc << 4) ^ crcTable[(crc >> 12) ^ (*data & 0x0F)];
+        data++;
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Prepares the decoder for the next frame.
+ */
+static void resetDecoder(void)
+{
+    rxLength = 0;
+    rxBlockLeft = 0;
+    rxZeroPending = 0;
+    rxError = 0;
+}
+
+/**
+ * @brief Checks the frame ended by a delimiter and keeps it for protocolReceive().
+ */
+static void finishFrame(void)
+{
+    uint16_t crc;
+    uint8_t dataLength;
+
+    // Delimiters in a row are allowed, the host may send one to synchronize
+    if (rxLength == 0 && !rxError && rxBlockLeft == 0)
+    {
+        return;
+    }
+
+    if (rxError || rxBlockLeft != 0 || rxLength < FRAME_HEADER + FRAME_CRC || receivedReady)
+    {
+        statistics.framesRejected++;
+        return;
+    }
+
+    dataLength = rxLength - FRAME_CRC;
+    crc = protocolCrc16(0xFFFF, rxData, dataLength);
+    if (rxData[dataLength] != (uint8_t)crc || rxData[dataLength + 1] != (uint8_t)(crc >> 8))
+    {
+        statistics.framesRejected++;
+        return;
+    }
+
+    received.type = rxData[0];
+    received.sequence = rxData[1];
+    received.length = dataLength - FRAME_HEADER;
+    memcpy(received.payload, &rxData[FRAME_HEADER], received.length);
+    receivedReady = 1;
+    statistics.framesReceived++;
+    TRACE(TRACE_FRAME, received.type);
+}
+
+/**
+ * @brief Writes a byte into the transmit ring; protocolSend() has checked the room.
+ *
+ * @param byte The byte.
+ */
+static void putByte(uint8_t byte)
+{
+    txBuffer[txHead] = byte;
+    txHead = (txHead + 1) & TX_MASK;
+}
+
+/**
+ * @brief USCI_A0 transmit interrupt service routine.
+ *
+ * Sends the next byte of the ring. When the ring is empty the interrupt is disabled
+ * until protocolSend() queues the next frame.
+ */
+#pragma vector=USCIAB0TX_VECTOR
+__interrupt void protocolTxISR(void)
+{
+    TRACE(TRACE_ISR_ENTER, TRACE_ISR_UART_TX);
+
+    if (txHead != txTail)
+    {
+        UCA0TXBUF = txBuffer[txTail];
+        txTail = (txTail + 1) & TX_MASK;
+    }
+    else
+    {
+        IE2 &= ~UCA0TXIE;
+
+        if (stopping)
+        {
+            stopping = 0;
+            active = 0;
+        }
+    }
+
+    TRACE(TRACE_ISR_EXIT, TRACE_ISR_UART_TX);
+}
@@ -16,6 +16,8 @@
 #include <stdint.h>
 #include <msp430g2553.h>
 #include "../inc/Scheduler.h"
+#include "../inc/Trace.h"
+#include "../inc/Power.h"
 
 // Array to hold the scheduled tasks
 Task taskList[MaxTasks];
@@ -23,6 +25,9 @@ Task taskList[MaxTasks];
 // Counter to keep track of the number of tasks
 uint8_t taskCount = 0;
 
+// Milliseconds since the scheduler was started
+static volatile uint32_t schedulerTicks = 0;
+
 /**
  * @brief Initializes the scheduler and sets up the timer interrupt.
  *
@@ -53,20 +58,78 @@ void addTaskToScheduler(TaskFunction function, uint16_t interval) {
     }
 }
 
+/**
+ * @brief Changes the interval of a scheduled task.
+ *
+ * @param function The function pointer of the task.
+ * @param interval The new interval in milliseconds, at least 1.
+ * @return 0 on success, -1 if the task is not scheduled or the interval is 0.
+ *
+ * The new interval takes effect after the next run of the task.
+ */
+int8_t setTaskInterval(TaskFunction function, uint16_t interval) {
+    uint8_t i = 0;
+
+    if (interval == 0) {
+        return -1;
+    }
+
+    for (i = 0; i < taskCount; i++) {
+        if (taskList[i].function == function) {
+            taskList[i].interval = interval;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
 /**
  * @brief Starts the scheduler and enters low power mode.
  *
  * This function enables interrupts and enters a low power mode,
  * allowing the scheduler to run tasks based on the timer interrupts.
+ * The watchdog is started on ACLK from the VLO (about 12 kHz) and reset on
+ * every tick; a task that blocks the scheduler for about 2.7 s resets the
+ * controller, the trace then shows what happened before.
  */
 void runScheduler(void) {
+    BCSCTL3 |= LFXT1S_2;                            // ACLK from the VLO
+    WDTCTL = WDTPW + WDTCNTCL + WDTSSEL;            // Watchdog, ACLK / 32768
+    powerRequire(POWER_SMCLK | POWER_ACLK);         // Timer A1, the watchdog
     __enable_interrupt();
     while (1) {
-        // Low power mode with interrupts enabled
-        __bis_SR_register(LPM0_bits + GIE);
+        // Low power mode with interrupts enabled, the tasks run in the timer interrupt
+        powerIdle();
     }
 }
 
+/**
+ * @brief Returns the time since the scheduler was started.
+ *
+ * @return The number of 1 ms ticks.
+ */
+uint32_t getSchedulerTicks(void) {
+    uint32_t ticks;
+    uint16_t state = __get_interrupt_state();
+
+    // The 32-bit counter is changed in two words by the ISR
+    __disable_interrupt();
+    ticks = schedulerTicks;
+    __set_interrupt_state(state);
+
+    return ticks;
+}
+
+/**
+ * @brief Returns the number of scheduled tasks.
+ *
+ * @return The number of tasks, at most MaxTasks.
+ */
+uint8_t getTaskCount(void) {
+    return taskCount;
+}
+
 /**
  * @brief Timer A1 interrupt service routine.
  *
@@ -79,15 +142,21 @@ __interrupt void Timer1A0ISR(void) {
     __bic_SR_register(GIE); // Disable interrupts
 
     uint8_t i = 0;
+    TRACE(TRACE_ISR_ENTER, TRACE_ISR_SCHEDULER);
+    WDTCTL = WDTPW + WDTCNTCL + WDTSSEL;            // Reset the watchdog
+    schedulerTicks++;
     for (i = 0; i < taskCount; i++) {
         if (taskList[i].counter > 0) {
             taskList[i].counter--;
         }
         if (taskList[i].counter == 0) {
+            TRACE(TRACE_TASK_START, i);
             taskList[i].function();
+            TRACE(TRACE_TASK_END, i);
             taskList[i].counter = taskList[i].interval;
         }
     }
+    TRACE(TRACE_ISR_EXIT, TRACE_ISR_SCHEDULER);
 
     __bis_SR_register(GIE); // Enable interrupts
 }
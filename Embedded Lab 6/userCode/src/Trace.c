@@ -0,0 +1,197 @@
+/**
+ * @file    Trace.c
+ * @brief   Event trace in a ring in RAM.
+ *
+ * This file contains the implementation of the event trace. The ring, its position and
+ * a magic number are placed in memory that is not initialized at a reset, so the events
+ * survive a reset by the watchdog. The magic number tells a ring written by the last run
+ * from the random contents after power-on.
+ *
+ * @date    25.05.2024
+ * @authors
+ * - Bjoern Metzger
+ * - Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+#include <msp430g2553.h>
+
+#include "../inc/Trace.h"
+
+#define TRACE_MASK_INDEX (TRACE_LENGTH - 1)
+#define TRACE_MAGIC 0x7ACE
+
+// Defined by templateEMP.h in main.c
+extern void serialWrite(char tx);
+extern void serialPrint(char *tx);
+extern void serialPrintln(char *tx);
+
+// One recorded event
+typedef struct {
+    uint16_t time;  // TA0R when the event was recorded
+    uint8_t event;  // TRACE_EVENT
+    uint8_t arg;    // Argument of the event
+} TraceRecord;
+
+// Ring with the state needed to read it after a reset
+typedef struct {
+    uint16_t magic;                     // TRACE_MAGIC once the ring has been cleared
+    uint8_t head;                       // Next record to write
+    uint8_t count;                      // Valid records, at most TRACE_LENGTH
+    TraceRecord records[TRACE_LENGTH];
+} TraceRing;
+
+// Names printed by traceDump(), in the order of TRACE_EVENT
+static const char *const eventNames[TRACE_EVENTS] = {
+    "boot", "isr-enter", "isr-exit", "task-start", "task-end", "lcd-cmd", "adc", "button",
+    "frame"
+};
+
+#pragma NOINIT(ring)
+static TraceRing ring;
+
+volatile uint16_t traceMask = 0;
+
+static uint8_t postMortem = 0;      // 1 while the ring holds the events before a fault
+
+static void clearRing(void);
+static void writeNumber(uint16_t number);
+
+/**
+ * @brief Initializes the trace.
+ */
+void initTrace(void)
+{
+    // Free running time base, 1 us per count at 1 MHz
+    TA0CTL = TASSEL_2 + MC_2 + TACLR;
+
+    if ((IFG1 & WDTIFG) && ring.magic == TRACE_MAGIC
+        && ring.head < TRACE_LENGTH && ring.count <= TRACE_LENGTH)
+    {
+        IFG1 &= ~WDTIFG;
+        postMortem = 1;
+        traceMask = 0;
+        return;
+    }
+
+    IFG1 &= ~WDTIFG;
+    clearRing();
+    traceMask = TRACE_DEFAULT_MASK;
+    TRACE(TRACE_BOOT, 0);
+}
+
+/**
+ * @brief Records an event.
+ *
+ * @param event The TRACE_EVENT.
+ * @param arg The argument.
+ */
+void traceEvent(uint8_t event, uint8_t arg)
+{
+    TraceRecord *record;
+    uint16_t state = __get_interrupt_state();
+    __disable_interrupt();
+
+    record = &ring.records[ring.head];
+    record->time = TA0R;
+    record->event = event;
+    record->arg = arg;
+
+    ring.head = (ring.head + 1) & TRACE_MASK_INDEX;
+    if (ring.count < TRACE_LENGTH)
+    {
+        ring.count++;
+    }
+
+    __set_interrupt_state(state);
+}
+
+/**
+ * @brief Checks whether the ring holds the events before a watchdog reset.
+ *
+ * @return Returns 1 until traceDump() has printed them, 0 otherwise.
+ */
+uint8_t traceHasPostMortem(void)
+{
+    return postMortem;
+}
+
+/**
+ * @brief Prints the ring, oldest event first.
+ */
+void traceDump(void)
+{
+    uint16_t mask = traceMask;
+    uint8_t index;
+    uint8_t i;
+    uint16_t previous;
+    const TraceRecord *record;
+
+    traceMask = 0;
+
+    serialPrint(postMortem ? "Trace before the watchdog reset, " : "Trace, ");
+    writeNumber(ring.count);
+    serialPrintln(" events (+us event arg)");
+
+    index = (ring.head - ring.count) & TRACE_MASK_INDEX;
+    previous = ring.records[index].time;
+
+    for (i = 0; i < ring.count; i++)
+    {
+        record = &ring.records[index];
+
+        // The difference of two 16-bit times is right across a wrap of TA0R
+        serialWrite('+');
+        writeNumber(record->time - previous);
+        serialWrite(' ');
+        serialPrint(record->event < TRACE_EVENTS ? (char *)eventNames[record->event] : "?");
+        serialWrite(' ');
+        writeNumber(record->arg);
+        serialPrintln("");
+
+        previous = record->time;
+        index = (index + 1) & TRACE_MASK_INDEX;
+    }
+
+    if (postMortem)
+    {
+        postMortem = 0;
+        clearRing();
+        mask = TRACE_DEFAULT_MASK;
+    }
+
+    traceMask = mask;
+}
+
+/**
+ * @brief Empties the ring.
+ */
+static void clearRing(void)
+{
+    ring.magic = TRACE_MAGIC;
+    ring.head = 0;
+    ring.count = 0;
+}
+
+/**
+ * @brief Sends an unsigned number without a buffer.
+ *
+ * @param number The number.
+ */
+static void writeNumber(uint16_t number)
+{
+    uint16_t divisor = 10000;
+
+    while (divisor > 1 && number < divisor)
+    {
+        divisor /= 10;
+    }
+
+    while (divisor > 0)
+    {
+        serialWrite('0' + number / divisor);
+        number %= divisor;
+        divisor /= 10;
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @file    console_hash.c
+ * @brief   Host tool for the hash field of the console command tables.
+ *
+ * The command tables of the console (Console.h) store the hash of every command name,
+ * so the console needs no RAM for them. This program prints the table entry start with
+ * the hash for every name given on the command line, e.g. {"stats", 0x1234, ...}.
+ * Without arguments it checks that "help", the built-in command, has the hash Console.c
+ * uses. Console.c is the same in Labs 4, 5 and 6.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -Wall -I"Embedded Lab 4" -o console_hash tools/console_hash.c "Embedded Lab 4/Console.c" && ./console_hash stats report calibrate
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "Console.h"
+
+#define HELP_HASH 0x5C94 // Value in Console.c
+
+// Functions of templateEMP.h used by Console.c
+char serialAvailable(void)
+{
+    return 0;
+}
+
+int serialRead(void)
+{
+    return -1;
+}
+
+void serialWrite(char tx)
+{
+    putchar(tx);
+}
+
+void serialPrint(char *tx)
+{
+    fputs(tx, stdout);
+}
+
+void serialPrintln(char *tx)
+{
+    puts(tx);
+}
+
+int main(int argc, char *argv[])
+{
+    int i;
+
+    if (argc < 2)
+    {
+        printf("help: 0x%04X, Console.c 0x%04X\n", consoleHash("help"), HELP_HASH);
+        return consoleHash("help") != HELP_HASH;
+    }
+
+    for (i = 1; i < argc; i++)
+    {
+        printf("{\"%s\", 0x%04X, ...}\n", argv[i], consoleHash(argv[i]));
+    }
+
+    return 0;
+}
@@ -0,0 +1,337 @@
+/**
+ * @file    HostLink.c
+ * @brief   Linux side of the Lab 6 frame protocol.
+ *
+ * This file contains the implementation of the host link. Received bytes are collected
+ * up to the delimiter and the line is decoded as a whole; the device decodes byte by
+ * byte instead, as it has no room for a line buffer in its receive interrupt.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "HostLink.h"
+
+#define FRAME_HEADER 2 // Type and sequence
+#define FRAME_CRC 2    // CRC16, low byte first
+#define FRAME_MAX (FRAME_HEADER + PROTOCOL_MAX_PAYLOAD + FRAME_CRC)
+#define COBS_DELIMITER 0x00
+#define COBS_MAX_BLOCK 0xFF
+
+static long elapsedMs(const struct timespec *start);
+
+/**
+ * @brief Opens a serial device at 9600 baud, 8N1, without any processing of the bytes.
+ *
+ * @param link The link to set up.
+ * @param path Path of the device.
+ *
+ * @return Returns 0 on success, or -1 with errno set.
+ */
+int hostLinkOpen(HostLink *link, const char *path)
+{
+    struct termios settings;
+
+    memset(link, 0, sizeof(*link));
+    link->fd = open(path, O_RDWR | O_NOCTTY);
+    if (link->fd < 0)
+    {
+        return -1;
+    }
+
+    if (tcgetattr(link->fd, &settings) != 0)
+    {
+        close(link->fd);
+        link->fd = -1;
+        return -1;
+    }
+    cfmakeraw(&settings);
+    cfsetispeed(&settings, B9600);
+    cfsetospeed(&settings, B9600);
+    settings.c_cflag |= CLOCAL | CREAD;
+    settings.c_cflag &= ~(CSTOPB | PARENB);
+    if (tcsetattr(link->fd, TCSANOW, &settings) != 0)
+    {
+        close(link->fd);
+        link->fd = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Closes the device.
+ *
+ * @param link The link.
+ */
+void hostLinkClose(HostLink *link)
+{
+    if (link->fd >= 0)
+    {
+        close(link->fd);
+        link->fd = -1;
+    }
+}
+
+/**
+ * @brief Sends a message.
+ *
+ * @param link The link.
+ * @param type The PROTOCOL_MESSAGE.
+ * @param payload The payload, may be 0 if the length is 0.
+ * @param length Bytes of the payload, at most PROTOCOL_MAX_PAYLOAD.
+ *
+ * @return Returns 0 on success, or -1 if the payload is too long or the write failed.
+ */
+int hostLinkSend(HostLink *link, uint8_t type, const void *payload, uint8_t length)
+{
+    uint8_t line[HOST_LINK_MAX_LINE];
+    uint8_t lineLength = hostLinkEncode(type, link->txSequence, payload, length, line);
+    uint8_t written = 0;
+    ssize_t result;
+
+    if (lineLength == 0)
+    {
+        return -1;
+    }
+
+    while (written < lineLength)
+    {
+        result = write(link->fd, &line[written], lineLength - written);
+        if (result < 0 && errno != EINTR)
+        {
+            return -1;
+        }
+        written += result > 0 ? (uint8_t)result : 0;
+    }
+    link->txSequence++;
+
+    return 0;
+}
+
+/**
+ * @brief Waits for the next valid frame.
+ *
+ * @param link The link.
+ * @param frame Pointer to the frame to fill.
+ * @param timeoutMs Longest time to wait in ms.
+ *
+ * @return Returns 1 if a frame has been received, 0 on a timeout or -1 if the read
+ *         failed.
+ */
+int hostLinkReceive(HostLink *link, ProtocolFrame *frame, int timeoutMs)
+{
+    struct pollfd device = {link->fd, POLLIN, 0};
+    struct timespec start;
+    long left;
+    uint8_t byte;
+    int result;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while ((left = timeoutMs - elapsedMs(&start)) > 0)
+    {
+        result = poll(&device, 1, (int)left);
+        if (result < 0 && errno != EINTR)
+        {
+            return -1;
+        }
+        if (result <= 0)
+        {
+            continue;
+        }
+
+        // One byte at a time, the rest stays in the device for the next call
+        if (read(link->fd, &byte, 1) != 1)
+        {
+            return -1;
+        }
+
+        if (byte != COBS_DELIMITER)
+        {
+            if (link->rxLength < HOST_LINK_MAX_LINE)
+            {
+                link->rx[link->rxLength++] = byte;
+            }
+            else
+            {
+                link->rxOverflow = 1;
+            }
+            continue;
+        }
+
+        // Delimiters in a row are allowed
+        if (link->rxLength == 0 && !link->rxOverflow)
+        {
+            continue;
+        }
+
+        result = link->rxOverflow ? -1 : hostLinkDecode(link->rx, link->rxLength, frame);
+        link->rxLength = 0;
+        link->rxOverflow = 0;
+        if (result == 0)
+        {
+            link->framesReceived++;
+            return 1;
+        }
+        link->framesRejected++;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Encodes a frame for the line.
+ *
+ * @param type The PROTOCOL_MESSAGE.
+ * @param sequence The sequence number.
+ * @param payload The payload, may be 0 if the length is 0.
+ * @param length Bytes of the payload, at most PROTOCOL_MAX_PAYLOAD.
+ * @param line HOST_LINK_MAX_LINE bytes for the frame including the delimiter.
+ *
+ * @return The bytes of the frame, or 0 if the payload is too long.
+ */
+uint8_t hostLinkEncode(uint8_t type, uint8_t sequence, const void *payload, uint8_t length, uint8_t *line)
+{
+    uint8_t frame[FRAME_MAX];
+    uint8_t frameLength = FRAME_HEADER + length + FRAME_CRC;
+    uint8_t codeIndex = 0;
+    uint8_t lineLength = 1;
+    uint16_t crc;
+    uint8_t i;
+
+    if (length > PROTOCOL_MAX_PAYLOAD)
+    {
+        return 0;
+    }
+
+    frame[0] = type;
+    frame[1] = sequence;
+    if (length)
+    {
+        memcpy(&frame[FRAME_HEADER], payload, length);
+    }
+    crc = hostLinkCrc16(frame, FRAME_HEADER + length);
+    frame[FRAME_HEADER + length] = (uint8_t)crc;
+    frame[FRAME_HEADER + length + 1] = (uint8_t)(crc >> 8);
+
+    // The code byte of a block is filled in when its zero or the end is reached
+    for (i = 0; i < frameLength; i++)
+    {
+        if (frame[i] == 0)
+        {
+            line[codeIndex] = lineLength - codeIndex;
+            codeIndex = lineLength++;
+        }
+        else
+        {
+            line[lineLength++] = frame[i];
+        }
+    }
+    line[codeIndex] = lineLength - codeIndex;
+    line[lineLength++] = COBS_DELIMITER;
+
+    return lineLength;
+}
+
+/**
+ * @brief Decodes a frame.
+ *
+ * @param line The bytes of the frame without the delimiter.
+ * @param length Bytes of the line.
+ * @param frame Pointer to the frame to fill.
+ *
+ * @return Returns 0 if the frame is valid, -1 otherwise.
+ */
+int hostLinkDecode(const uint8_t *line, uint8_t length, ProtocolFrame *frame)
+{
+    uint8_t data[HOST_LINK_MAX_LINE];
+    uint8_t dataLength = 0;
+    uint8_t i = 0;
+    uint8_t code;
+    uint16_t crc;
+
+    while (i < length)
+    {
+        code = line[i++];
+        if (code == COBS_DELIMITER || i + code - 1 > length)
+        {
+            return -1;
+        }
+        memcpy(&data[dataLength], &line[i], code - 1);
+        dataLength += code - 1;
+        i += code - 1;
+
+        // Every block but the last one stands for a zero
+        if (i < length && code != COBS_MAX_BLOCK)
+        {
+            data[dataLength++] = 0;
+        }
+    }
+
+    if (dataLength < FRAME_HEADER + FRAME_CRC || dataLength > FRAME_MAX)
+    {
+        return -1;
+    }
+
+    crc = hostLinkCrc16(data, dataLength - FRAME_CRC);
+    if (data[dataLength - 2] != (uint8_t)crc || data[dataLength - 1] != (uint8_t)(crc >> 8))
+    {
+        return -1;
+    }
+
+    frame->type = data[0];
+    frame->sequence = data[1];
+    frame->length = dataLength - FRAME_HEADER - FRAME_CRC;
+    memcpy(frame->payload, &data[FRAME_HEADER], frame->length);
+
+    return 0;
+}
+
+/**
+ * @brief Computes the CRC-16/CCITT-FALSE of a block, one bit at a time.
+ *
+ * @param data The data.
+ * @param length Bytes of the data.
+ *
+ * @return The CRC.
+ */
+uint16_t hostLinkCrc16(const uint8_t *data, uint8_t length)
+{
+    uint16_t crc = 0xFFFF;
+    uint8_t bit;
+
+    while (length--)
+    {
+        crc ^= (uint16_t)*data++ << 8;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Returns the milliseconds since a point in time.
+ */
+static long elapsedMs(const struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec) * 1000L + (now.tv_nsec - start->tv_nsec) / 1000000L;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file    HostLink.h
+ * @brief   Header file for the Linux side of the Lab 6 frame protocol.
+ *
+ * This file contains declarations for talking to the Lab 6 board in binary mode over a
+ * serial device, e.g. /dev/ttyACM0 of the LaunchPad or a pseudo terminal in the checks.
+ * The frames are those of Protocol.h. The coding is a separate implementation from
+ * Protocol.c (bitwise CRC, COBS of a whole line), so the checks test one against the
+ * other.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef HOST_LINK_H
+#define HOST_LINK_H
+
+#include <stdint.h>
+
+#include "Protocol.h"
+
+#define HOST_LINK_MAX_LINE (PROTOCOL_MAX_PAYLOAD + PROTOCOL_OVERHEAD) /**< Bytes of a frame on the line */
+
+/**
+ * @brief An open link.
+ */
+typedef struct {
+    int fd;                                 /**< The serial device */
+    uint8_t txSequence;                     /**< Sequence number of the next frame */
+    uint8_t rx[HOST_LINK_MAX_LINE];         /**< Bytes of the frame being received */
+    uint8_t rxLength;                       /**< Bytes in rx */
+    uint8_t rxOverflow;                     /**< 1 if the frame is longer than a frame can be */
+    unsigned long framesReceived;           /**< Frames with a valid CRC */
+    unsigned long framesRejected;           /**< Frames with a wrong CRC, length or COBS coding */
+} HostLink;
+
+/**
+ * @brief Opens a serial device at 9600 baud, 8N1, without any processing of the bytes.
+ *
+ * @param link The link to set up.
+ * @param path Path of the device.
+ *
+ * @return Returns 0 on success, or -1 with errno set.
+ */
+int hostLinkOpen(HostLink *link, const char *path);
+
+/**
+ * @brief Closes the device.
+ *
+ * @param link The link.
+ */
+void hostLinkClose(HostLink *link);
+
+/**
+ * @brief Sends a message.
+ *
+ * @param link The link.
+ * @param type The PROTOCOL_MESSAGE.
+ * @param payload The payload, may be 0 if the length is 0.
+ * @param length Bytes of the payload, at most PROTOCOL_MAX_PAYLOAD.
+ *
+ * @return Returns 0 on success, or -1 if the payload is too long or the write failed.
+ */
+int hostLinkSend(HostLink *link, uint8_t type, const void *payload, uint8_t length);
+
+/**
+ * @brief Waits for the next valid frame.
+ *
+ * @param link The link.
+ * @param frame Pointer to the frame to fill.
+ * @param timeoutMs Longest time to wait in ms.
+ *
+ * @return Returns 1 if a frame has been received, 0 on a timeout or -1 if the read
+ *         failed. Invalid frames are counted in framesRejected and skipped.
+ */
+int hostLinkReceive(HostLink *link, ProtocolFrame *frame, int timeoutMs);
+
+/**
+ * @brief Encodes a frame for the line.
+ *
+ * @param type The PROTOCOL_MESSAGE.
+ * @param sequence The sequence number.
+ * @param payload The payload, may be 0 if the length is 0.
+ * @param length Bytes of the payload, at most PROTOCOL_MAX_PAYLOAD.
+ * @param line HOST_LINK_MAX_LINE bytes for the frame including the delimiter.
+ *
+ * @return The bytes of the frame, or 0 if the payload is too long.
+ */
+uint8_t hostLinkEncode(uint8_t type, uint8_t sequence, const void *payload, uint8_t length, uint8_t *line);
+
+/**
+ * @brief Decodes a frame.
+ *
+ * @param line The bytes of the frame without the delimiter.
+ * @param length Bytes of the line.
+ * @param frame Pointer to the frame to fill.
+ *
+ * @return Returns 0 if the frame is valid, -1 otherwise.
+ */
+int hostLinkDecode(const uint8_t *line, uint8_t length, ProtocolFrame *frame);
+
+/**
+ * @brief Computes the CRC-16/CCITT-FALSE of a block, one bit at a time.
+ *
+ * @param data The data.
+ * @param length Bytes of the data.
+ *
+ * @return The CRC.
+ */
+uint16_t hostLinkCrc16(const uint8_t *data, uint8_t length);
+
+#endif /* HOST_LINK_H */
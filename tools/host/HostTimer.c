@@ -0,0 +1,176 @@
+/**
+ * @file    HostTimer.c
+ * @brief   Host model of Timer1_A.
+ *
+ * This file contains the clock-by-clock model of Timer1_A and the definitions of the
+ * register variables declared by the host msp430.h. A compare event happens when the
+ * counter counts to TA1CCRx; it sets CCIFG and drives the output unit. In OUTMOD_0 the
+ * output follows the OUT bit at once, including values that are overwritten by the
+ * next write.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdint.h>
+
+#define HOST_MSP430_REGISTERS
+#include "msp430.h"
+#include "HostTimer.h"
+
+#define OUTMOD_MASK OUTMOD_7
+
+static volatile uint16_t control[HOST_TIMER_CHANNELS]; /**< TA1CCTL0 to TA1CCTL2 */
+static uint8_t output[HOST_TIMER_CHANNELS];            /**< Levels of the output units */
+
+static void applyOutMode0(uint8_t channel);
+static void compare(uint8_t channel);
+
+/**
+ * @brief Returns the control register of a channel.
+ *
+ * @param channel The channel, 0 to HOST_TIMER_CHANNELS - 1.
+ * @return Pointer to the register.
+ */
+volatile uint16_t *hostTimerControl(uint8_t channel)
+{
+    applyOutMode0(channel);
+    return &control[channel];
+}
+
+/**
+ * @brief Resets the timer, its channels and outputs.
+ */
+void hostTimerReset(void)
+{
+    uint8_t i;
+
+    TA1CTL = 0;
+    TA1R = 0;
+    TA1CCR0 = 0;
+    TA1CCR1 = 0;
+    TA1CCR2 = 0;
+    for (i = 0; i < HOST_TIMER_CHANNELS; i++)
+    {
+        control[i] = 0;
+        output[i] = 0;
+    }
+}
+
+/**
+ * @brief Advances the timer by one timer clock.
+ */
+void hostTimerStep(void)
+{
+    const volatile uint16_t *ccr[HOST_TIMER_CHANNELS] = {&TA1CCR0, &TA1CCR1, &TA1CCR2};
+    uint8_t i;
+
+    if (TA1CTL & TACLR)
+    {
+        TA1R = 0;
+        TA1CTL &= ~TACLR;
+    }
+
+    switch (TA1CTL & MC_3)
+    {
+    case MC_1:
+        TA1R = (TA1R >= TA1CCR0) ? 0 : TA1R + 1;
+        break;
+    case MC_2:
+        TA1R++;
+        break;
+    default:
+        for (i = 0; i < HOST_TIMER_CHANNELS; i++)
+        {
+            applyOutMode0(i);
+        }
+        return;
+    }
+
+    for (i = 0; i < HOST_TIMER_CHANNELS; i++)
+    {
+        applyOutMode0(i);
+        if (TA1R == *ccr[i])
+        {
+            compare(i);
+        }
+    }
+}
+
+/**
+ * @brief Returns the level of a channel output.
+ *
+ * @param channel The channel, 0 to HOST_TIMER_CHANNELS - 1.
+ * @return 1 if the output is high, 0 otherwise.
+ */
+uint8_t hostTimerOutput(uint8_t channel)
+{
+    applyOutMode0(channel);
+    return output[channel];
+}
+
+/**
+ * @brief Takes the highest pending CCR1/CCR2 interrupt, as reading TA1IV does.
+ *
+ * @return TA1IV_TACCR1, TA1IV_TACCR2 or TA1IV_NONE.
+ */
+uint16_t hostTimerTakeVector(void)
+{
+    if ((control[1] & (CCIE | CCIFG)) == (CCIE | CCIFG))
+    {
+        control[1] &= ~CCIFG;
+        return TA1IV_TACCR1;
+    }
+    if ((control[2] & (CCIE | CCIFG)) == (CCIE | CCIFG))
+    {
+        control[2] &= ~CCIFG;
+        return TA1IV_TACCR2;
+    }
+    return TA1IV_NONE;
+}
+
+/**
+ * @brief Drives the output from the OUT bit while the channel is in OUTMOD_0.
+ */
+static void applyOutMode0(uint8_t channel)
+{
+    if ((control[channel] & OUTMOD_MASK) == OUTMOD_0)
+    {
+        output[channel] = (control[channel] & OUT) ? 1 : 0;
+    }
+}
+
+/**
+ * @brief Handles the counter reaching TA1CCRx of a channel.
+ */
+static void compare(uint8_t channel)
+{
+    uint8_t i;
+
+    control[channel] |= CCIFG;
+
+    switch (control[channel] & OUTMOD_MASK)
+    {
+    case OUTMOD_4:
+        output[channel] ^= 1;
+        break;
+    case OUTMOD_7:
+        output[channel] = 0;
+        break;
+    default:
+        break;
+    }
+
+    // Reset/set outputs of the other channels are set when the counter reaches TA1CCR0
+    if (channel == 0)
+    {
+        for (i = 1; i < HOST_TIMER_CHANNELS; i++)
+        {
+            if ((control[i] & OUTMOD_MASK) == OUTMOD_7)
+            {
+                output[i] = 1;
+            }
+        }
+    }
+}
@@ -0,0 +1,50 @@
+/**
+ * @file    HostTimer.h
+ * @brief   Header file for the host model of Timer1_A.
+ *
+ * This file contains declarations of a clock-by-clock model of Timer1_A with its three
+ * capture/compare channels in compare mode: the stop, up and continuous modes, TACLR,
+ * the output units in the modes the tone modules use (OUTMOD_0, OUTMOD_4 and OUTMOD_7)
+ * and the CCIFG flags. The model does not run interrupts; the caller takes the pending
+ * vector and calls the service routine of the module under test.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef HOST_TIMER_H
+#define HOST_TIMER_H
+
+#include <stdint.h>
+
+#define HOST_TIMER_CHANNELS 3 /**< Capture/compare channels of Timer1_A3 */
+
+/**
+ * @brief Resets the timer, its channels and outputs.
+ */
+void hostTimerReset(void);
+
+/**
+ * @brief Advances the timer by one timer clock.
+ *
+ * The input divider is not modelled, one call is one clock after the divider.
+ */
+void hostTimerStep(void);
+
+/**
+ * @brief Returns the level of a channel output.
+ *
+ * @param channel The channel, 0 to HOST_TIMER_CHANNELS - 1.
+ * @return 1 if the output is high, 0 otherwise.
+ */
+uint8_t hostTimerOutput(uint8_t channel);
+
+/**
+ * @brief Takes the highest pending CCR1/CCR2 interrupt, as reading TA1IV does.
+ *
+ * @return TA1IV_TACCR1, TA1IV_TACCR2 or TA1IV_NONE; the flag of the returned vector is cleared.
+ */
+uint16_t hostTimerTakeVector(void);
+
+#endif /* HOST_TIMER_H */
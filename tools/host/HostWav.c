@@ -0,0 +1,93 @@
+/**
+ * @file    HostWav.c
+ * @brief   WAV writer of the host checks.
+ *
+ * This file contains the implementation of the WAV writer. The header is written with
+ * zero lengths first and completed by hostWavClose(), so the samples can be streamed.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "HostWav.h"
+
+#define HEADER_SIZE 44
+#define RIFF_SIZE_OFFSET 4
+#define DATA_SIZE_OFFSET 40
+
+static void writeLittleEndian(FILE *file, uint32_t value, uint8_t bytes);
+
+/**
+ * @brief Opens a WAV file and writes a header for an empty file.
+ *
+ * @param path Path of the file.
+ * @param sampleRate Samples per second.
+ * @return The file, or 0 if it could not be created.
+ */
+FILE *hostWavOpen(const char *path, uint32_t sampleRate)
+{
+    FILE *file = fopen(path, "wb");
+
+    if (!file)
+    {
+        return 0;
+    }
+
+    fwrite("RIFF", 1, 4, file);
+    writeLittleEndian(file, HEADER_SIZE - 8, 4);
+    fwrite("WAVEfmt ", 1, 8, file);
+    writeLittleEndian(file, 16, 4);             // Size of the format chunk
+    writeLittleEndian(file, 1, 2);              // PCM
+    writeLittleEndian(file, 1, 2);              // Mono
+    writeLittleEndian(file, sampleRate, 4);
+    writeLittleEndian(file, sampleRate * 2, 4); // Bytes per second
+    writeLittleEndian(file, 2, 2);              // Bytes per sample
+    writeLittleEndian(file, 16, 2);             // Bits per sample
+    fwrite("data", 1, 4, file);
+    writeLittleEndian(file, 0, 4);
+
+    return file;
+}
+
+/**
+ * @brief Appends a sample.
+ *
+ * @param file The file from hostWavOpen().
+ * @param sample The sample.
+ */
+void hostWavWrite(FILE *file, int16_t sample)
+{
+    writeLittleEndian(file, (uint16_t)sample, 2);
+}
+
+/**
+ * @brief Completes the header with the length of the data and closes the file.
+ *
+ * @param file The file from hostWavOpen().
+ */
+void hostWavClose(FILE *file)
+{
+    uint32_t size = (uint32_t)ftell(file);
+
+    fseek(file, RIFF_SIZE_OFFSET, SEEK_SET);
+    writeLittleEndian(file, size - 8, 4);
+    fseek(file, DATA_SIZE_OFFSET, SEEK_SET);
+    writeLittleEndian(file, size - HEADER_SIZE, 4);
+    fclose(file);
+}
+
+/**
+ * @brief Writes a value with the least significant byte first.
+ */
+static void writeLittleEndian(FILE *file, uint32_t value, uint8_t bytes)
+{
+    while (bytes--)
+    {
+        fputc(value & 0xFF, file);
+        value >>= 8;
+    }
+}
@@ -0,0 +1,43 @@
+/**
+ * @file    HostWav.h
+ * @brief   Header file for the WAV writer of the host checks.
+ *
+ * This file contains declarations for writing a mono 16-bit PCM WAV file, so the output
+ * pins of the tone modules can be listened to and inspected in an audio editor.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef HOST_WAV_H
+#define HOST_WAV_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * @brief Opens a WAV file and writes a header for an empty file.
+ *
+ * @param path Path of the file.
+ * @param sampleRate Samples per second.
+ * @return The file, or 0 if it could not be created.
+ */
+FILE *hostWavOpen(const char *path, uint32_t sampleRate);
+
+/**
+ * @brief Appends a sample.
+ *
+ * @param file The file from hostWavOpen().
+ * @param sample The sample.
+ */
+void hostWavWrite(FILE *file, int16_t sample);
+
+/**
+ * @brief Completes the header with the length of the data and closes the file.
+ *
+ * @param file The file from hostWavOpen().
+ */
+void hostWavClose(FILE *file);
+
+#endif /* HOST_WAV_H */
@@ -0,0 +1,164 @@
+/**
+ * @file    msp430.h
+ * @brief   Host replacement of the MSP430G2553 header for the host checks.
+ *
+ * This file declares the registers and bits the Lab 5 tone modules, the Lab 6 frame
+ * protocol and the power module use as plain variables, so Voices.c, Dds.c, Protocol.c
+ * and Power.c compile on the host unchanged. Timer1_A is modelled by HostTimer.c, which also defines the variables; a
+ * check without the timer model defines HOST_MSP430_REGISTERS itself. The interrupt
+ * intrinsics only keep GIE in a status register variable; the models call the service
+ * routines themselves. Entering a low-power mode calls hostEnterLowPower(), which the
+ * check that uses it defines.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef HOST_MSP430_H
+#define HOST_MSP430_H
+
+#include <stdint.h>
+
+#ifdef HOST_MSP430_REGISTERS
+#define HOST_REGISTER(type, name) volatile type name
+#else
+#define HOST_REGISTER(type, name) extern volatile type name
+#endif
+
+// Port 2
+HOST_REGISTER(uint8_t, P2DIR);
+HOST_REGISTER(uint8_t, P2OUT);
+HOST_REGISTER(uint8_t, P2SEL);
+HOST_REGISTER(uint8_t, P2SEL2);
+
+// Basic clock system
+HOST_REGISTER(uint8_t, BCSCTL3);
+
+// Timer0_A3
+HOST_REGISTER(uint16_t, TA0CTL);
+HOST_REGISTER(uint16_t, TA0CCTL0);
+HOST_REGISTER(uint16_t, TA0CCR0);
+
+// Timer1_A3
+HOST_REGISTER(uint16_t, TA1CTL);
+HOST_REGISTER(uint16_t, TA1R);
+HOST_REGISTER(uint16_t, TA1CCR0);
+HOST_REGISTER(uint16_t, TA1CCR1);
+HOST_REGISTER(uint16_t, TA1CCR2);
+
+/**
+ * @brief Returns the control register of a channel.
+ *
+ * Every access goes through this function, so the model sees a value that is written
+ * and overwritten again at once, like OUTMOD_0 to force the output low.
+ */
+volatile uint16_t *hostTimerControl(uint8_t channel);
+
+#define TA1CCTL0 (*hostTimerControl(0))
+#define TA1CCTL1 (*hostTimerControl(1))
+#define TA1CCTL2 (*hostTimerControl(2))
+
+// USCI_A0 transmit
+HOST_REGISTER(uint8_t, IE2);
+HOST_REGISTER(uint8_t, UCA0TXBUF);
+
+// Status register with the global interrupt enable
+HOST_REGISTER(uint16_t, hostStatusRegister);
+
+#define BIT0 0x0001
+#define BIT1 0x0002
+#define BIT2 0x0004
+#define BIT3 0x0008
+#define BIT4 0x0010
+#define BIT5 0x0020
+#define BIT6 0x0040
+#define BIT7 0x0080
+
+#define GIE 0x0008
+#define CPUOFF 0x0010
+#define OSCOFF 0x0020
+#define SCG0 0x0040
+#define SCG1 0x0080
+
+#define LPM0_bits (CPUOFF)
+#define LPM3_bits (SCG1 + SCG0 + CPUOFF)
+#define LPM4_bits (SCG1 + SCG0 + OSCOFF + CPUOFF)
+
+// BCSCTL3
+#define LFXT1S_2 0x20
+#define LFXT1S_3 0x30
+
+// TAxCTL
+#define TASSEL_1 0x0100
+#define TASSEL_2 0x0200
+#define ID_0 0x0000
+#define ID_1 0x0040
+#define ID_2 0x0080
+#define ID_3 0x00C0
+#define MC_0 0x0000
+#define MC_1 0x0010
+#define MC_2 0x0020
+#define MC_3 0x0030
+#define TACLR 0x0004
+#define TAIE 0x0002
+#define TAIFG 0x0001
+
+// TAxCCTLx
+#define CM_1 0x4000
+#define CCIS_1 0x1000
+#define CAP 0x0100
+#define OUTMOD_0 0x0000
+#define OUTMOD_1 0x0020
+#define OUTMOD_2 0x0040
+#define OUTMOD_3 0x0060
+#define OUTMOD_4 0x0080
+#define OUTMOD_5 0x00A0
+#define OUTMOD_6 0x00C0
+#define OUTMOD_7 0x00E0
+#define CCIE 0x0010
+#define OUT 0x0004
+#define CCIFG 0x0001
+
+// IE2
+#define UCA0TXIE 0x02
+
+// TA1IV
+#define TA1IV_NONE 0x0000
+#define TA1IV_TACCR1 0x0002
+#define TA1IV_TACCR2 0x0004
+#define TA1IV_TAIFG 0x000A
+
+// Service routines are plain functions, the vector pragmas are ignored
+#define __interrupt
+
+/**
+ * @brief Records a low-power mode the program enters.
+ *
+ * @param bits The status register bits, e.g. LPM3_bits + GIE.
+ */
+void hostEnterLowPower(uint16_t bits);
+
+#define __bis_SR_register(bits) hostEnterLowPower(bits)
+
+static inline uint16_t __get_interrupt_state(void)
+{
+    return hostStatusRegister & GIE;
+}
+
+static inline void __set_interrupt_state(uint16_t state)
+{
+    hostStatusRegister = (hostStatusRegister & ~GIE) | (state & GIE);
+}
+
+static inline void __disable_interrupt(void)
+{
+    hostStatusRegister &= ~GIE;
+}
+
+static inline void __enable_interrupt(void)
+{
+    hostStatusRegister |= GIE;
+}
+
+#endif /* HOST_MSP430_H */
@@ -0,0 +1,15 @@
+/**
+ * @file    msp430g2553.h
+ * @brief   Host replacement of the device header included by some lab modules.
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#ifndef HOST_MSP430G2553_H
+#define HOST_MSP430G2553_H
+
+#include "msp430.h"
+
+#endif /* HOST_MSP430G2553_H */
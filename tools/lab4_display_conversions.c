@@ -0,0 +1,144 @@
+/**
+ * @file    lab4_display_conversions.c
+ * @brief   Host check of the Lab 4 display conversions against the original code.
+ *
+ * This program compares convertToGage(), convertToCapColour() and convertToPercentage()
+ * of Lab 4 with the if/else and double versions they replaced, for every ADC value
+ * 0..1023. Gauge and colour have to match everywhere. The percentage has to be exactly
+ * value / 10; the values where the old double code truncated differently are listed.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -Wall -I"Embedded Lab 4" -o lab4_display_conversions tools/lab4_display_conversions.c "Embedded Lab 4/StringDisplay.c" "Embedded Lab 4/MessageBuilder.c" && ./lab4_display_conversions
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define ADC_MAX 1023
+
+#define ZERO 0
+#define ONE_HUNDRED 100
+#define TWO_HUNDRED 200
+#define FOUR_HUNDRED 400
+#define SIX_HUNDRED 600
+#define EIGHT_HUNDRED 800
+#define ONE_THOUSAND 1000
+
+// The functions under test, from StringDisplay.c
+const char *convertToGage(uint16_t value);
+const char *convertToCapColour(uint16_t value);
+uint16_t convertToPercentage(uint16_t value);
+
+// Needed to link StringDisplay.c, no output is checked here
+void serialWrite(char tx) { (void)tx; }
+void serialPrint(char *tx) { (void)tx; }
+void serialPrintln(char *tx) { (void)tx; }
+uint16_t getTickCount(void) { return 0; }
+
+/**
+ * @brief The original gauge conversion.
+ */
+static void oldConvertToGage(uint16_t value, char *gageStr)
+{
+    if (value > EIGHT_HUNDRED && value <= ONE_THOUSAND)
+    {
+        strcpy(gageStr, " 1111");
+    }
+    else if (value > SIX_HUNDRED && value <= EIGHT_HUNDRED)
+    {
+        strcpy(gageStr, " 1110");
+    }
+    else if (value > FOUR_HUNDRED && value <= SIX_HUNDRED)
+    {
+        strcpy(gageStr, " 1100");
+    }
+    else if (value > TWO_HUNDRED && value <= FOUR_HUNDRED)
+    {
+        strcpy(gageStr, " 1000");
+    }
+    else if (value <= TWO_HUNDRED)
+    {
+        strcpy(gageStr, " 0000");
+    }
+    else
+    {
+        strcpy(gageStr, "");
+    }
+}
+
+/**
+ * @brief The original cap colour conversion.
+ */
+static void oldConvertToCapColour(uint16_t value, char *colourStr)
+{
+    if (value > TWO_HUNDRED && value <= ONE_THOUSAND)
+    {
+        strcpy(colourStr, "None");
+    }
+    else if (value > ONE_HUNDRED && value <= TWO_HUNDRED)
+    {
+        strcpy(colourStr, "White");
+    }
+    else if (value <= ONE_HUNDRED)
+    {
+        strcpy(colourStr, "Black");
+    }
+    else
+    {
+        strcpy(colourStr, "ERROR");
+    }
+}
+
+/**
+ * @brief The original percentage conversion in double arithmetic.
+ */
+static uint16_t oldConvertToPercentage(uint16_t value)
+{
+    return (uint16_t)(((double)value / (double)ONE_THOUSAND) * (double)ONE_HUNDRED);
+}
+
+int main(void)
+{
+    char old[8];
+    uint16_t value;
+    unsigned int failures = 0;
+    unsigned int percentDifferences = 0;
+
+    for (value = 0; value <= ADC_MAX; value++)
+    {
+        oldConvertToGage(value, old);
+        if (strcmp(old, convertToGage(value)) != 0)
+        {
+            printf("gauge %u: old \"%s\", new \"%s\"\n", value, old, convertToGage(value));
+            failures++;
+        }
+
+        oldConvertToCapColour(value, old);
+        if (strcmp(old, convertToCapColour(value)) != 0)
+        {
+            printf("colour %u: old \"%s\", new \"%s\"\n", value, old, convertToCapColour(value));
+            failures++;
+        }
+
+        if (convertToPercentage(value) != value / 10)
+        {
+            printf("percent %u: new %u, exact %u\n", value, convertToPercentage(value), value / 10);
+            failures++;
+        }
+        else if (oldConvertToPercentage(value) != convertToPercentage(value))
+        {
+            printf("percent %u: old %u, new %u (exact)\n", value, oldConvertToPercentage(value),
+                   convertToPercentage(value));
+            percentDifferences++;
+        }
+    }
+
+    printf("%u failures, %u percentages where the old code truncated\n", failures, percentDifferences);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,254 @@
+/**
+ * @file    lab5_dds.c
+ * @brief   Host simulation, cycle budget and WAV render of the Lab 5 synthesizer.
+ *
+ * This program runs Dds.c on the Timer1_A model of tools/host, one CPU cycle per step.
+ * The CPU model runs one interrupt at a time: the system tick every millisecond, which
+ * advances the envelope and takes TICK_ISR_CYCLES (STRESS_ISR_CYCLES on every
+ * STRESS_EVERY_MS-th tick, as a sequencer step or an I2C transfer would), and the sample
+ * interrupt, which writes the compare value DDS_ISR_WRITE_CYCLES after its entry and
+ * takes DDS_ISR_CYCLES (Dds.h). An A4 sine with the default envelope is held for
+ * NOTE_MS and then released.
+ *
+ * Checks:
+ * - no carrier period stays high, i.e. no compare value is missed;
+ * - the pitch of the output is that of the note within MAX_PITCH_ERROR_PERCENT;
+ * - the first sample starts at the middle (no click), the attack rises, the sustain is
+ *   at the sustain level of the envelope and the note ends within the release time.
+ * It prints the budget per sample, the CPU share of the sample interrupt, the slack of
+ * the compare writes and the number of late writes the interrupt has corrected. The
+ * duty cycle of every carrier period is written to lab5_dds.wav at DDS_SAMPLE_RATE_HZ.
+ * The sample rate depends on the clock, so the program is built once per
+ * SMCLK_FREQUENCY_HZ; below DDS_MIN_SMCLK_HZ it only reports.
+ *
+ * Build and run from the repository root:
+ *   for f in 1000000 8000000 16000000; do gcc -std=gnu99 -Wall -DSMCLK_FREQUENCY_HZ=${f}UL -Itools/host -I"Embedded Lab 5/userCode/inc" -o lab5_dds tools/lab5_dds.c tools/host/HostTimer.c tools/host/HostWav.c "Embedded Lab 5/userCode/src/Dds.c" "Embedded Lab 5/userCode/src/Notes.c" && ./lab5_dds || break; done
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <msp430.h>
+#include "HostTimer.h"
+#include "HostWav.h"
+
+#include "SoftwarePwm.h"
+#include "SysTick.h"
+#include "Notes.h"
+#include "Dds.h"
+
+#define NOTE NOTE_A4
+#define NOTE_MS 400
+#define MAX_MS 800
+#define ATTACK_MS 10    // Envelope set by initDds()
+#define DECAY_MS 100
+#define SUSTAIN_PERCENT 70
+#define RELEASE_MS 150
+#define TICK_ISR_CYCLES 40
+#define STRESS_ISR_CYCLES 200
+#define STRESS_EVERY_MS 7
+#define MAX_PITCH_ERROR_PERCENT 0.5
+#define MAX_SAMPLES ((uint32_t)DDS_SAMPLE_RATE_HZ * MAX_MS / 1000)
+#define MIDDLE (DDS_CARRIER_PERIOD / 2)
+
+// Interrupts of the CPU model
+typedef enum
+{
+    ISR_NONE,
+    ISR_TICK,
+    ISR_SAMPLE
+} ISR;
+
+static SysTickHandler tickHandler = 0;
+
+// High clocks of every carrier period
+static int16_t duty[MAX_SAMPLES];
+static uint32_t sampleCount = 0;
+
+// Functions of SysTick.c used by Dds.c
+void initSysTick()
+{
+}
+
+int16_t sysTickRegister(SysTickHandler handler)
+{
+    tickHandler = handler;
+    return 0;
+}
+
+/**
+ * @brief Returns the largest deviation from the middle in a range of samples.
+ */
+static int16_t amplitude(uint32_t fromMs, uint32_t toMs)
+{
+    uint32_t i;
+    int16_t largest = 0;
+
+    for (i = fromMs * DDS_SAMPLE_RATE_HZ / 1000; i < toMs * DDS_SAMPLE_RATE_HZ / 1000 && i < sampleCount; i++)
+    {
+        int16_t deviation = abs(duty[i] - MIDDLE);
+
+        largest = deviation > largest ? deviation : largest;
+    }
+
+    return largest;
+}
+
+int main(void)
+{
+    FILE *wav = hostWavOpen("lab5_dds.wav", DDS_SAMPLE_RATE_HZ);
+    ISR running = ISR_NONE;
+    uint32_t busy = 0;         // Cycles left of the running interrupt
+    uint32_t writeIn = 0;      // Cycles until the sample interrupt writes the compare value
+    uint8_t tickPending = 0;
+    uint8_t started = 0;
+    uint32_t clocksPerMs = SMCLK_FREQUENCY_HZ / 1000UL;
+    uint32_t cycle;
+    uint32_t sampleCycles = 0;
+    uint32_t highClocks = 0;
+    uint32_t endMs = 0;
+    int32_t minimumSlack = DDS_CARRIER_PERIOD;
+    unsigned int lateWrites = 0;
+    unsigned int fullHighPeriods = 0;
+    unsigned int crossings = 0;
+    unsigned int failures = 0;
+    double expectedHz = (double)PWM_CLOCK_HZ / getNotePeriod(NOTE);
+    double measuredHz;
+    uint32_t i;
+
+    hostTimerReset();
+    __enable_interrupt();
+    initDds();
+    ddsNoteOn(NOTE);
+
+    for (cycle = 1; cycle <= MAX_MS * clocksPerMs && ddsIsPlaying(); cycle++)
+    {
+        hostTimerStep();
+
+        // Reset/set sets the output when the counter reaches TA1CCR0, which starts a carrier
+        // period; the part before the first one is not a sample
+        if (TA1R == TA1CCR0 && !started)
+        {
+            started = 1;
+        }
+        else if (TA1R == TA1CCR0)
+        {
+            if (sampleCount < MAX_SAMPLES)
+            {
+                duty[sampleCount++] = highClocks;
+            }
+            fullHighPeriods += highClocks == DDS_CARRIER_PERIOD;
+            if (wav)
+            {
+                hostWavWrite(wav, (int16_t)(((int16_t)highClocks - MIDDLE) << 8));
+            }
+            highClocks = 0;
+        }
+        highClocks += hostTimerOutput(1);
+
+        if (cycle % clocksPerMs == 0)
+        {
+            tickPending = 1;
+            if (cycle / clocksPerMs == NOTE_MS)
+            {
+                ddsNoteOff();
+            }
+        }
+
+        // The running interrupt
+        if (running == ISR_SAMPLE)
+        {
+            sampleCycles++;
+            if (writeIn && --writeIn == 0)
+            {
+                uint16_t previous = TA1CCR1;
+                uint16_t counter = TA1R;
+                int32_t slack;
+
+                ddsInterrupt();
+
+                // Cycles left until the counter reaches the new value in the next period
+                if (counter >= previous)
+                {
+                    slack = (int32_t)DDS_CARRIER_PERIOD - counter + TA1CCR1;
+                }
+                else
+                {
+                    slack = (int32_t)TA1CCR1 - counter;
+                }
+                minimumSlack = slack < minimumSlack ? slack : minimumSlack;
+                lateWrites += slack <= 0;
+            }
+        }
+        if (busy && --busy == 0)
+        {
+            running = ISR_NONE;
+        }
+
+        // Start the next interrupt, the tick has the higher priority
+        if (running == ISR_NONE)
+        {
+            if (tickPending)
+            {
+                tickPending = 0;
+                running = ISR_TICK;
+                busy = (cycle / clocksPerMs) % STRESS_EVERY_MS ? TICK_ISR_CYCLES : STRESS_ISR_CYCLES;
+                if (tickHandler)
+                {
+                    tickHandler();
+                }
+            }
+            else if (hostTimerTakeVector() == TA1IV_TACCR1)
+            {
+                running = ISR_SAMPLE;
+                busy = DDS_ISR_CYCLES;
+                writeIn = DDS_ISR_WRITE_CYCLES;
+            }
+        }
+    }
+    endMs = cycle / clocksPerMs;
+
+    if (wav)
+    {
+        hostWavClose(wav);
+    }
+
+    // Pitch from the zero crossings of the sustain
+    for (i = (ATTACK_MS + DECAY_MS) * DDS_SAMPLE_RATE_HZ / 1000 + 1; i < NOTE_MS * DDS_SAMPLE_RATE_HZ / 1000; i++)
+    {
+        crossings += (duty[i - 1] < MIDDLE) != (duty[i] < MIDDLE);
+    }
+    measuredHz = crossings / 2.0 / ((NOTE_MS - ATTACK_MS - DECAY_MS) / 1000.0);
+
+    printf("SMCLK %lu Hz: %lu samples/s, %u cycles per sample, sample interrupt %u cycles = %.0f %% of the CPU\n",
+           (unsigned long)SMCLK_FREQUENCY_HZ, (unsigned long)DDS_SAMPLE_RATE_HZ, DDS_CARRIER_PERIOD,
+           DDS_ISR_CYCLES, 100.0 * sampleCycles / (endMs * clocksPerMs));
+    printf("  compare writes: minimum slack %ld cycles, %u late and corrected, %u periods stuck high\n",
+           (long)minimumSlack, lateWrites, fullHighPeriods);
+    printf("  A4: %.2f Hz expected, %.2f Hz measured; amplitude %d at 2 ms, %d at 10 ms, %d in the sustain; "
+           "first sample %d; silent after %lu ms\n",
+           expectedHz, measuredHz, amplitude(1, 2), amplitude(9, 10), amplitude(200, 300), duty[0] - MIDDLE,
+           (unsigned long)endMs);
+
+    if (SMCLK_FREQUENCY_HZ < DDS_MIN_SMCLK_HZ)
+    {
+        printf("  below DDS_MIN_SMCLK_HZ, not checked\n");
+        return 0;
+    }
+
+    failures += fullHighPeriods != 0;
+    failures += abs((int)(100.0 * (measuredHz - expectedHz) / expectedHz / MAX_PITCH_ERROR_PERCENT)) >= 1;
+    failures += abs(duty[0] - MIDDLE) > 2;
+    failures += amplitude(1, 2) >= amplitude(9, 10);
+    failures += abs(amplitude(200, 300) * 100 / amplitude(9, 11) - SUSTAIN_PERCENT) > 5;
+    failures += ddsIsPlaying() || endMs > NOTE_MS + RELEASE_MS + 2;
+
+    printf("%u failures\n", failures);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,208 @@
+/**
+ * @file    lab5_i2c_register.c
+ * @brief   Host check of the Lab 5 I2C register access layer against a fake slave.
+ *
+ * This program links I2cRegister.c with a model of the driver in TwoWire.c: i2cSubmit()
+ * queues up to I2C_QUEUE_LENGTH transactions and i2cWait() runs the queue in order
+ * against a fake slave with 256 registers and an auto-incrementing register pointer,
+ * like an EEPROM or a sensor. It checks single and block accesses, the length limit, a
+ * NACK from a missing device and a transaction list longer than the driver queue with
+ * a failing transaction in the middle. For every access it prints the SCL periods on
+ * the bus and the time at I2C_STANDARD_MODE_HZ.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -Wall -I"Embedded Lab 5/userCode/inc" -o lab5_i2c_register tools/lab5_i2c_register.c "Embedded Lab 5/userCode/src/I2cRegister.c" && ./lab5_i2c_register
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "TwoWire.h"
+#include "I2cRegister.h"
+
+#define SLAVE_ADDRESS 0x50  // Address of the fake slave
+#define MISSING_ADDRESS 0x51
+#define NUM_REGISTERS 256
+#define BITS_PER_BYTE 9     // Eight data bits and the acknowledge
+#define CONDITION_PERIODS 1 // Start, repeated start or stop
+#define LIST_LENGTH (I2C_QUEUE_LENGTH + 3)
+
+// Fake slave
+static uint8_t registers[NUM_REGISTERS];
+static uint8_t pointer = 0;
+
+// Driver queue model
+static I2cTransaction *queue[I2C_QUEUE_LENGTH];
+static uint8_t queueCount = 0;
+static unsigned int queueFullCount = 0;
+
+// Bus statistics
+static unsigned long sclPeriods = 0;
+static unsigned int transactionsRun = 0;
+
+/**
+ * @brief Runs one transaction on the fake slave, as the driver interrupts would.
+ */
+static void runOnBus(I2cTransaction *transaction)
+{
+    uint8_t i;
+
+    transactionsRun++;
+    sclPeriods += CONDITION_PERIODS + BITS_PER_BYTE;
+
+    if (transaction->address != SLAVE_ADDRESS)
+    {
+        sclPeriods += CONDITION_PERIODS;
+        transaction->status = I2C_ERROR_NACK;
+        return;
+    }
+
+    // The first byte written sets the register pointer, the others are stored
+    for (i = 0; i < transaction->txCount; i++)
+    {
+        if (i == 0)
+        {
+            pointer = transaction->txData[0];
+        }
+        else
+        {
+            registers[pointer++] = transaction->txData[i];
+        }
+    }
+    sclPeriods += transaction->txCount * BITS_PER_BYTE;
+
+    if (transaction->rxCount)
+    {
+        if (transaction->txCount)
+        {
+            sclPeriods += CONDITION_PERIODS + BITS_PER_BYTE; // Repeated start and address
+        }
+        for (i = 0; i < transaction->rxCount; i++)
+        {
+            transaction->rxData[i] = registers[pointer++];
+        }
+        sclPeriods += transaction->rxCount * BITS_PER_BYTE;
+    }
+
+    sclPeriods += CONDITION_PERIODS;
+    transaction->status = I2C_OK;
+    if (transaction->callback)
+    {
+        transaction->callback(transaction);
+    }
+}
+
+// Functions of TwoWire.c used by I2cRegister.c
+int16_t i2cSubmit(I2cTransaction *transaction)
+{
+    if (queueCount >= I2C_QUEUE_LENGTH)
+    {
+        queueFullCount++;
+        return I2C_ERROR_QUEUE_FULL;
+    }
+    transaction->status = I2C_PENDING;
+    queue[queueCount++] = transaction;
+    return 0;
+}
+
+int16_t i2cWait(I2cTransaction *transaction)
+{
+    // The bus runs the queue in order until the transaction has ended
+    while (transaction->status == I2C_PENDING && queueCount > 0)
+    {
+        runOnBus(queue[0]);
+        memmove(&queue[0], &queue[1], (queueCount - 1) * sizeof(queue[0]));
+        queueCount--;
+    }
+    return transaction->status;
+}
+
+/**
+ * @brief Prints the bus cost of the accesses since the last call.
+ */
+static void printCost(const char *access)
+{
+    printf("%-36s %2u transactions, %4lu SCL periods, %6lu us at 100 kHz\n", access,
+           transactionsRun, sclPeriods, sclPeriods * 1000000UL / I2C_STANDARD_MODE_HZ);
+    transactionsRun = 0;
+    sclPeriods = 0;
+}
+
+int main(void)
+{
+    uint8_t block[I2C_REG_MAX_BLOCK + 1];
+    uint8_t readBack[I2C_REG_MAX_BLOCK + 1];
+    uint8_t listRegisters[LIST_LENGTH];
+    uint8_t listValues[LIST_LENGTH];
+    I2cTransaction list[LIST_LENGTH];
+    uint8_t value = 0;
+    unsigned int failures = 0;
+    unsigned int i;
+    int16_t status;
+
+    // Single register
+    failures += i2cWriteReg(SLAVE_ADDRESS, 0x10, 0xA5) != I2C_OK;
+    failures += registers[0x10] != 0xA5;
+    failures += i2cReadReg(SLAVE_ADDRESS, 0x10, &value) != I2C_OK || value != 0xA5;
+    printCost("i2cWriteReg + i2cReadReg");
+
+    // Block across the end of the register file, the pointer wraps
+    for (i = 0; i < I2C_REG_MAX_BLOCK; i++)
+    {
+        block[i] = (uint8_t)(3 * i + 1);
+    }
+    failures += i2cWriteBlock(SLAVE_ADDRESS, 0xF8, block, I2C_REG_MAX_BLOCK) != I2C_OK;
+    failures += registers[0x00] != block[8];
+    failures += i2cReadBlock(SLAVE_ADDRESS, 0xF8, readBack, I2C_REG_MAX_BLOCK) != I2C_OK;
+    failures += memcmp(block, readBack, I2C_REG_MAX_BLOCK) != 0;
+    printCost("i2cWriteBlock + i2cReadBlock (16)");
+
+    // Too long for the buffer of i2cWriteBlock(), nothing goes on the bus
+    failures += i2cWriteBlock(SLAVE_ADDRESS, 0, block, I2C_REG_MAX_BLOCK + 1) != I2C_ERROR_LENGTH;
+    failures += transactionsRun != 0;
+
+    // Missing device
+    failures += i2cReadReg(MISSING_ADDRESS, 0, &value) != I2C_ERROR_NACK;
+    printCost("i2cReadReg of a missing device");
+
+    // List longer than the queue, the third transaction addresses the missing device
+    for (i = 0; i < LIST_LENGTH; i++)
+    {
+        listRegisters[i] = (uint8_t)(0x20 + i);
+        registers[0x20 + i] = (uint8_t)(0x80 + i);
+        list[i].address = (i == 2) ? MISSING_ADDRESS : SLAVE_ADDRESS;
+        list[i].txData = &listRegisters[i];
+        list[i].txCount = 1;
+        list[i].rxData = &listValues[i];
+        list[i].rxCount = 1;
+        list[i].callback = 0;
+        list[i].context = 0;
+        listValues[i] = 0;
+    }
+    queueFullCount = 0;
+    status = i2cRunList(list, LIST_LENGTH);
+    failures += status != I2C_ERROR_NACK;
+    for (i = 0; i < LIST_LENGTH; i++)
+    {
+        if (i == 2)
+        {
+            failures += list[i].status != I2C_ERROR_NACK;
+        }
+        else
+        {
+            failures += list[i].status != I2C_OK || listValues[i] != 0x80 + i;
+        }
+    }
+    failures += queueFullCount == 0; // The list has to have filled the queue
+    failures += queueCount != 0;
+    printCost("i2cRunList of 7 register reads");
+
+    printf("%u failures\n", failures);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file    lab5_i2c_speed.c
+ * @brief   Host check of the Lab 5 I2C prescaler and the joystick sample rate.
+ *
+ * This program computes the USCI_B0 prescaler I2C_PRESCALER() gives for the standard-mode
+ * and fast-mode requests at SMCLK_FREQUENCY_HZ. It fails if the bus would run faster than
+ * requested, if the prescaler is below I2C_MIN_PRESCALER, or if a smaller prescaler would
+ * still have been allowed. From the bus timing of one joystick burst (control byte,
+ * repeated start, BURST_LENGTH bytes) it prints the samples per second the bus allows;
+ * the interrupt time per byte comes on top. The prescaler depends on the clock, so the
+ * check is built once per SMCLK_FREQUENCY_HZ.
+ *
+ * Build and run from the repository root:
+ *   for f in 1000000 8000000 12000000 16000000; do gcc -std=gnu99 -Wall -DSMCLK_FREQUENCY_HZ=${f}UL -I"Embedded Lab 5/userCode/inc" -o lab5_i2c_speed tools/lab5_i2c_speed.c && ./lab5_i2c_speed || break; done
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "SystemClock.h"
+#include "TwoWire.h"
+
+#define BURST_LENGTH 4      // As in Hardware.c, three values and the previous conversion
+#define BITS_PER_BYTE 9     // Eight data bits and the acknowledge
+#define CONDITION_PERIODS 1 // Start, repeated start or stop
+
+// SCL periods of one joystick burst: address and control byte, repeated start, address and burst, stop
+#define BURST_PERIODS (CONDITION_PERIODS + 2 * BITS_PER_BYTE + CONDITION_PERIODS + \
+                       (1 + BURST_LENGTH) * BITS_PER_BYTE + CONDITION_PERIODS)
+
+/**
+ * @brief Checks the prescaler for one requested frequency.
+ *
+ * @param speedHz The requested SCL frequency.
+ * @return 1 if the prescaler is correct, 0 otherwise.
+ */
+static uint8_t checkSpeed(uint32_t speedHz)
+{
+    uint32_t prescaler = I2C_PRESCALER(SMCLK_FREQUENCY_HZ, speedHz);
+    uint32_t actualHz = SMCLK_FREQUENCY_HZ / prescaler;
+    uint8_t ok = 1;
+
+    // Too fast for the request or the USCI
+    if (actualHz > speedHz || prescaler < I2C_MIN_PRESCALER)
+    {
+        ok = 0;
+    }
+
+    // A smaller allowed prescaler must be too fast, otherwise the bus is slower than needed
+    if (prescaler > I2C_MIN_PRESCALER && SMCLK_FREQUENCY_HZ / (prescaler - 1) <= speedHz)
+    {
+        ok = 0;
+    }
+
+    printf("SMCLK %lu Hz, request %lu Hz: prescaler %lu, SCL %lu Hz, burst %lu us, at most %lu samples/s%s\n",
+           (unsigned long)SMCLK_FREQUENCY_HZ, (unsigned long)speedHz, (unsigned long)prescaler,
+           (unsigned long)actualHz, (unsigned long)(BURST_PERIODS * 1000000UL / actualHz),
+           (unsigned long)(actualHz / BURST_PERIODS), ok ? "" : " WRONG");
+
+    return ok;
+}
+
+int main(void)
+{
+    uint8_t ok = 1;
+
+    ok &= checkSpeed(I2C_STANDARD_MODE_HZ);
+    ok &= checkSpeed(I2C_FAST_MODE_HZ);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,245 @@
+/**
+ * @file    lab5_melody_stream.c
+ * @brief   Host check of the credit flow control of the Lab 5 melody stream.
+ *
+ * This program runs Melody.c against a model of the serial link in 1 ms steps: the
+ * receive ring and interrupt of templateEMP.h, one byte per millisecond on the line in
+ * both directions (9600 baud), the system tick that asks the player for the next event
+ * when the current one has ended, and the main loop that calls melodyStreamPoll(). A
+ * melody much longer than the 32-byte ring is streamed at the fastest tempo twice:
+ * - with credits, as described in Melody.h: no byte may be lost and every note has to
+ *   be played in order;
+ * - with the host sending everything at once: the ring has to overflow, which shows
+ *   that the first run is a real test.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -Wall -I"Embedded Lab 5/userCode/inc" -o lab5_melody_stream tools/lab5_melody_stream.c "Embedded Lab 5/userCode/src/Melody.c" && ./lab5_melody_stream
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "Notes.h"
+#include "Sequencer.h"
+#include "Melody.h"
+
+#define RXBUFFERSIZE 32     // As in templateEMP.h
+#define MELODY_NOTES 200    // Notes of the streamed melody
+#define MAX_BYTES (MELODY_NOTES + MELODY_NOTES / 8 + 4)
+#define TEMPO_BPM SEQUENCER_MAX_BPM
+#define MS_PER_MINUTE 60000UL
+#define TIMEOUT_MS 600000UL
+
+// Receive ring of templateEMP.h
+static volatile char rxBuffer[RXBUFFERSIZE];
+static volatile uint8_t rxBufferStart = 0;
+static volatile uint8_t rxBufferEnd = 0;
+static uint8_t rxBufferError = 0;
+
+// Credits on their way to the host, one byte per millisecond on the line
+static unsigned int txQueued = 0;
+
+// Sequencer model
+static SequencerSource source = 0;
+static uint8_t playing = 0;
+static uint16_t stepsLeft = 0;
+static uint32_t stepAccumulator = 0;
+
+// Notes the player started, in order
+static NOTE played[MAX_BYTES];
+static unsigned int playedCount = 0;
+
+// Functions of templateEMP.h used by Melody.c
+char serialAvailable(void)
+{
+    return rxBufferStart != rxBufferEnd;
+}
+
+int serialRead(void)
+{
+    char r;
+
+    if (rxBufferStart == rxBufferEnd)
+    {
+        return -1;
+    }
+    r = rxBuffer[rxBufferStart++];
+    rxBufferStart %= RXBUFFERSIZE;
+    return r;
+}
+
+void serialWrite(char tx)
+{
+    if (tx == MELODY_CREDIT)
+    {
+        txQueued++;
+    }
+}
+
+/**
+ * @brief The receive interrupt of templateEMP.h.
+ */
+static void receiveByte(uint8_t byte)
+{
+    rxBuffer[rxBufferEnd++] = byte;
+    rxBufferEnd %= RXBUFFERSIZE;
+    if (rxBufferStart == rxBufferEnd)
+    {
+        rxBufferError = 1;
+    }
+}
+
+/**
+ * @brief Asks the player for the next event, as the sequencer does at the end of one.
+ */
+static void nextEvent(void)
+{
+    SequencerEvent event;
+
+    if (!source(&event))
+    {
+        playing = 0;
+        return;
+    }
+
+    // A rest of one step without a note is the wait for a byte that has not arrived
+    if (event.note != NOTE_REST || event.rest != 0)
+    {
+        played[playedCount++] = event.note;
+    }
+    stepsLeft = event.duration + event.rest;
+}
+
+// Functions of the sequencer used by Melody.c
+void sequencerStop()
+{
+    playing = 0;
+}
+
+void sequencerPlayStream(SequencerSource newSource, SequencerCallback callback)
+{
+    (void)callback;
+    source = newSource;
+    stepAccumulator = 0;
+    playing = 1;
+    nextEvent();
+}
+
+/**
+ * @brief Streams the melody and checks the notes that were played.
+ *
+ * @param melody The melody bytes.
+ * @param length Number of bytes.
+ * @param useCredits 1 to wait for the credits, 0 to send everything at once.
+ *
+ * @return Returns 1 if no byte was lost and all notes were played in order.
+ */
+static uint8_t streamMelody(const uint8_t *melody, unsigned int length, uint8_t useCredits)
+{
+    unsigned int sent = 0;
+    unsigned int credits = MELODY_STREAM_WINDOW;
+    unsigned int maxWaiting = 0;
+    unsigned int expected = 0;
+    unsigned int i;
+    uint32_t ms;
+
+    rxBufferStart = rxBufferEnd = rxBufferError = 0;
+    txQueued = 0;
+    playedCount = 0;
+
+    melodyPlaySerial(0);
+
+    for (ms = 0; playing && ms < TIMEOUT_MS; ms++)
+    {
+        // One byte per millisecond in each direction
+        if (txQueued)
+        {
+            txQueued--;
+            credits++;
+        }
+        if (sent < length && (!useCredits || credits > 0))
+        {
+            receiveByte(melody[sent++]);
+            credits--;
+        }
+
+        if ((unsigned int)((rxBufferEnd - rxBufferStart) & (RXBUFFERSIZE - 1)) > maxWaiting)
+        {
+            maxWaiting = (rxBufferEnd - rxBufferStart) & (RXBUFFERSIZE - 1);
+        }
+
+        // System tick
+        stepAccumulator += (uint32_t)TEMPO_BPM * SEQUENCER_STEPS_PER_BEAT;
+        while (stepAccumulator >= MS_PER_MINUTE && playing)
+        {
+            stepAccumulator -= MS_PER_MINUTE;
+            if (stepsLeft == 0 || --stepsLeft == 0)
+            {
+                nextEvent();
+            }
+        }
+
+        // Main loop
+        melodyStreamPoll();
+    }
+
+    // Compare with the notes and rests of the melody, control bytes play nothing
+    for (i = 0; i < length; i++)
+    {
+        uint8_t byte = melody[i];
+        NOTE note;
+
+        if ((byte >> 5) == 0)
+        {
+            continue;
+        }
+        note = (byte & 0x1F) ? (NOTE)(MELODY_LOWEST_NOTE + (byte & 0x1F) - 1) : NOTE_REST;
+        if (expected >= playedCount || played[expected] != note)
+        {
+            break;
+        }
+        expected++;
+    }
+
+    printf("%s: %u bytes in %lu ms, at most %u waiting, %s, %u of %u events played in order\n",
+           useCredits ? "with credits" : "without credits", length, (unsigned long)ms, maxWaiting,
+           rxBufferError ? "ring overflowed" : "no overflow", expected, playedCount);
+
+    return !rxBufferError && !playing && expected == playedCount && sent == length;
+}
+
+int main(void)
+{
+    static uint8_t melody[MAX_BYTES];
+    unsigned int length = 0;
+    unsigned int i;
+    uint8_t ok;
+
+    melody[length++] = MELODY_START;
+    melody[length++] = MELODY_MARK; // Skipped when streaming
+    for (i = 0; i < MELODY_NOTES; i++)
+    {
+        if (i % 8 == 7)
+        {
+            melody[length++] = MELODY_REST(MELODY_SIXTEENTH);
+        }
+        melody[length++] = MELODY_NOTE(MELODY_LOWEST_NOTE + i % 30, MELODY_SIXTEENTH);
+    }
+    melody[length++] = MELODY_REPEAT(1); // Skipped when streaming
+    melody[length++] = MELODY_END;
+
+    ok = streamMelody(melody, length, 1);
+
+    // Without credits the ring has to overflow, otherwise the model proves nothing
+    if (streamMelody(melody, length, 0))
+    {
+        printf("the stream without credits did not fail, the model is wrong\n");
+        ok = 0;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file    lab5_note_periods.c
+ * @brief   Host check of the pitch error of the Lab 5 note period table.
+ *
+ * This program computes the frequency every entry of the period table plays at
+ * PWM_CLOCK_HZ and compares it with the equal-tempered pitch (A4 = 440 Hz). It prints the
+ * worst error in cents and fails if any note is off by more than MAX_ERROR_CENTS. The
+ * table depends on the clock, so the check is built once per SMCLK_FREQUENCY_HZ.
+ *
+ * Build and run from the repository root:
+ *   for f in 1000000 8000000 12000000 16000000; do gcc -std=gnu99 -Wall -DSMCLK_FREQUENCY_HZ=${f}UL -I"Embedded Lab 5/userCode/inc" -o lab5_note_periods tools/lab5_note_periods.c "Embedded Lab 5/userCode/src/Notes.c" -lm && ./lab5_note_periods || break; done
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "SoftwarePwm.h"
+#include "Notes.h"
+
+#define MIDI_C3 48         // MIDI number of NOTE_C3, the first note after NOTE_REST
+#define MIDI_A4 69         // MIDI number of the reference pitch
+#define A4_HZ 440.0
+#define MAX_ERROR_CENTS 2.0 // Below what the ear notices in a melody
+
+int main(void)
+{
+    double worst = 0.0;
+    NOTE worstNote = NOTE_REST;
+    NOTE note;
+
+    for (note = NOTE_C3; note < NUM_PITCHES; note++)
+    {
+        int midi = MIDI_C3 + (note - NOTE_C3);
+        double target = A4_HZ * pow(2.0, (midi - MIDI_A4) / 12.0);
+        uint16_t period = getNotePeriod(note);
+        double played = (double)PWM_CLOCK_HZ / period;
+        double cents = 1200.0 * log2(played / target);
+
+        if (fabs(cents) > fabs(worst))
+        {
+            worst = cents;
+            worstNote = note;
+        }
+    }
+
+    printf("SMCLK %lu Hz: C3 period %u, C8 period %u, worst error %.2f cents (MIDI %d)\n",
+           (unsigned long)SMCLK_FREQUENCY_HZ, getNotePeriod(NOTE_C3), getNotePeriod(NOTE_C8),
+           worst, MIDI_C3 + (worstNote - NOTE_C3));
+
+    return fabs(worst) > MAX_ERROR_CENTS ? 1 : 0;
+}
@@ -0,0 +1,254 @@
+/**
+ * @file    lab5_voices.c
+ * @brief   Host render and check of the Lab 5 two-voice tone engine.
+ *
+ * This program runs Voices.c on the Timer1_A model of tools/host, one timer clock per
+ * step, with the system tick every millisecond. A C5/E5 chord is played for CHORD_MS in
+ * both outputs:
+ * - separate: every edge of TA1.1 and TA1.2 has to come exactly one half period of its
+ *   note after the previous one;
+ * - mixed: every edge of TA1.1 has to belong to one of the two notes, the notes have to
+ *   take turns every VOICE_MIX_SLOT_MS (within one half period) and share the time
+ *   within MAX_SHARE_DIFFERENCE percent. With the second voice silent only the first
+ *   note may sound.
+ * The output pins are box-filtered to WAV_RATE_HZ and written to lab5_voices_separate.wav
+ * and lab5_voices_mixed.wav in the current directory.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -Wall -Itools/host -I"Embedded Lab 5/userCode/inc" -o lab5_voices tools/lab5_voices.c tools/host/HostTimer.c tools/host/HostWav.c "Embedded Lab 5/userCode/src/Voices.c" "Embedded Lab 5/userCode/src/Notes.c" && ./lab5_voices
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <msp430.h>
+#include "HostTimer.h"
+#include "HostWav.h"
+
+#include "SoftwarePwm.h"
+#include "SysTick.h"
+#include "Notes.h"
+#include "Voices.h"
+
+#define CHORD_MS 500
+#define WAV_RATE_HZ 32000UL
+#define TIMER_CLOCKS_PER_MS (PWM_CLOCK_HZ / 1000UL)
+#define MAX_EDGES 4096
+#define MAX_SHARE_DIFFERENCE 5 // Percent, the slots end with an edge of the old voice
+
+static SysTickHandler tickHandler = 0;
+
+// Edges of one output, in timer clocks since the start
+static uint32_t edges[VOICE_COUNT][MAX_EDGES];
+static unsigned int edgeCount[VOICE_COUNT];
+
+// Functions of SysTick.c used by Voices.c
+void initSysTick()
+{
+}
+
+int16_t sysTickRegister(SysTickHandler handler)
+{
+    tickHandler = handler;
+    return 0;
+}
+
+/**
+ * @brief Plays the voices for a time and records the edges and the sound.
+ *
+ * @param output The output of the voices.
+ * @param first The note of voice 1.
+ * @param second The note of voice 2.
+ * @param wavPath The WAV file to write, or 0.
+ */
+static void play(VOICE_OUTPUT output, NOTE first, NOTE second, const char *wavPath)
+{
+    FILE *wav = wavPath ? hostWavOpen(wavPath, WAV_RATE_HZ) : 0;
+    uint8_t level[VOICE_COUNT] = {0, 0};
+    uint32_t highClocks = 0;
+    uint32_t sampleClocks = 0;
+    uint32_t sampleAccumulator = 0;
+    uint32_t clock;
+    uint8_t pins = (output == VOICE_OUTPUT_SEPARATE) ? VOICE_COUNT : 1;
+    uint8_t i;
+
+    hostTimerReset();
+    edgeCount[0] = edgeCount[1] = 0;
+
+    initVoices(output);
+    voicesSetNote(0, first);
+    voicesSetNote(1, second);
+    voicesStart();
+
+    for (clock = 1; clock <= CHORD_MS * TIMER_CLOCKS_PER_MS; clock++)
+    {
+        uint16_t vector;
+
+        hostTimerStep();
+        while ((vector = hostTimerTakeVector()) != TA1IV_NONE)
+        {
+            voicesInterrupt(vector);
+        }
+        if (clock % TIMER_CLOCKS_PER_MS == 0 && tickHandler)
+        {
+            tickHandler();
+        }
+
+        for (i = 0; i < pins; i++)
+        {
+            uint8_t newLevel = hostTimerOutput(i + 1);
+
+            if (newLevel != level[i] && edgeCount[i] < MAX_EDGES)
+            {
+                edges[i][edgeCount[i]++] = clock;
+            }
+            level[i] = newLevel;
+            highClocks += newLevel;
+        }
+
+        // Box filter down to the WAV rate
+        sampleClocks++;
+        sampleAccumulator += WAV_RATE_HZ;
+        if (sampleAccumulator >= PWM_CLOCK_HZ)
+        {
+            sampleAccumulator -= PWM_CLOCK_HZ;
+            if (wav)
+            {
+                hostWavWrite(wav, (int16_t)((int32_t)highClocks * 32000 / (sampleClocks * pins) - 16000));
+            }
+            highClocks = 0;
+            sampleClocks = 0;
+        }
+    }
+
+    voicesStop();
+    if (wav)
+    {
+        hostWavClose(wav);
+    }
+}
+
+/**
+ * @brief Checks that every edge of an output comes one half period after the last one.
+ *
+ * @return The number of failures.
+ */
+static unsigned int checkSeparate(uint8_t voice, NOTE note)
+{
+    uint16_t halfPeriod = getNotePeriod(note) >> 1;
+    unsigned int failures = 0;
+    unsigned int i;
+
+    for (i = 1; i < edgeCount[voice]; i++)
+    {
+        failures += edges[voice][i] - edges[voice][i - 1] != halfPeriod;
+    }
+
+    printf("separate voice %u: %u edges, %.2f Hz, %u wrong intervals\n", voice + 1, edgeCount[voice],
+           (double)PWM_CLOCK_HZ / (2.0 * halfPeriod), failures);
+
+    return failures + (edgeCount[voice] < 2);
+}
+
+/**
+ * @brief Checks the slots of the mixed output.
+ *
+ * @param first The note of voice 1.
+ * @param second The note of voice 2, NOTE_REST if it is silent.
+ * @return The number of failures.
+ */
+static unsigned int checkMixed(NOTE first, NOTE second)
+{
+    uint16_t half[VOICE_COUNT] = {getNotePeriod(first) >> 1, getNotePeriod(second) >> 1};
+    uint16_t longest = half[0] > half[1] ? half[0] : half[1];
+    uint32_t slotStart = 0;
+    uint32_t voiceTime[VOICE_COUNT] = {0, 0};
+    uint32_t shortestSlot = 0xFFFFFFFFUL;
+    uint32_t longestSlot = 0;
+    unsigned int slots = 0;
+    unsigned int failures = 0;
+    unsigned int i;
+    int slotVoice = -1;
+
+    for (i = 1; i < edgeCount[0]; i++)
+    {
+        uint32_t interval = edges[0][i] - edges[0][i - 1];
+        int voice = (interval == half[0]) ? 0 : (interval == half[1]) ? 1 : -1;
+
+        if (voice < 0)
+        {
+            failures++;
+            continue;
+        }
+        voiceTime[voice] += interval;
+
+        if (voice != slotVoice)
+        {
+            // Only the slots between two switches are complete
+            if (slotVoice >= 0 && slots > 0)
+            {
+                uint32_t length = edges[0][i - 1] - slotStart;
+
+                shortestSlot = length < shortestSlot ? length : shortestSlot;
+                longestSlot = length > longestSlot ? length : longestSlot;
+            }
+            if (slotVoice >= 0)
+            {
+                slots++;
+            }
+            slotVoice = voice;
+            slotStart = edges[0][i - 1];
+        }
+    }
+
+    if (second == NOTE_REST)
+    {
+        failures += voiceTime[1] != 0 || slots != 0;
+        printf("mixed, second voice silent: %u edges, %u switches, %u wrong intervals\n",
+               edgeCount[0], slots, failures);
+        return failures;
+    }
+
+    printf("mixed: %u switches, slots %.2f to %.2f ms, voice time %u/%u ms, %u wrong intervals\n",
+           slots, (double)shortestSlot / TIMER_CLOCKS_PER_MS, (double)longestSlot / TIMER_CLOCKS_PER_MS,
+           (unsigned int)(voiceTime[0] / TIMER_CLOCKS_PER_MS), (unsigned int)(voiceTime[1] / TIMER_CLOCKS_PER_MS),
+           failures);
+
+    // A switch waits for the next edge, so a slot is off by at most one half period
+    if (slots < CHORD_MS / VOICE_MIX_SLOT_MS - 2 ||
+        shortestSlot + longest < VOICE_MIX_SLOT_MS * TIMER_CLOCKS_PER_MS ||
+        longestSlot > VOICE_MIX_SLOT_MS * TIMER_CLOCKS_PER_MS + longest)
+    {
+        failures++;
+    }
+    if (labs((long)voiceTime[0] - (long)voiceTime[1]) * 100 > (long)(voiceTime[0] + voiceTime[1]) * MAX_SHARE_DIFFERENCE)
+    {
+        failures++;
+    }
+
+    return failures;
+}
+
+int main(void)
+{
+    unsigned int failures = 0;
+
+    play(VOICE_OUTPUT_SEPARATE, NOTE_C5, NOTE_E5, "lab5_voices_separate.wav");
+    failures += checkSeparate(0, NOTE_C5);
+    failures += checkSeparate(1, NOTE_E5);
+
+    play(VOICE_OUTPUT_MIXED, NOTE_C5, NOTE_E5, "lab5_voices_mixed.wav");
+    failures += checkMixed(NOTE_C5, NOTE_E5);
+
+    play(VOICE_OUTPUT_MIXED, NOTE_C5, NOTE_REST, 0);
+    failures += checkMixed(NOTE_C5, NOTE_REST);
+
+    printf("%u failures\n", failures);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file    lab6_adc_filters.c
+ * @brief   Host check of the Lab 6 ADC filters.
+ *
+ * This program feeds synthetic ADC10 readings through AdcFilter.c of Lab 6:
+ * - step response: the moving average has to settle exactly after MOVING_AVERAGE_LENGTH
+ *   samples and the exponential filter has to settle without overshoot;
+ * - oversampling: a constant input with Gaussian noise of ADC_NOISE_LSB is quantized to
+ *   10 bits and decimated in blocks of 16 as the ADC10 interrupt does. The gain in SNR over
+ *   the raw samples has to be at least MIN_SNR_GAIN_DB; 16 samples give 12 dB in theory.
+ *   The sample-by-sample decimator has to give the same result as decimateFrames();
+ * - cost: the host cycles per sample of every filter. They only compare the filters with
+ *   each other, the MSP430 cycles need the board.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -O2 -Wall -I"Embedded Lab 6/userCode/inc" -o lab6_adc_filters tools/lab6_adc_filters.c "Embedded Lab 6/userCode/src/AdcFilter.c" -lm && ./lab6_adc_filters
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <x86intrin.h>
+
+#include "AdcFilter.h"
+
+#define ADC_MAX 1023
+#define STEP_VALUE 1000
+#define EXP_SHIFT 2          // ADC_FILTER_SHIFT of main.c
+#define EXTRA_BITS 2         // ADC_EXTRA_BITS of Hardware.h
+#define BLOCK_LENGTH (1 << (EXTRA_BITS << 1))
+#define ADC_NOISE_LSB 0.7    // Typical noise of the ADC10 with a potentiometer input
+#define MIN_SNR_GAIN_DB 9.0
+#define SNR_BLOCKS 20000
+#define COST_SAMPLES 1000000UL
+
+/**
+ * @brief Returns a Gaussian random number with mean 0 and deviation 1 (Box-Muller).
+ */
+static double gaussian(void)
+{
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/**
+ * @brief Converts an input voltage in LSB to a noisy 10-bit reading.
+ */
+static uint16_t convert(double input)
+{
+    long code = lround(input + ADC_NOISE_LSB * gaussian());
+
+    if (code < 0)
+    {
+        return 0;
+    }
+    return code > ADC_MAX ? ADC_MAX : (uint16_t)code;
+}
+
+/**
+ * @brief Checks the step response from 0 to STEP_VALUE.
+ *
+ * @return The number of failures.
+ */
+static unsigned int checkStepResponse(void)
+{
+    MovingAverageFilter average;
+    ExponentialFilter smooth;
+    unsigned int failures = 0;
+    unsigned int averageSettled = 0;
+    unsigned int smoothSettled = 0;
+    unsigned int n;
+    uint16_t previous = 0;
+    uint16_t value;
+
+    movingAverageInit(&average, 0);
+    for (n = 1; n <= 2 * MOVING_AVERAGE_LENGTH; n++)
+    {
+        value = movingAverageUpdate(&average, STEP_VALUE);
+        if (value < previous || value > STEP_VALUE)
+        {
+            failures++;
+        }
+        if (value == STEP_VALUE && averageSettled == 0)
+        {
+            averageSettled = n;
+        }
+        previous = value;
+    }
+    if (averageSettled != MOVING_AVERAGE_LENGTH)
+    {
+        failures++;
+    }
+
+    expFilterInit(&smooth, EXP_SHIFT, 0);
+    previous = 0;
+    for (n = 1; n <= 100; n++)
+    {
+        value = expFilterUpdate(&smooth, STEP_VALUE);
+        if (value < previous || value > STEP_VALUE)
+        {
+            failures++;
+        }
+        if (value == STEP_VALUE && smoothSettled == 0)
+        {
+            smoothSettled = n;
+        }
+        previous = value;
+    }
+    if (smoothSettled == 0)
+    {
+        failures++;
+    }
+
+    printf("step 0 -> %u: moving average settled after %u samples, exponential (alpha 1/%u) after %u\n",
+           STEP_VALUE, averageSettled, 1 << EXP_SHIFT, smoothSettled);
+
+    return failures;
+}
+
+/**
+ * @brief Checks the SNR gain of the decimation of noisy blocks.
+ *
+ * @return The number of failures.
+ */
+static unsigned int checkOversampling(void)
+{
+    uint16_t block[BLOCK_LENGTH];
+    Decimator decimator;
+    double rawError = 0.0;
+    double decimatedError = 0.0;
+    double gain;
+    unsigned int failures = 0;
+    unsigned int i;
+    unsigned int n;
+
+    srand(1);
+    decimatorInit(&decimator, EXTRA_BITS);
+
+    for (n = 0; n < SNR_BLOCKS; n++)
+    {
+        double input = 20.0 + (ADC_MAX - 40.0) * rand() / RAND_MAX;
+        double target = input * (1 << EXTRA_BITS);
+        uint16_t result;
+        uint8_t done = 0;
+
+        for (i = 0; i < BLOCK_LENGTH; i++)
+        {
+            block[i] = convert(input);
+            done = decimatorUpdate(&decimator, block[i]);
+            rawError += pow(block[i] * (1 << EXTRA_BITS) - target, 2);
+        }
+
+        result = decimateFrames(block, 1, EXTRA_BITS);
+        if (!done || decimator.result != result)
+        {
+            failures++;
+        }
+
+        // The shift truncates, half a 12-bit LSB is the expected bias
+        decimatedError += pow(result + 0.5 - target, 2);
+    }
+
+    rawError = sqrt(rawError / (SNR_BLOCKS * BLOCK_LENGTH));
+    decimatedError = sqrt(decimatedError / SNR_BLOCKS);
+    gain = 20.0 * log10(rawError / decimatedError);
+
+    printf("oversampling x%u: rms error %.2f -> %.2f 12-bit LSB, SNR gain %.1f dB (%.2f effective bits)\n",
+           BLOCK_LENGTH, rawError, decimatedError, gain, gain / 6.02);
+
+    if (gain < MIN_SNR_GAIN_DB)
+    {
+        failures++;
+    }
+
+    return failures;
+}
+
+/**
+ * @brief Prints the host cycles per sample of every filter.
+ */
+static void measureCost(void)
+{
+    static uint16_t samples[1024];
+    MovingAverageFilter average;
+    ExponentialFilter smooth;
+    Decimator decimator;
+    volatile uint16_t sink = 0;
+    uint64_t start;
+    unsigned long n;
+
+    for (n = 0; n < 1024; n++)
+    {
+        samples[n] = convert(512.0);
+    }
+    movingAverageInit(&average, 512);
+    expFilterInit(&smooth, EXP_SHIFT, 512);
+    decimatorInit(&decimator, EXTRA_BITS);
+
+    start = __rdtsc();
+    for (n = 0; n < COST_SAMPLES; n++)
+    {
+        sink = movingAverageUpdate(&average, samples[n & 1023]);
+    }
+    printf("cost: moving average %.1f,", (double)(__rdtsc() - start) / COST_SAMPLES);
+
+    start = __rdtsc();
+    for (n = 0; n < COST_SAMPLES; n++)
+    {
+        sink = expFilterUpdate(&smooth, samples[n & 1023]);
+    }
+    printf(" exponential %.1f,", (double)(__rdtsc() - start) / COST_SAMPLES);
+
+    start = __rdtsc();
+    for (n = 0; n < COST_SAMPLES; n++)
+    {
+        sink = decimatorUpdate(&decimator, samples[n & 1023]);
+    }
+    printf(" decimator %.1f,", (double)(__rdtsc() - start) / COST_SAMPLES);
+
+    start = __rdtsc();
+    for (n = 0; n < COST_SAMPLES; n += BLOCK_LENGTH)
+    {
+        sink = decimateFrames(&samples[n & (1023 & ~(BLOCK_LENGTH - 1))], 1, EXTRA_BITS);
+    }
+    printf(" block decimation %.1f host cycles per sample\n", (double)(__rdtsc() - start) / COST_SAMPLES);
+
+    (void)sink;
+}
+
+int main(void)
+{
+    unsigned int failures = 0;
+
+    failures += checkStepResponse();
+    failures += checkOversampling();
+    measureCost();
+
+    printf("%u failures\n", failures);
+
+    return failures ? 1 : 0;
+}
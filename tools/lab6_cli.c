@@ -0,0 +1,183 @@
+/**
+ * @file    lab6_cli.c
+ * @brief   Command line client of the Lab 6 binary protocol.
+ *
+ * This program talks to the Lab 6 board after the console command "binary":
+ * - monitor [seconds]: prints every frame of the board until it is silent for the given
+ *   time, default 10 s;
+ * - config <adc|telemetry|stopwatch|console> <value>: writes a setting (Protocol.h) and
+ *   prints the acknowledgement, e.g. "config telemetry 100" or "config console 0" to
+ *   return to the text console.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -Wall -Itools/host -I"Embedded Lab 6/userCode/inc" -o lab6_cli tools/lab6_cli.c tools/host/HostLink.c && ./lab6_cli /dev/ttyACM0 monitor
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "HostLink.h"
+
+#define ACK_TIMEOUT_MS 500
+#define STATS_PAYLOAD 21 // uint32 ticks, uint8 tasks, ProtocolStatistics of the MSP430
+
+static const char *configNames[] = {"", "adc", "telemetry", "stopwatch", "console"};
+
+/**
+ * @brief Reads a little endian value from a payload.
+ */
+static uint32_t readLittleEndian(const uint8_t *bytes, uint8_t count)
+{
+    uint32_t value = 0;
+
+    while (count--)
+    {
+        value = (value << 8) | bytes[count];
+    }
+
+    return value;
+}
+
+/**
+ * @brief Prints a frame of the board.
+ */
+static void printFrame(const ProtocolFrame *frame)
+{
+    const uint8_t *p = frame->payload;
+
+    printf("#%3u ", frame->sequence);
+
+    switch (frame->type)
+    {
+    case MSG_ADC_FRAME:
+        printf("ADC raw %u, filtered %u\n", (unsigned int)readLittleEndian(p, 2),
+               (unsigned int)readLittleEndian(&p[2], 2));
+        break;
+    case MSG_SCHEDULER_STATS:
+        if (frame->length != STATS_PAYLOAD)
+        {
+            printf("statistics of %u bytes\n", frame->length);
+            break;
+        }
+        printf("ticks %lu, %u tasks, frames sent %u dropped %u received %u rejected %u, "
+               "payload %lu of %lu bytes\n",
+               (unsigned long)readLittleEndian(p, 4), p[4], (unsigned int)readLittleEndian(&p[5], 2),
+               (unsigned int)readLittleEndian(&p[7], 2), (unsigned int)readLittleEndian(&p[9], 2),
+               (unsigned int)readLittleEndian(&p[11], 2), (unsigned long)readLittleEndian(&p[13], 4),
+               (unsigned long)readLittleEndian(&p[17], 4));
+        break;
+    case MSG_BUTTON_EVENT:
+        printf("button %u\n", p[0]);
+        break;
+    case MSG_ACK:
+        printf("ACK of type %u #%u: %s\n", p[0], p[1], p[2] == 0 ? "done" : "refused");
+        break;
+    default:
+        printf("type %u, %u bytes\n", frame->type, frame->length);
+        break;
+    }
+}
+
+/**
+ * @brief Writes a setting and waits for the acknowledgement.
+ *
+ * @return 0 if the board has applied the setting, 1 otherwise.
+ */
+static int config(HostLink *link, const char *name, const char *valueText)
+{
+    uint8_t payload[3];
+    uint8_t sequence = link->txSequence;
+    ProtocolFrame frame;
+    long value = strtol(valueText, 0, 10);
+    uint8_t key;
+
+    for (key = CONFIG_ADC_INTERVAL; key <= CONFIG_CONSOLE; key++)
+    {
+        if (strcmp(name, configNames[key]) == 0)
+        {
+            break;
+        }
+    }
+    if (key > CONFIG_CONSOLE || value < INT16_MIN || value > INT16_MAX)
+    {
+        fprintf(stderr, "Unknown setting or value out of range\n");
+        return 1;
+    }
+
+    payload[0] = key;
+    payload[1] = (uint8_t)value;
+    payload[2] = (uint8_t)((uint16_t)value >> 8);
+    if (hostLinkSend(link, MSG_CONFIG_WRITE, payload, sizeof(payload)) != 0)
+    {
+        perror("write");
+        return 1;
+    }
+
+    // Telemetry may come before the acknowledgement
+    while (hostLinkReceive(link, &frame, ACK_TIMEOUT_MS) == 1)
+    {
+        if (frame.type == MSG_ACK && frame.length == 3 && frame.payload[0] == MSG_CONFIG_WRITE &&
+            frame.payload[1] == sequence)
+        {
+            printFrame(&frame);
+            return frame.payload[2] != 0;
+        }
+    }
+
+    fprintf(stderr, "No acknowledgement\n");
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    HostLink link;
+    ProtocolFrame frame;
+    int seconds = 10;
+    int result = 1;
+
+    if (argc < 3 || (strcmp(argv[2], "config") == 0 && argc != 5))
+    {
+        fprintf(stderr, "Usage: %s <device> monitor [seconds]\n"
+                        "       %s <device> config <adc|telemetry|stopwatch|console> <value>\n",
+                argv[0], argv[0]);
+        return 1;
+    }
+
+    if (hostLinkOpen(&link, argv[1]) != 0)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    if (strcmp(argv[2], "monitor") == 0)
+    {
+        if (argc > 3)
+        {
+            seconds = atoi(argv[3]);
+        }
+        while (hostLinkReceive(&link, &frame, seconds * 1000) == 1)
+        {
+            printFrame(&frame);
+        }
+        printf("%lu frames, %lu rejected\n", link.framesReceived, link.framesRejected);
+        result = 0;
+    }
+    else if (strcmp(argv[2], "config") == 0)
+    {
+        result = config(&link, argv[3], argv[4]);
+    }
+    else
+    {
+        fprintf(stderr, "Unknown command %s\n", argv[2]);
+    }
+
+    hostLinkClose(&link);
+
+    return result;
+}
@@ -0,0 +1,315 @@
+/**
+ * @file    lab6_protocol.c
+ * @brief   Host check of the Lab 6 frame protocol against the Linux host link.
+ *
+ * This program runs Protocol.c on the host; its transmit interrupt is called to take the
+ * bytes out of the ring. It checks:
+ * - the CRC of both sides against the reference value of CRC-16/CCITT-FALSE
+ *   ("123456789" gives 0x29B1);
+ * - the COBS round trip of payloads with zeros at the start, the end and in a row, none
+ *   at all and PROTOCOL_MAX_PAYLOAD bytes: device to device, device to host and host to
+ *   device;
+ * - that a frame with a flipped bit is rejected and counted;
+ * - that frames which do not fit into the transmit ring are dropped whole and counted;
+ * - a loopback over a pseudo terminal: the host link opens the terminal like the serial
+ *   device of the LaunchPad, the device side writes and reads the other end.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -Wall -Wno-unknown-pragmas -Itools/host -I"Embedded Lab 6/userCode/inc" -o lab6_protocol tools/lab6_protocol.c tools/host/HostLink.c "Embedded Lab 6/userCode/src/Protocol.c" && ./lab6_protocol
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#define _XOPEN_SOURCE 600
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define HOST_MSP430_REGISTERS
+#include <msp430.h>
+#include "HostLink.h"
+
+#include "Protocol.h"
+#include "Trace.h"
+
+#define CRC_CHECK_VALUE 0x29B1 // CRC-16/CCITT-FALSE of "123456789"
+#define LINE_BYTES 256
+#define LOOPBACK_TIMEOUT_MS 1000
+
+// Service routine of Protocol.c
+extern void protocolTxISR(void);
+
+// Trace.c is not part of the check
+volatile uint16_t traceMask = 0;
+
+void traceEvent(uint8_t event, uint8_t arg)
+{
+}
+
+/**
+ * @brief Runs the transmit interrupt until the ring is empty.
+ *
+ * @param line Buffer for the sent bytes.
+ *
+ * @return The number of bytes sent.
+ */
+static unsigned int drainTx(uint8_t *line)
+{
+    unsigned int count = 0;
+
+    while (IE2 & UCA0TXIE)
+    {
+        uint8_t before = IE2;
+
+        protocolTxISR();
+        if (IE2 == before && count < LINE_BYTES)
+        {
+            line[count++] = UCA0TXBUF;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Compares a decoded frame with what was sent.
+ */
+static unsigned int sameFrame(const ProtocolFrame *frame, uint8_t type, uint8_t sequence, const uint8_t *payload,
+                              uint8_t length)
+{
+    return frame->type == type && frame->sequence == sequence && frame->length == length &&
+           memcmp(frame->payload, payload, length) == 0;
+}
+
+/**
+ * @brief Sends a payload through the device encoder, decodes it with both sides and
+ *        sends the host encoding through the device decoder.
+ *
+ * @return The number of failures.
+ */
+static unsigned int roundTrip(const char *name, const uint8_t *payload, uint8_t length)
+{
+    static uint8_t sequence = 0;
+    uint8_t line[LINE_BYTES];
+    uint8_t hostLine[HOST_LINK_MAX_LINE];
+    unsigned int lineLength;
+    uint8_t hostLength;
+    ProtocolFrame frame;
+    unsigned int failures = 0;
+    unsigned int zeros = 0;
+    unsigned int i;
+
+    // Device to host, the sequence numbers of the device count from protocolStart()
+    if (protocolSend(MSG_ADC_FRAME, payload, length) != 0)
+    {
+        printf("%-20s not sent\n", name);
+        return 1;
+    }
+    lineLength = drainTx(line);
+    for (i = 0; i < lineLength - 1; i++)
+    {
+        zeros += line[i] == 0;
+    }
+    failures += zeros != 0 || line[lineLength - 1] != 0 || lineLength != length + PROTOCOL_OVERHEAD;
+    failures += hostLinkDecode(line, lineLength - 1, &frame) != 0 || !sameFrame(&frame, MSG_ADC_FRAME, sequence,
+                                                                                  payload, length);
+
+    // Device to device
+    for (i = 0; i < lineLength; i++)
+    {
+        protocolReceiveByte(line[i]);
+    }
+    failures += !protocolReceive(&frame) || !sameFrame(&frame, MSG_ADC_FRAME, sequence, payload, length);
+
+    // Host to device, the same bytes as the device encoder
+    hostLength = hostLinkEncode(MSG_ADC_FRAME, sequence, payload, length, hostLine);
+    failures += hostLength != lineLength || memcmp(hostLine, line, lineLength) != 0;
+    for (i = 0; i < hostLength; i++)
+    {
+        protocolReceiveByte(hostLine[i]);
+    }
+    failures += !protocolReceive(&frame) || !sameFrame(&frame, MSG_ADC_FRAME, sequence, payload, length);
+
+    printf("%-20s %2u bytes payload, %2u on the line, %s\n", name, length, lineLength, failures ? "FAILED" : "ok");
+    sequence++;
+
+    return failures;
+}
+
+/**
+ * @brief Checks the CRC of both sides.
+ *
+ * @return The number of failures.
+ */
+static unsigned int checkCrc(void)
+{
+    const uint8_t check[] = "123456789";
+    uint16_t device = protocolCrc16(0xFFFF, check, 9);
+    uint16_t host = hostLinkCrc16(check, 9);
+    // Continuing the CRC over a second block gives the CRC of the whole
+    uint16_t split = protocolCrc16(protocolCrc16(0xFFFF, check, 4), &check[4], 5);
+
+    printf("CRC of \"123456789\": device 0x%04X, host 0x%04X, in two blocks 0x%04X, expected 0x%04X\n", device,
+           host, split, CRC_CHECK_VALUE);
+
+    return (device != CRC_CHECK_VALUE) + (host != CRC_CHECK_VALUE) + (split != CRC_CHECK_VALUE);
+}
+
+/**
+ * @brief Checks that a corrupted frame is rejected.
+ *
+ * @return The number of failures.
+ */
+static unsigned int checkCorrupt(void)
+{
+    const uint8_t payload[4] = {1, 2, 3, 4};
+    uint8_t line[HOST_LINK_MAX_LINE];
+    uint8_t length = hostLinkEncode(MSG_CONFIG_WRITE, 0, payload, sizeof(payload), line);
+    ProtocolStatistics statistics;
+    ProtocolFrame frame;
+    uint8_t i;
+
+    line[3] ^= 0x10;
+    for (i = 0; i < length; i++)
+    {
+        protocolReceiveByte(line[i]);
+    }
+    protocolGetStatistics(&statistics);
+
+    printf("flipped bit: %u frames rejected, %s\n", statistics.framesRejected,
+           protocolReceive(&frame) ? "received" : "not received");
+
+    return statistics.framesRejected != 1 || protocolReceive(&frame);
+}
+
+/**
+ * @brief Fills the transmit ring without sending and checks the dropped frames.
+ *
+ * @return The number of failures.
+ */
+static unsigned int checkDropped(void)
+{
+    uint8_t payload[PROTOCOL_MAX_PAYLOAD];
+    uint8_t line[LINE_BYTES];
+    // The ring holds PROTOCOL_TX_BUFFER - 1 bytes
+    unsigned int fit = (PROTOCOL_TX_BUFFER - 1) / (PROTOCOL_MAX_PAYLOAD + PROTOCOL_OVERHEAD);
+    unsigned int attempts = fit + 3;
+    unsigned int queued = 0;
+    unsigned int i;
+    unsigned int lineLength;
+    ProtocolStatistics statistics;
+
+    memset(payload, 0x55, sizeof(payload));
+    protocolStart();
+    for (i = 0; i < attempts; i++)
+    {
+        queued += protocolSend(MSG_ADC_FRAME, payload, sizeof(payload)) == 0;
+    }
+    protocolGetStatistics(&statistics);
+    lineLength = drainTx(line);
+
+    printf("full ring: %u of %u frames queued, %u sent, %u dropped, %u bytes on the line\n", queued, attempts,
+           statistics.framesSent, statistics.framesDropped, lineLength);
+
+    // Only whole frames are sent, and a frame fits again once the ring is empty
+    return queued != fit || statistics.framesSent != fit || statistics.framesDropped != attempts - fit ||
+           lineLength != fit * (PROTOCOL_MAX_PAYLOAD + PROTOCOL_OVERHEAD) ||
+           protocolSend(MSG_ADC_FRAME, payload, sizeof(payload)) != 0;
+}
+
+/**
+ * @brief Sends frames both ways over a pseudo terminal.
+ *
+ * @return The number of failures.
+ */
+static unsigned int checkLoopback(void)
+{
+    const uint8_t adc[4] = {0x00, 0x02, 0xFF, 0x01};
+    const uint8_t config[3] = {CONFIG_TELEMETRY_INTERVAL, 0x00, 0x00};
+    uint8_t line[LINE_BYTES];
+    unsigned int lineLength;
+    ProtocolFrame frame;
+    HostLink link;
+    unsigned int failures = 0;
+    uint8_t byte;
+    int device = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (device < 0 || grantpt(device) != 0 || unlockpt(device) != 0 || hostLinkOpen(&link, ptsname(device)) != 0)
+    {
+        perror("pseudo terminal");
+        return 1;
+    }
+
+    // Device to host after noise, as when the host opens the device in the middle of a
+    // frame; the first frame is lost with the noise, the decoder is in step at its end
+    protocolStart();
+    protocolSend(MSG_ADC_FRAME, adc, sizeof(adc));
+    protocolSend(MSG_ADC_FRAME, adc, sizeof(adc));
+    protocolSend(MSG_BUTTON_EVENT, "\x01", 1);
+    lineLength = drainTx(line);
+    failures += write(device, "\x17\x42", 2) != 2;
+    failures += write(device, line, lineLength) != (ssize_t)lineLength;
+    failures += hostLinkReceive(&link, &frame, LOOPBACK_TIMEOUT_MS) != 1 || !sameFrame(&frame, MSG_ADC_FRAME, 1, adc, 4);
+    failures += hostLinkReceive(&link, &frame, LOOPBACK_TIMEOUT_MS) != 1 ||
+                !sameFrame(&frame, MSG_BUTTON_EVENT, 2, (const uint8_t *)"\x01", 1);
+
+    // Host to device, byte by byte as the receive interrupt gets them
+    failures += hostLinkSend(&link, MSG_CONFIG_WRITE, config, sizeof(config)) != 0;
+    do
+    {
+        failures += read(device, &byte, 1) != 1;
+        protocolReceiveByte(byte);
+    } while (byte != 0);
+    failures += !protocolReceive(&frame) || !sameFrame(&frame, MSG_CONFIG_WRITE, 0, config, sizeof(config));
+
+    printf("pseudo terminal %s: %lu frames received by the host, %lu rejected, %s\n", ptsname(device),
+           link.framesReceived, link.framesRejected, failures ? "FAILED" : "ok");
+
+    hostLinkClose(&link);
+    close(device);
+
+    // The noise and the first frame are one rejected frame
+    return failures + (link.framesRejected != 1);
+}
+
+int main(void)
+{
+    uint8_t payload[PROTOCOL_MAX_PAYLOAD];
+    unsigned int failures = 0;
+    unsigned int i;
+
+    failures += checkCrc();
+
+    protocolStart();
+    failures += roundTrip("empty", 0, 0);
+    failures += roundTrip("zero", (const uint8_t *)"\0", 1);
+    failures += roundTrip("zeros at the ends", (const uint8_t *)"\0\x12\x34\0", 4);
+    failures += roundTrip("zeros in a row", (const uint8_t *)"\x01\0\0\0\x02", 5);
+    memset(payload, 0, sizeof(payload));
+    failures += roundTrip("all zeros, maximum", payload, sizeof(payload));
+    for (i = 0; i < sizeof(payload); i++)
+    {
+        payload[i] = (uint8_t)(0xA0 + i);
+    }
+    failures += roundTrip("no zero, maximum", payload, sizeof(payload));
+    for (i = 0; i < sizeof(payload); i++)
+    {
+        payload[i] = (uint8_t)(i % 3 == 0 ? 0 : i);
+    }
+    failures += roundTrip("every third zero", payload, sizeof(payload));
+    failures += protocolSend(MSG_ADC_FRAME, payload, PROTOCOL_MAX_PAYLOAD + 1) != -1;
+
+    failures += checkCorrupt();
+    failures += checkDropped();
+    failures += checkLoopback();
+
+    printf("%u failures\n", failures);
+
+    return failures ? 1 : 0;
+}
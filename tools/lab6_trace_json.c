@@ -0,0 +1,178 @@
+/**
+ * @file    lab6_trace_json.c
+ * @brief   Converts the Lab 6 trace dump into a Chrome trace.
+ *
+ * This program reads what the console command "trace" (traceDump()) prints, e.g. a log
+ * of the terminal, and writes the events in the Trace Event Format of Chrome, which
+ * chrome://tracing and https://ui.perfetto.dev show as a timeline. Lines that are no
+ * events, like the prompt or other output, are skipped; a further dump in the same
+ * input starts a new process in the timeline.
+ * - Interrupts are spans in the thread "interrupts" from isr-enter to isr-exit, named
+ *   after TRACE_ISR. An isr-exit without its isr-enter, as the ring was full, is dropped.
+ * - Tasks of the scheduler are spans in the thread "tasks" from task-start to task-end.
+ * - All other events are instants in the thread "events" with their argument.
+ * A time count of Timer0_A is COUNT_US microseconds, as SMCLK runs at 1 MHz.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -Wall -I"Embedded Lab 6/userCode/inc" -o lab6_trace_json tools/lab6_trace_json.c && ./lab6_trace_json < terminal.log > trace.json
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Trace.h"
+
+#define COUNT_US 1.0 // Microseconds per count of TA0R
+#define LINE_LENGTH 128
+#define NAME_LENGTH 16
+
+// Threads of the timeline
+typedef enum
+{
+    THREAD_INTERRUPTS = 1,
+    THREAD_TASKS,
+    THREAD_EVENTS
+} THREAD;
+
+// Names printed by traceDump(), in the order of TRACE_EVENT
+static const char *const eventNames[TRACE_EVENTS] = {
+    "boot", "isr-enter", "isr-exit", "task-start", "task-end", "lcd-cmd", "adc", "button",
+    "frame"
+};
+
+// Names of TRACE_ISR
+static const char *const isrNames[] = {"scheduler", "uart-rx", "uart-tx"};
+
+static unsigned int written = 0;       // Events written so far, for the commas
+static unsigned int dump = 0;          // Number of the dump, the process in the timeline
+static double now = 0.0;               // Time of the last event in us
+static uint8_t open[THREAD_EVENTS + 1]; // Spans begun and not ended per thread
+
+/**
+ * @brief Writes one event of the Trace Event Format.
+ */
+static void writeEvent(const char *name, char phase, THREAD thread, int arg)
+{
+    printf("%s\n    {\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %.1f, \"pid\": %u, \"tid\": %d", written ? "," : "",
+           name, phase, now, dump, thread);
+    if (phase == 'i')
+    {
+        printf(", \"s\": \"t\", \"args\": {\"arg\": %d}", arg);
+    }
+    printf("}");
+    written++;
+}
+
+/**
+ * @brief Writes the names of the process and threads of a dump.
+ */
+static void startDump(const char *title)
+{
+    const char *threadNames[] = {"", "interrupts", "tasks", "events"};
+    int i;
+
+    dump++;
+    now = 0.0;
+    memset(open, 0, sizeof(open));
+
+    printf("%s\n    {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %u, \"args\": {\"name\": \"%s\"}}",
+           written ? "," : "", dump, title);
+    written++;
+    for (i = THREAD_INTERRUPTS; i <= THREAD_EVENTS; i++)
+    {
+        printf(",\n    {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %u, \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+               dump, i, threadNames[i]);
+    }
+}
+
+/**
+ * @brief Writes a span event, dropping an end without its begin.
+ *
+ * @return 1 if the event has been dropped, 0 otherwise.
+ */
+static unsigned int writeSpan(const char *name, uint8_t begin, THREAD thread)
+{
+    if (begin)
+    {
+        open[thread]++;
+        writeEvent(name, 'B', thread, 0);
+        return 0;
+    }
+    if (open[thread] == 0)
+    {
+        return 1;
+    }
+    open[thread]--;
+    writeEvent(name, 'E', thread, 0);
+    return 0;
+}
+
+int main(void)
+{
+    char line[LINE_LENGTH];
+    char name[NAME_LENGTH];
+    char title[LINE_LENGTH];
+    char spanName[NAME_LENGTH];
+    unsigned int delta;
+    int arg;
+    unsigned int events = 0;
+    unsigned int dropped = 0;
+    unsigned int skipped = 0;
+    int event;
+
+    printf("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [");
+
+    while (fgets(line, sizeof(line), stdin))
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+
+        // The title of a dump starts with "Trace", the events with '+'
+        if (strncmp(line, "Trace", 5) == 0)
+        {
+            snprintf(title, sizeof(title), "%.*s", (int)strcspn(line, ",\""), line);
+            startDump(title);
+            continue;
+        }
+        if (dump == 0 || sscanf(line, "+%u %15s %d", &delta, name, &arg) != 3)
+        {
+            skipped += line[0] != '\0';
+            continue;
+        }
+
+        for (event = 0; event < TRACE_EVENTS && strcmp(name, eventNames[event]) != 0; event++)
+        {
+        }
+        now += delta * COUNT_US;
+        events++;
+
+        switch (event)
+        {
+        case TRACE_ISR_ENTER:
+        case TRACE_ISR_EXIT:
+            snprintf(spanName, sizeof(spanName), "%s",
+                     arg >= 0 && arg < (int)(sizeof(isrNames) / sizeof(isrNames[0])) ? isrNames[arg] : "isr");
+            dropped += writeSpan(spanName, event == TRACE_ISR_ENTER, THREAD_INTERRUPTS);
+            break;
+        case TRACE_TASK_START:
+        case TRACE_TASK_END:
+            snprintf(spanName, sizeof(spanName), "task %d", arg);
+            dropped += writeSpan(spanName, event == TRACE_TASK_START, THREAD_TASKS);
+            break;
+        default:
+            writeEvent(event < TRACE_EVENTS ? eventNames[event] : name, 'i', THREAD_EVENTS, arg);
+            break;
+        }
+    }
+
+    printf("\n]}\n");
+    fprintf(stderr, "%u dumps, %u events, %u ends without a begin dropped, %u other lines skipped\n", dump, events,
+            dropped, skipped);
+
+    return dump ? 0 : 1;
+}
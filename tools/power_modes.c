@@ -0,0 +1,209 @@
+/**
+ * @file    power_modes.c
+ * @brief   Host model of the time the labs spend in each power mode.
+ *
+ * This program runs Power.c (the copies in Labs 1, 3, 5 and 6 are the same) with the
+ * clock claims every lab makes, in its order, and counts the 1 us ticks of SIMULATION_MS
+ * in each mode. A lab wakes up at the periods of its interrupt sources and stays active
+ * for the estimated cycles of the service routine and the main loop at 1 MHz; then it
+ * calls powerIdle(), which picks the mode from the claims. The average current follows
+ * from the ticks and the typical currents of Power.h.
+ *
+ * Labs 1 and 3 run their timers and the button sampling on ACLK and reach LPM3; the UART
+ * needs no claim, the USCI turns SMCLK on by itself. Labs 5 and 6 count their 1 ms tick
+ * on SMCLK (the sound and the scheduler need its accuracy), so they sleep in LPM0. The
+ * program fails if a lab does not reach the mode it is expected to.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -Wall -Itools/host -I"Embedded Lab 1" -o power_modes tools/power_modes.c "Embedded Lab 1/Power.c" && ./power_modes
+ *
+ * @date    25.05.2024
+ * @author  Bjoern Metzger & Daniel Korobow
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define HOST_MSP430_REGISTERS
+#include <msp430.h>
+
+#include "Power.h"
+
+#define SIMULATION_MS 10000UL
+#define TICKS_PER_MS 1000UL // 1 us per tick, one cycle at 1 MHz
+#define VLO_HZ 12000UL      // Typical VLO, ACLK of all labs
+
+// Typical currents of Power.h in nA
+#define ACTIVE_NA 230000UL
+#define LPM0_NA 56000UL
+#define LPM3_NA 500UL
+#define LPM4_NA 100UL
+
+// Modes counted by the model
+typedef enum
+{
+    MODE_ACTIVE,
+    MODE_LPM0,
+    MODE_LPM3,
+    MODE_LPM4,
+    MODES
+} MODE;
+
+/**
+ * @brief What a lab does while it waits for an event.
+ */
+typedef struct {
+    const char *name;
+    void (*claim)(void);    // The powerRequire() calls of the lab
+    uint32_t periodUs[2];   // Periods of up to two wake-up sources, 0 if unused
+    uint16_t activeUs;      // Estimated CPU time per wake-up
+    MODE expected;          // Mode the lab has to sleep in
+} Scenario;
+
+static const char *const modeNames[MODES] = {"active", "LPM0", "LPM3", "LPM4"};
+static const uint32_t modeCurrents[MODES] = {ACTIVE_NA, LPM0_NA, LPM3_NA, LPM4_NA};
+
+static MODE mode = MODE_ACTIVE;
+
+// Claims of the labs, see the lines named in the comments
+static void claimLab1(void)
+{
+    powerRequire(POWER_ACLK); // main.c: Timer A0 on ACLK steps the LED pattern
+}
+
+static void claimLab3Waiting(void)
+{
+    powerRequire(POWER_ACLK); // initialize(): the buttons are sampled by the watchdog on ACLK
+}
+
+static void claimLab3Animation(void)
+{
+    powerRequire(POWER_ACLK); // initialize()
+    powerRequire(POWER_ACLK); // startTimer(): Timer A0 on ACLK times the animation
+}
+
+static void claimLab5(void)
+{
+    powerRequire(POWER_SMCLK); // initSysTick(): Timer0_A on SMCLK counts the 1 ms tick
+}
+
+static void claimLab6(void)
+{
+    powerRequire(POWER_SMCLK | POWER_ACLK); // runScheduler(): Timer A1 and the watchdog
+}
+
+static const Scenario scenarios[] = {
+    // The pattern steps alternate between 150 and 50 ms, 10 per second; ISR and status check
+    {"Lab 1 blink", claimLab1, {100000UL, 0}, 120, MODE_LPM3},
+    // Watchdog interval ACLK / 64 for the debouncing
+    {"Lab 3 waiting for a button", claimLab3Waiting, {64UL * 1000000UL / VLO_HZ, 0}, 60, MODE_LPM3},
+    // The animation timer every 10 ms besides the button sampling
+    {"Lab 3 animation", claimLab3Animation, {64UL * 1000000UL / VLO_HZ, 10000UL}, 60, MODE_LPM3},
+    // Tick with its handlers, the joystick transfer every 10 ms on average
+    {"Lab 5 waiting", claimLab5, {1000UL, 0}, 90, MODE_LPM0},
+    // Tick with the due tasks, the console every 20 ms and the display on average
+    {"Lab 6 scheduler", claimLab6, {1000UL, 0}, 150, MODE_LPM0}
+};
+
+/**
+ * @brief Records the mode powerIdle() enters.
+ *
+ * @param bits The status register bits.
+ */
+void hostEnterLowPower(uint16_t bits)
+{
+    switch (bits & ~GIE)
+    {
+    case LPM0_bits:
+        mode = MODE_LPM0;
+        break;
+    case LPM3_bits:
+        mode = MODE_LPM3;
+        break;
+    case LPM4_bits:
+        mode = MODE_LPM4;
+        break;
+    default:
+        mode = MODE_ACTIVE;
+        break;
+    }
+}
+
+/**
+ * @brief Runs a scenario and prints the ticks in each mode.
+ *
+ * @return 1 if the lab does not sleep in the expected mode, 0 otherwise.
+ */
+static unsigned int run(const Scenario *scenario)
+{
+    uint32_t ticks[MODES] = {0, 0, 0, 0};
+    uint32_t total = SIMULATION_MS * TICKS_PER_MS;
+    uint32_t nextWake[2] = {0, 0};
+    uint32_t activeLeft = 0;
+    uint64_t charge = 0;
+    uint8_t source;
+    MODE deepest = MODE_ACTIVE;
+    uint32_t tick;
+    int i;
+
+    initPower();
+    scenario->claim();
+    mode = MODE_ACTIVE;
+
+    for (tick = 0; tick < total; tick++)
+    {
+        // A wake-up while the CPU is still active is served after the current one
+        for (source = 0; source < 2; source++)
+        {
+            if (scenario->periodUs[source] && tick == nextWake[source])
+            {
+                mode = MODE_ACTIVE;
+                activeLeft += scenario->activeUs;
+                nextWake[source] += scenario->periodUs[source];
+            }
+        }
+
+        ticks[mode]++;
+
+        if (mode == MODE_ACTIVE && --activeLeft == 0)
+        {
+            powerIdle();
+            deepest = mode > deepest ? mode : deepest;
+        }
+    }
+
+    printf("%-27s", scenario->name);
+    for (i = 0; i < MODES; i++)
+    {
+        printf(" %9lu", (unsigned long)ticks[i]);
+        charge += (uint64_t)ticks[i] * modeCurrents[i];
+    }
+    printf("  %8.2f uA\n", charge / (double)total / 1000.0);
+
+    if (deepest != scenario->expected)
+    {
+        printf("  sleeps in %s, expected %s\n", modeNames[deepest], modeNames[scenario->expected]);
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    unsigned int failures = 0;
+    unsigned int i;
+
+    printf("Ticks of 1 us in %lu ms, average current without the LEDs\n", SIMULATION_MS);
+    printf("%-27s %9s %9s %9s %9s  %11s\n", "", modeNames[0], modeNames[1], modeNames[2], modeNames[3], "current");
+
+    for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+    {
+        failures += run(&scenarios[i]);
+    }
+
+    printf("%u failures\n", failures);
+
+    return failures ? 1 : 0;
+}